@@ -4,18 +4,49 @@
 
 inline void LoadAssets(
 	aZero::Engine& engine, 
-	aZero::Asset::Mesh& mesh,
+	std::vector<aZero::Asset::Mesh>& meshes,
 	aZero::Asset::Material& material,
 	aZero::Asset::Texture& albedo,
 	aZero::Asset::Texture& normalMap)
 {
-	mesh.LoadFromFile("Goblin.fbx");
-	engine.GetRenderer().UpdateRenderState(&mesh);
+	// Decode the textures while the mesh is imported, the GPU uploads stay on this thread
+	// The first load cooks the mips and BC7 blocks into the texture cache, later loads map the cooked files
+	aZero::Jobs::JobSystem& jobSystem = engine.GetJobSystem();
+	const std::string texturePath = engine.GetProjectDirectory() + TEXTURE_ASSET_RELATIVE_PATH;
+	aZero::Asset::TextureCookSettings albedoSettings;
+	albedoSettings.Format = DXGI_FORMAT::DXGI_FORMAT_BC7_UNORM_SRGB;
+	aZero::Asset::TextureCookSettings normalMapSettings;
+	normalMapSettings.Format = DXGI_FORMAT::DXGI_FORMAT_BC7_UNORM;
+	const aZero::Asset::TextureLoadRequest textureRequests[] = {
+		{ &albedo, texturePath + "goblinAlbedo.png", albedoSettings.Format, albedoSettings },
+		{ &normalMap, texturePath + "goblinNormal.png", normalMapSettings.Format, normalMapSettings }
+	};
+	aZero::Jobs::JobCounter textureCounter;
+	jobSystem.Run([&textureRequests]() { aZero::Asset::LoadTextures(textureRequests); }, &textureCounter);
+
+	// The texture job references the requests and textures, so it has to finish before an exception leaves this scope
+	std::exception_ptr exception;
+	try
+	{
+		// Every submesh of the file becomes its own mesh asset
+		meshes = aZero::Asset::LoadMeshesFromFile("Goblin.fbx", 0);
+		for (aZero::Asset::Mesh& mesh : meshes)
+		{
+			engine.GetRenderer().UpdateRenderState(&mesh);
+		}
+	}
+	catch (...)
+	{
+		exception = std::current_exception();
+	}
 
-	albedo.Load(engine.GetProjectDirectory() + TEXTURE_ASSET_RELATIVE_PATH + "goblinAlbedo.png", DXGI_FORMAT::DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
-	engine.GetRenderer().UpdateRenderState(&albedo);
+	jobSystem.Wait(textureCounter);
+	if (exception)
+	{
+		std::rethrow_exception(exception);
+	}
 
-	normalMap.Load(engine.GetProjectDirectory() + TEXTURE_ASSET_RELATIVE_PATH + "goblinNormal.png", DXGI_FORMAT::DXGI_FORMAT_R8G8B8A8_UNORM);
+	engine.GetRenderer().UpdateRenderState(&albedo);
 	engine.GetRenderer().UpdateRenderState(&normalMap);
 
 	material.SetAlbedoTexture(&albedo);
@@ -25,38 +56,42 @@ inline void LoadAssets(
 
 inline void CreateScene(
 	aZero::Scene::SceneNew& scene,
-	aZero::Asset::Mesh& mesh,
+	std::vector<aZero::Asset::Mesh>& meshes,
 	aZero::Asset::Material& material,
 	const DXM::Vector2& windowDimensions)
 {
 	aZero::ECS::ComponentManagerDecl& ecsManager = scene.m_ComponentManager;
 
-	// Create mesh
+	// Create mesh, one entity per submesh named MeshEntity0, MeshEntity1...
+	for (size_t meshIndex = 0; meshIndex < meshes.size(); meshIndex++)
 	{
 		aZero::ECS::Entity meshEntity = scene.AddEntity();
-		scene.RenameEntity(meshEntity, "MeshEntity");
+		scene.RenameEntity(meshEntity, "MeshEntity" + std::to_string(meshIndex));
 		ecsManager.AddComponent(meshEntity, aZero::ECS::TransformComponent());
 
-		ecsManager.AddComponent(meshEntity, aZero::ECS::StaticMeshComponent(&mesh, &material));
+		ecsManager.AddComponent(meshEntity, aZero::ECS::StaticMeshComponent(&meshes[meshIndex], &material));
 
 		ecsManager.GetComponent<aZero::ECS::TransformComponent>(meshEntity)
 			->SetTransform(DXM::Matrix::CreateRotationY(3.14) * DXM::Matrix::CreateTranslation(-10, -2, 4));
 
-		scene.MarkRenderStateDirty(meshEntity, aZero::Scene::SceneNew::ComponentFlag());
+		scene.MarkRenderStateDirty(meshEntity, aZero::Scene::SceneNew::ComponentFlag::All);
 	}
 
 	{
 		for (int i = 1; i < 4; i++)
 		{
-			aZero::ECS::Entity meshEntity = scene.AddEntity();
-			ecsManager.AddComponent(meshEntity, aZero::ECS::TransformComponent());
+			for (aZero::Asset::Mesh& mesh : meshes)
+			{
+				aZero::ECS::Entity meshEntity = scene.AddEntity();
+				ecsManager.AddComponent(meshEntity, aZero::ECS::TransformComponent());
 
-			ecsManager.AddComponent(meshEntity, aZero::ECS::StaticMeshComponent(&mesh, &material));
+				ecsManager.AddComponent(meshEntity, aZero::ECS::StaticMeshComponent(&mesh, &material));
 
-			ecsManager.GetComponent<aZero::ECS::TransformComponent>(meshEntity)
-				->SetTransform(DXM::Matrix::CreateRotationY(3.14) * DXM::Matrix::CreateTranslation(i * 3, -2, 4));
+				ecsManager.GetComponent<aZero::ECS::TransformComponent>(meshEntity)
+					->SetTransform(DXM::Matrix::CreateRotationY(3.14) * DXM::Matrix::CreateTranslation(i * 3, -2, 4));
 
-			scene.MarkRenderStateDirty(meshEntity, aZero::Scene::SceneNew::ComponentFlag());
+				scene.MarkRenderStateDirty(meshEntity, aZero::Scene::SceneNew::ComponentFlag::All);
+			}
 		}
 	}
 
@@ -78,7 +113,7 @@ inline void CreateScene(
 		ecsManager.AddComponent(cameraEntity, cameraComponent);
 		ecsManager.AddComponent(cameraEntity, aZero::ECS::TransformComponent());
 
-		scene.MarkRenderStateDirty(cameraEntity, aZero::Scene::SceneNew::ComponentFlag());
+		scene.MarkRenderStateDirty(cameraEntity, aZero::Scene::SceneNew::ComponentFlag::All);
 	}
 
 	{
@@ -95,6 +130,6 @@ inline void CreateScene(
 		ecsManager.AddComponent(cameraEntity, cameraComponent);
 		ecsManager.AddComponent(cameraEntity, aZero::ECS::TransformComponent());
 
-		scene.MarkRenderStateDirty(cameraEntity, aZero::Scene::SceneNew::ComponentFlag());
+		scene.MarkRenderStateDirty(cameraEntity, aZero::Scene::SceneNew::ComponentFlag::All);
 	}
 }
\ No newline at end of file
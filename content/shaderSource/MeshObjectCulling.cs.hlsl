@@ -6,6 +6,8 @@ struct MeshObjectCullingConstants
     uint NumMeshObjects;
     uint IndirectArgumentMeshCullingBuffer;
     uint PassedMeshesCounterBuffer;
+    uint VisibleInstanceBuffer;
+    uint VisibleInstanceOffset;
 };
 
 ConstantBuffer<BindingConstants> Bindings : register(b0);
@@ -17,8 +19,12 @@ void main(uint3 dtid : SV_DispatchThreadID)
 {
     if (PassConstants.NumMeshObjects > dtid.x)
     {
+        // Only the instances that passed the CPU culling of the camera are dispatched
+        const StructuredBuffer<uint> visibleInstances = ResourceDescriptorHeap[PassConstants.VisibleInstanceBuffer];
+        const uint instanceIndex = visibleInstances[PassConstants.VisibleInstanceOffset + dtid.x];
+        
         const StructuredBuffer<InstanceData> instances = ResourceDescriptorHeap[Bindings.InstanceBuffer];
-        const InstanceData instance = instances[dtid.x];
+        const InstanceData instance = instances[instanceIndex];
         
         min16uint meshIndex, materialIndex;
         UnpackBatchID(instance.BatchID, meshIndex, materialIndex);
@@ -39,7 +45,7 @@ void main(uint3 dtid : SV_DispatchThreadID)
             RWStructuredBuffer<uint> passedMeshesCounterBuffer = ResourceDescriptorHeap[PassConstants.PassedMeshesCounterBuffer];
             uint meshObjectIndex;
             InterlockedAdd(passedMeshesCounterBuffer[0], 1, meshObjectIndex);
-            instancesPassedBuffer[meshObjectIndex].InstanceID = dtid.x;
+            instancesPassedBuffer[meshObjectIndex].InstanceID = instanceIndex;
             instancesPassedBuffer[meshObjectIndex].GroupsX = ceil(mesh.MeshletCount / (float)THREADS_PER_X); // TODO: Check if OK to divide by 64
             instancesPassedBuffer[meshObjectIndex].GroupsY = 1;
             instancesPassedBuffer[meshObjectIndex].GroupsZ = 1;
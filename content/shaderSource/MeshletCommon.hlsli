@@ -12,6 +12,25 @@ struct GenericVertexData
     float3 Tangent;
 };
 
+// NOTE: Has to match Asset::VertexFormat
+#define VERTEX_FORMAT_FLOAT 0
+#define VERTEX_FORMAT_QUANTIZED 1
+
+// snorm16 xyz relative to Mesh::Bounds, the high half of ZW is padding
+struct QuantizedVertexPosition
+{
+    uint XY;
+    uint ZW;
+};
+
+// Half float UV and octahedral snorm16 normal and tangent, see VertexQuantization.hpp
+struct QuantizedVertexData
+{
+    uint UV;
+    uint Normal;
+    uint Tangent;
+};
+
 struct VertexOut
 {
     float4 Position : SV_Position;
@@ -32,9 +51,18 @@ struct Mesh
     uint IndicesBuffer;
     uint PositionBuffer;
     uint VertexDataBuffer;
+    uint VertexFormat;
     float4 Bounds;
 };
 
+struct MeshletLodBounds
+{
+    float3 Center;
+    float Radius;
+    float Error;
+};
+
+// NOTE: Has to match Asset::Meshlet
 struct Meshlet
 {
     uint VertCount;
@@ -42,6 +70,10 @@ struct Meshlet
     uint PrimCount;
     uint PrimOffset;
     BoundingSphere Bounds;
+    MeshletLodBounds Lod;
+    MeshletLodBounds ParentLod;
+    uint SourceGroup;
+    uint ParentGroup;
 };
 
 struct InstanceData
@@ -60,6 +92,76 @@ struct BindingConstants
     uint MeshletInstanceBuffer;
 };
 
+// Largest projected LOD error in units of half the screen height, about one pixel at 1080p
+static const float MeshletLodErrorThreshold = 2.f / 1080.f;
+
+float ProjectMeshletLodError(MeshletLodBounds bounds, float4x4 transform, CameraData camera)
+{
+    // Assumes uniformly scaled instances
+    const float scale = length(transform._11_21_31);
+    const float3 centerWP = mul(transform, float4(bounds.Center, 1.f)).xyz;
+    const float3 centerVS = mul(camera.View, float4(centerWP, 1.f)).xyz;
+    const float distance = max(length(centerVS) - bounds.Radius * scale, camera.BoundingFrustum.Near);
+    return bounds.Error * scale / distance * camera.Projection._22;
+}
+
+// Same rule as Asset::SelectMeshletLods(), every meshlet decides on its own and the selected set is still crack-free
+bool IsMeshletLodSelected(Meshlet meshlet, float4x4 transform, CameraData camera)
+{
+    return ProjectMeshletLodError(meshlet.Lod, transform, camera) <= MeshletLodErrorThreshold
+        && ProjectMeshletLodError(meshlet.ParentLod, transform, camera) > MeshletLodErrorThreshold;
+}
+
+float2 UnpackSnorm16x2(uint packed)
+{
+    const int2 values = int2(int(packed << 16) >> 16, int(packed) >> 16);
+    return max(float2(values) / 32767.f, -1.f);
+}
+
+float3 DecodeOctahedral(uint encoded)
+{
+    float3 direction = float3(UnpackSnorm16x2(encoded), 0.f);
+    direction.z = 1.f - abs(direction.x) - abs(direction.y);
+    
+    // Unfold the lower hemisphere, step() matches the >= 0 test of the CPU decode
+    const float fold = saturate(-direction.z);
+    direction.xy += fold * (1.f - 2.f * step(0.f, direction.xy));
+    return normalize(direction);
+}
+
+float3 DecodePosition(QuantizedVertexPosition position, float4 bounds)
+{
+    const float3 offset = float3(UnpackSnorm16x2(position.XY), UnpackSnorm16x2(position.ZW).x);
+    return bounds.xyz + offset * bounds.w;
+}
+
+GenericVertexData DecodeVertexData(QuantizedVertexData vertexData)
+{
+    GenericVertexData output;
+    output.UV = f16tof32(uint2(vertexData.UV, vertexData.UV >> 16));
+    output.Normal = DecodeOctahedral(vertexData.Normal);
+    output.Tangent = DecodeOctahedral(vertexData.Tangent);
+    return output;
+}
+
+void LoadVertex(Mesh mesh, uint vertexIndex, out float3 position, out GenericVertexData vertexData)
+{
+    if (mesh.VertexFormat == VERTEX_FORMAT_QUANTIZED)
+    {
+        const StructuredBuffer<QuantizedVertexPosition> positions = ResourceDescriptorHeap[mesh.PositionBuffer];
+        const StructuredBuffer<QuantizedVertexData> vertices = ResourceDescriptorHeap[mesh.VertexDataBuffer];
+        position = DecodePosition(positions[vertexIndex], mesh.Bounds);
+        vertexData = DecodeVertexData(vertices[vertexIndex]);
+    }
+    else
+    {
+        const StructuredBuffer<VertexPosition> positions = ResourceDescriptorHeap[mesh.PositionBuffer];
+        const StructuredBuffer<GenericVertexData> vertices = ResourceDescriptorHeap[mesh.VertexDataBuffer];
+        position = positions[vertexIndex].Position;
+        vertexData = vertices[vertexIndex];
+    }
+}
+
 void UnpackBatchID(uint BatchID, out min16uint MeshIndex, out min16uint MaterialIndex)
 {
     MeshIndex = (min16uint) (BatchID & 0xFFFF);
@@ -33,7 +33,7 @@ void main(uint3 dtid : SV_DispatchThreadID)
         const float3 boundsWP = mul(instance.Transform, float4(meshlet.Bounds.Position, 1.f)).xyz;
         const BoundingSphere bounds = CreateBoundingSphere(boundsWP, meshlet.Bounds.Radius);
         
-        if (camera.BoundingFrustum.Intersects(bounds, camera.View))
+        if (IsMeshletLodSelected(meshlet, instance.Transform, camera) && camera.BoundingFrustum.Intersects(bounds, camera.View))
         {
             RWStructuredBuffer<MeshShaderIndirectArgs> indirectArgumentsBuffer = ResourceDescriptorHeap[Bindings.IndirectArgumentMeshletCullingBuffer];
             RWStructuredBuffer<MeshletCulling_To_MeshShader_Data> meshletInstanceBuffer = ResourceDescriptorHeap[Bindings.MeshletInstanceBuffer];
@@ -19,16 +19,20 @@ uint GetVertexIndex(Meshlet meshlet, uint localIndex, StructuredBuffer<uint> ind
     return indices[localIndex];
 }
 
-VertexOut GetVertex(uint vertexIndex, float4x4 vpMatrix, StructuredBuffer<VertexPosition> positions, StructuredBuffer<GenericVertexData> genericVertexData, float4x4 transform, min16uint materialIndex)
+VertexOut GetVertex(uint vertexIndex, float4x4 vpMatrix, Mesh mesh, float4x4 transform, min16uint materialIndex)
 {
+    float3 localPosition;
+    GenericVertexData vertexData;
+    LoadVertex(mesh, vertexIndex, localPosition, vertexData);
+    
     VertexOut output;
-    float4 position = mul(transform, float4(positions[vertexIndex].Position, 1.f));
+    float4 position = mul(transform, float4(localPosition, 1.f));
     position = mul(vpMatrix, position);
     output.Position = position;
     
 #if !NORMAL_MAP
-    const float3 normal = mul(transform, float4(genericVertexData[vertexIndex].Normal, 0.f)).xyz;
-    float3 tangent = mul(transform, float4(genericVertexData[vertexIndex].Tangent, 0.f)).xyz;
+    const float3 normal = mul(transform, float4(vertexData.Normal, 0.f)).xyz;
+    float3 tangent = mul(transform, float4(vertexData.Tangent, 0.f)).xyz;
     
     // Re-ortogonalize the tangent since they might not be ortogonal anymore after transform and precision changes. 
     // n * dot(n, t) creates a vector which when you subtract from the tangent creates the new ortogonalized tangent. So its like the "error" vector.
@@ -43,7 +47,7 @@ VertexOut GetVertex(uint vertexIndex, float4x4 vpMatrix, StructuredBuffer<Vertex
     output.TBN = float3x3(tangent, biTangent, normal);
 #endif
     
-    output.UV = genericVertexData[vertexIndex].UV;
+    output.UV = vertexData.UV;
     output.MaterialID = materialIndex;
 
     return output;
@@ -84,8 +88,6 @@ void main(
     const StructuredBuffer<Meshlet> meshlets = ResourceDescriptorHeap[mesh.MeshletBuffer];
     const Meshlet meshlet = meshlets[meshletInfo.LocalMeshletIndex];
     
-    const StructuredBuffer<VertexPosition> vertexPositionBuffer = ResourceDescriptorHeap[mesh.PositionBuffer];
-    const StructuredBuffer<GenericVertexData> genericVertexDataBuffer = ResourceDescriptorHeap[mesh.VertexDataBuffer];
     const StructuredBuffer<uint> indicesBuffer = ResourceDescriptorHeap[mesh.IndicesBuffer];
     const StructuredBuffer<uint> primitiveBuffer = ResourceDescriptorHeap[mesh.PrimitiveBuffer];
    
@@ -103,7 +105,7 @@ void main(
     if (gtid < meshlet.VertCount)
     {
         uint vertexIndex = GetVertexIndex(meshlet, gtid, indicesBuffer);
-        verts[gtid] = GetVertex(vertexIndex, vpMatrix, vertexPositionBuffer, genericVertexDataBuffer, instance.Transform, materialIndex);
+        verts[gtid] = GetVertex(vertexIndex, vpMatrix, mesh, instance.Transform, materialIndex);
         
         // TODO: Make setting
         float3 meshletColor = HashColor(meshletInfo.LocalMeshletIndex);
@@ -2,6 +2,7 @@
 #include <memory>
 #include "renderer/Renderer.hpp"
 #include "scene/Scene.hpp"
+#include "misc/JobSystem.hpp"
 #include "aZeroAudio.hpp"
 
 namespace aZero
@@ -19,6 +20,7 @@ namespace aZero
 
 		Rendering::Renderer& GetRenderer() const { return *m_Renderer.get(); }
 		Audio::AudioEngine& GetAudioEngine() const { return *m_AudioEngine.get(); }
+		Jobs::JobSystem& GetJobSystem() const { return Jobs::GetJobSystem(); }
 
 		// TODO: Replace with a better file system/handling implementation (perhaps a project file or something reads the path)
 		const std::string& GetProjectDirectory() const { return m_ProjectDirectory; }
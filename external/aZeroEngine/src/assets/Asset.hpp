@@ -1,5 +1,8 @@
 #pragma once
-#include "graphics_api/D3D12Include.hpp"
+#include <cstdint>
+#include <limits>
+#include <string>
+#include "misc/MathInclude.hpp"
 #include "misc/NonCopyable.hpp"
 
 namespace aZero
@@ -1,101 +1,122 @@
 #include "Mesh.hpp"
+#include "MeshletCache.hpp"
+#include "MeshletLod.hpp"
+#include "VertexQuantization.hpp"
 #include "misc/EngineDebugMacros.hpp"
+#include "misc/Hash.hpp"
+#include "misc/MappedFile.hpp"
 #include "assimp/Importer.hpp"
 #include "assimp/scene.h"
 #include "assimp/postprocess.h"
 #include "meshoptimizer.h"
 #include "misc/HelperFunctions.hpp"
+#include "misc/JobSystem.hpp"
+#include "misc/Profiler.hpp"
+#include <atomic>
+#include <numeric>
 
-aZero::Asset::MeshletMeshData GenerateMeshletData(
-	const std::string& name, 
-	const std::vector<aZero::Asset::VertexPosition>& positions, 
-	const std::vector<aZero::Asset::GenericVertexData>& genericVertexData, 
-	std::vector<aZero::Asset::VertexIndex>& meshIndices,
-	const DirectX::BoundingSphere& bounds
+// Per-thread buffers that are reused between meshes so the import doesn't reallocate for every mesh
+struct MeshletBuildScratch
+{
+	std::vector<aZero::Asset::VertexPosition> Positions;
+	std::vector<aZero::Asset::GenericVertexData> GenericVertexData;
+	std::vector<aZero::Asset::VertexIndex> Indices;
+	std::vector<unsigned int> Remap;
+	std::vector<meshopt_Meshlet> Meshlets;
+	std::vector<aZero::Asset::VertexIndex> MeshletIndices;
+	std::vector<uint8_t> Primitives;
+};
+
+// Optimizes the mesh stored in the scratch buffers and writes the meshlet data directly into the output
+void GenerateMeshletData(
+	MeshletBuildScratch& scratch,
+	const DirectX::BoundingSphere& bounds,
+	const aZero::Asset::MeshletBuildSettings& settings,
+	aZero::Asset::MeshletMeshData& output
 )
 {
-	const size_t max_vertices = 64;
-	const size_t max_triangles = 126;
+	PROFILE_SCOPE("Asset::GenerateMeshletData");
+
+	const size_t max_vertices = settings.MaxVertices;
+	const size_t max_triangles = settings.MaxTriangles;
+
+	std::vector<aZero::Asset::VertexIndex>& meshIndices = scratch.Indices;
+	const std::vector<aZero::Asset::VertexPosition>& positions = scratch.Positions;
 
-	const size_t max_meshlets = meshopt_buildMeshletsBound(
-		positions.size(), max_vertices, max_triangles);
+	const size_t max_meshlets = meshopt_buildMeshletsBound(meshIndices.size(), max_vertices, max_triangles);
 
-	// TODO: Take a look if there's any unneccessary ops
 	meshopt_optimizeVertexCache(meshIndices.data(), meshIndices.data(), meshIndices.size(), positions.size());
 	meshopt_optimizeOverdraw(meshIndices.data(), meshIndices.data(), meshIndices.size(), &positions[0].x, positions.size(), sizeof(aZero::Asset::VertexPosition), 1.05f);
-	
-	std::vector<unsigned int> remap(positions.size());
 
-	meshopt_optimizeVertexFetchRemap(
-		remap.data(),
+	scratch.Remap.resize(positions.size());
+	const size_t uniqueVertexCount = meshopt_optimizeVertexFetchRemap(
+		scratch.Remap.data(),
 		meshIndices.data(),
 		meshIndices.size(),
 		positions.size()
 	);
 
-	std::vector<aZero::Asset::VertexPosition> newPositions(positions.size());
-	meshopt_remapVertexBuffer(newPositions.data(), positions.data(), positions.size(), sizeof(aZero::Asset::VertexPosition), remap.data());
+	// Unreferenced vertices are dropped by the remap
+	output.Positions.resize(uniqueVertexCount);
+	meshopt_remapVertexBuffer(output.Positions.data(), positions.data(), positions.size(), sizeof(aZero::Asset::VertexPosition), scratch.Remap.data());
 
-	std::vector<aZero::Asset::GenericVertexData> newGeneric(genericVertexData.size());
-	meshopt_remapVertexBuffer(newGeneric.data(), genericVertexData.data(), genericVertexData.size(), sizeof(aZero::Asset::GenericVertexData), remap.data());
+	output.GenericVertexData.resize(uniqueVertexCount);
+	meshopt_remapVertexBuffer(output.GenericVertexData.data(), scratch.GenericVertexData.data(), scratch.GenericVertexData.size(), sizeof(aZero::Asset::GenericVertexData), scratch.Remap.data());
 
+	meshopt_remapIndexBuffer(meshIndices.data(), meshIndices.data(), meshIndices.size(), scratch.Remap.data());
 
-	meshopt_remapIndexBuffer(meshIndices.data(), meshIndices.data(), meshIndices.size(), remap.data());
+	scratch.Meshlets.resize(max_meshlets);
+	scratch.MeshletIndices.resize(max_meshlets * max_vertices);
+	scratch.Primitives.resize(max_meshlets * max_triangles * 3);
+	const size_t meshlet_count = meshopt_buildMeshlets(scratch.Meshlets.data(), scratch.MeshletIndices.data(), scratch.Primitives.data(), meshIndices.data(), meshIndices.size(), &output.Positions[0].x, output.Positions.size(), sizeof(aZero::Asset::VertexPosition), max_vertices, max_triangles, 0.f);
 
-	std::vector<meshopt_Meshlet> tempMeshlets;
-	std::vector<aZero::Asset::VertexIndex> local_indices;
-	std::vector<uint8_t> primitives;
-	tempMeshlets.resize(max_meshlets);
-	local_indices.resize(max_meshlets * max_vertices);
-	primitives.resize(max_meshlets * max_triangles * 3);
-	size_t meshlet_count = meshopt_buildMeshlets(tempMeshlets.data(), local_indices.data(), primitives.data(), meshIndices.data(), meshIndices.size(), &newPositions[0].x, newPositions.size(), sizeof(aZero::Asset::VertexPosition), max_vertices, max_triangles, 0.f);
+	const meshopt_Meshlet& last = scratch.Meshlets[meshlet_count - 1];
+	const size_t numMeshletIndices = last.vertex_offset + last.vertex_count;
+	const size_t numPrimitiveIndices = last.triangle_offset + last.triangle_count * 3;
 
-	const meshopt_Meshlet& last = tempMeshlets[meshlet_count - 1];
-
-	local_indices.resize(last.vertex_offset + last.vertex_count);
-	primitives.resize(last.triangle_offset + last.triangle_count * 3);
-	tempMeshlets.resize(meshlet_count);
-
-	std::vector<aZero::Asset::Meshlet> finalMeshlets;
-	finalMeshlets.reserve(tempMeshlets.size());
-	for (const meshopt_Meshlet& meshlet : tempMeshlets)
+	output.Meshlets.clear();
+	output.Meshlets.reserve(meshlet_count);
+	for (size_t meshletIndex = 0; meshletIndex < meshlet_count; meshletIndex++)
 	{
-		meshopt_optimizeMeshlet(&local_indices[meshlet.vertex_offset], &primitives[meshlet.triangle_offset], meshlet.triangle_count, meshlet.vertex_count);
-		meshopt_Bounds bounds = meshopt_computeMeshletBounds(&local_indices[meshlet.vertex_offset], &primitives[meshlet.triangle_offset],
-			meshlet.triangle_count, &newPositions[0].x, newPositions.size(), sizeof(aZero::Asset::VertexPosition));
+		const meshopt_Meshlet& meshlet = scratch.Meshlets[meshletIndex];
+		meshopt_optimizeMeshlet(&scratch.MeshletIndices[meshlet.vertex_offset], &scratch.Primitives[meshlet.triangle_offset], meshlet.triangle_count, meshlet.vertex_count);
+		meshopt_Bounds meshletBounds = meshopt_computeMeshletBounds(&scratch.MeshletIndices[meshlet.vertex_offset], &scratch.Primitives[meshlet.triangle_offset],
+			meshlet.triangle_count, &output.Positions[0].x, output.Positions.size(), sizeof(aZero::Asset::VertexPosition));
 
 		// Divide meshlet.triangle_offset with 3 since we pack the primitive indices in a 32bit uint
-		finalMeshlets.emplace_back(meshlet.vertex_count, meshlet.vertex_offset, meshlet.triangle_count, meshlet.triangle_offset / 3, DirectX::BoundingSphere(DXM::Vector3(bounds.center[0], bounds.center[1], bounds.center[2]), bounds.radius));
+		output.Meshlets.emplace_back(meshlet.vertex_count, meshlet.vertex_offset, meshlet.triangle_count, meshlet.triangle_offset / 3, DirectX::BoundingSphere(DXM::Vector3(meshletBounds.center[0], meshletBounds.center[1], meshletBounds.center[2]), meshletBounds.radius));
 	}
 
-	std::vector<uint32_t> newPrims;
-	newPrims.reserve(primitives.size() + primitives.size() / 3);
-	for (int i = 0; i < primitives.size(); i += 3)
+	output.MeshletIndices.assign(scratch.MeshletIndices.begin(), scratch.MeshletIndices.begin() + numMeshletIndices);
+
+	output.MeshletPrimitives.resize(numPrimitiveIndices / 3);
+	for (size_t i = 0; i < output.MeshletPrimitives.size(); i++)
 	{
-		newPrims.emplace_back(aZero::Helper::Pack8To32(primitives[i], primitives[i + 1], primitives[i + 2], 0));
+		output.MeshletPrimitives[i] = aZero::Helper::Pack8To32(scratch.Primitives[i * 3], scratch.Primitives[i * 3 + 1], scratch.Primitives[i * 3 + 2], 0);
 	}
 
-	std::vector<uint8_t> newPrimsa;
-	newPrimsa.reserve(primitives.size() + primitives.size() / 3);
+	output.Bounds = bounds;
 
-	for (int i = 0; i < primitives.size(); i++)
+	output.MeshletGroups.clear();
+	output.MeshletGroupChildren.clear();
+	if (settings.GenerateLods)
 	{
-		newPrimsa.emplace_back(primitives[i]);
-		if ((i + 1) % 3 == 0)
+		aZero::Asset::BuildMeshletLods(output, settings);
+	}
+	else
+	{
+		// Every meshlet is a root so the LOD selection always picks the full detail meshlets
+		for (aZero::Asset::Meshlet& meshlet : output.Meshlets)
 		{
-			newPrimsa.emplace_back(0);
+			meshlet.Lod = { DXM::Vector3(meshlet.Bounds.Center), meshlet.Bounds.Radius, 0.f };
 		}
 	}
 
-	return {
-		.Name = name,
-		.Meshlets = std::move(finalMeshlets),
-		.MeshletIndices = std::move(local_indices),
-		.MeshletPrimitives = std::move(newPrims),
-		.Positions = std::move(newPositions),
-		.GenericVertexData = std::move(newGeneric),
-		.Bounds = bounds
-	};
+	// Last since the meshlet and LOD generation work on the float positions
+	if (settings.VertexFormat == aZero::Asset::VertexFormat::Quantized)
+	{
+		aZero::Asset::VertexQuantization::QuantizeVertices(output);
+	}
 }
 
 DirectX::BoundingSphere ComputeBoundingSphere(const std::vector<aZero::Asset::VertexPosition>& points)
@@ -152,8 +173,100 @@ DirectX::BoundingSphere ComputeBoundingSphere(const std::vector<aZero::Asset::Ve
 	return { DXM::Vector3(center.x, center.y, center.z), radius};
 }
 
-std::vector<aZero::Asset::MeshletMeshData> LoadFBX(const std::string& path)
+// Converts the assimp mesh into the scratch buffers
+void ConvertMesh(const aiMesh* const mesh, MeshletBuildScratch& scratch)
+{
+	scratch.Positions.resize(mesh->mNumVertices);
+	scratch.GenericVertexData.resize(mesh->mNumVertices);
+
+	const bool hasTextureCoords = mesh->HasTextureCoords(0);
+	const bool hasNormals = mesh->HasNormals();
+	const bool hasTangents = mesh->HasTangentsAndBitangents();
+
+	for (uint32_t i = 0; i < mesh->mNumVertices; i++)
+	{
+		const aiVector3D& position = mesh->mVertices[i];
+		scratch.Positions[i] = aZero::Asset::VertexPosition(position.x, position.y, position.z);
+
+		aZero::Asset::GenericVertexData& vertexData = scratch.GenericVertexData[i];
+		vertexData = aZero::Asset::GenericVertexData();
+
+		if (hasTextureCoords)
+		{
+			const aiVector3D& uv = mesh->mTextureCoords[0][i];
+			vertexData.UV = { uv.x, uv.y };
+		}
+
+		if (hasNormals)
+		{
+			aiVector3D normal = mesh->mNormals[i];
+			normal.Normalize();
+			vertexData.Normal = { normal.x, normal.y, normal.z };
+		}
+
+		if (hasTangents)
+		{
+			aiVector3D tangent = mesh->mTangents[i];
+			tangent.Normalize();
+			vertexData.Tangent = { tangent.x, tangent.y, tangent.z };
+		}
+	}
+
+	// aiProcess_Triangulate guarantees three indices per face
+	scratch.Indices.resize(static_cast<size_t>(mesh->mNumFaces) * 3);
+	for (uint32_t i = 0; i < mesh->mNumFaces; i++)
+	{
+		const aiFace& face = mesh->mFaces[i];
+		scratch.Indices[i * 3] = face.mIndices[0];
+		scratch.Indices[i * 3 + 1] = face.mIndices[1];
+		scratch.Indices[i * 3 + 2] = face.mIndices[2];
+	}
+}
+
+// Runs callable(index, workerIndex) for every index in [0, count) on up to numThreads jobs of the engine job system.
+// The calling thread participates as worker 0 and helps with other jobs while waiting, so numThreads == 1 runs everything serially.
+// Unlike JobSystem::ParallelFor() the indices are handed out one at a time in order, which keeps a caller's largest-first ordering intact.
+template<typename Callable>
+void ParallelForEachIndex(uint32_t count, uint32_t numThreads, Callable&& callable)
+{
+	std::atomic<uint32_t> nextIndex = 0;
+	auto worker = [&](uint32_t workerIndex)
+		{
+			for (uint32_t index = nextIndex++; index < count; index = nextIndex++)
+			{
+				callable(index, workerIndex);
+			}
+		};
+
+	aZero::Jobs::JobSystem& jobSystem = aZero::Jobs::GetJobSystem();
+	aZero::Jobs::JobCounter counter;
+	for (uint32_t workerIndex = 1; workerIndex < numThreads; workerIndex++)
+	{
+		jobSystem.Run([&worker, workerIndex]() { worker(workerIndex); }, &counter);
+	}
+
+	// The queued jobs reference the locals above, so they have to finish before an exception leaves this scope
+	std::exception_ptr exception;
+	try
+	{
+		worker(0);
+	}
+	catch (...)
+	{
+		exception = std::current_exception();
+		nextIndex = count;
+	}
+
+	jobSystem.Wait(counter);
+	if (exception)
+	{
+		std::rethrow_exception(exception);
+	}
+}
+
+std::vector<aZero::Asset::MeshletMeshData> LoadFBX(const std::string& path, const aZero::Asset::MeshletBuildSettings& settings)
 {
+	PROFILE_SCOPE("LoadFBX");
 	Assimp::Importer importer;
 	const aiScene* const scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
 
@@ -164,88 +277,134 @@ std::vector<aZero::Asset::MeshletMeshData> LoadFBX(const std::string& path)
 		return output;
 	}
 
-	if (scene->mNumMeshes > 0)
+	const uint32_t numMeshes = scene->mNumMeshes;
+	if (numMeshes == 0)
 	{
-		output.reserve(scene->mNumMeshes);
+		return output;
+	}
 
-		for (uint32_t meshIndex = 0; meshIndex < scene->mNumMeshes; meshIndex++)
-		{
-			const aiMesh* const mesh = scene->mMeshes[meshIndex];
+	// Every mesh owns its output slot, so the workers never touch shared state
+	output.resize(numMeshes);
 
-			std::vector<aZero::Asset::VertexPosition> positions;
-			std::vector<aZero::Asset::GenericVertexData> genericVertexData;
-			std::vector<aZero::Asset::VertexIndex> indices;
+	// Process the largest meshes first so a big mesh picked up last doesn't leave the other workers idle
+	std::vector<uint32_t> order(numMeshes);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [scene](uint32_t a, uint32_t b) { return scene->mMeshes[a]->mNumFaces > scene->mMeshes[b]->mNumFaces; });
 
-			positions.reserve(mesh->mNumVertices);
-			genericVertexData.reserve(mesh->mNumVertices);
+	const uint32_t requestedThreads = settings.NumImportThreads > 0 ? settings.NumImportThreads : aZero::Jobs::GetJobSystem().GetNumWorkers();
+	const uint32_t numThreads = std::min(requestedThreads, numMeshes);
+	std::vector<MeshletBuildScratch> scratchBuffers(numThreads);
 
-			for (int i = 0; i < mesh->mNumVertices; i++)
+	ParallelForEachIndex(numMeshes, numThreads, [&](uint32_t orderIndex, uint32_t workerIndex)
+		{
+			const uint32_t meshIndex = order[orderIndex];
+			const aiMesh* const mesh = scene->mMeshes[meshIndex];
+			aZero::Asset::MeshletMeshData& meshData = output[meshIndex];
+			meshData.Name = mesh->mName.C_Str();
+
+			if (mesh->mNumVertices == 0 || mesh->mNumFaces == 0)
 			{
-				aiVector3D tempData = mesh->mVertices[i];
-				positions.emplace_back(tempData.x, tempData.y, tempData.z);
-				genericVertexData.emplace_back();
-
-				if (mesh->HasTextureCoords(0))
-				{
-					tempData = mesh->mTextureCoords[0][i];
-					genericVertexData[genericVertexData.size() - 1].UV = { tempData.x, tempData.y };
-				}
-
-				if (mesh->HasNormals())
-				{
-					tempData = mesh->mNormals[i];
-					tempData.Normalize();
-					genericVertexData[genericVertexData.size() - 1].Normal = { tempData.x, tempData.y, tempData.z };
-				}
-
-				if (mesh->HasTangentsAndBitangents())
-				{
-					tempData = mesh->mTangents[i];
-					tempData.Normalize();
-					genericVertexData[genericVertexData.size() - 1].Tangent = { tempData.x, tempData.y, tempData.z };
-				}
+				return;
 			}
 
-			indices.reserve(mesh->mNumFaces * 3);
-			for (unsigned int i = 0; i < mesh->mNumFaces; i++)
-			{
-				const aiFace& face = mesh->mFaces[i];
+			MeshletBuildScratch& scratch = scratchBuffers[workerIndex];
+			ConvertMesh(mesh, scratch);
+			GenerateMeshletData(scratch, ComputeBoundingSphere(scratch.Positions), settings, meshData);
+		});
 
-				indices.emplace_back(face.mIndices[0]);
-				indices.emplace_back(face.mIndices[1]);
-				indices.emplace_back(face.mIndices[2]);
-			}
+	// Drop meshes without geometry (ex. point or line meshes) while keeping the file order of the rest
+	std::erase_if(output, [](const aZero::Asset::MeshletMeshData& meshData) { return meshData.Meshlets.empty(); });
 
-			output.emplace_back(GenerateMeshletData(mesh->mName.C_Str(), positions, genericVertexData, indices, ComputeBoundingSphere(positions)));
-		}
-	}
 	return output;
 }
 
-std::vector<aZero::Asset::MeshletMeshData> aZero::Asset::LoadFromFile(const std::string& filename)
+std::vector<aZero::Asset::MeshletMeshData> aZero::Asset::LoadFromFile(const std::string& filename, const MeshletBuildSettings& settings)
 {
+	PROFILE_SCOPE("Asset::LoadFromFile");
 	const std::string absolutePath = PROJECT_DIRECTORY + std::string("assets/meshes/") + filename;
 
 	const size_t lastDot = absolutePath.find_last_of('.');
 	const std::string suffix = absolutePath.substr(lastDot + 1, absolutePath.length() - (absolutePath.length() - lastDot));
+
+	// The source hash keys the cooked file so any edit to the source invalidates it
+	std::optional<uint64_t> sourceHash;
+	std::string cachePath;
+	if (settings.UseCache)
+	{
+		Helper::MappedFile sourceFile;
+		if (sourceFile.Open(absolutePath))
+		{
+			sourceHash = Helper::HashBytes(sourceFile.GetData(), sourceFile.GetSize());
+			cachePath = MeshletCache::GetCachePath(filename, settings);
+			if (auto cachedMeshes = MeshletCache::Load(cachePath, sourceHash.value(), settings))
+			{
+				return std::move(cachedMeshes.value());
+			}
+		}
+	}
+
+	std::vector<aZero::Asset::MeshletMeshData> meshes;
 	if (suffix == "fbx")
 	{
-		return LoadFBX(absolutePath);
+		meshes = LoadFBX(absolutePath, settings);
 	}
 
 	// Add other formats here...
 
-	return std::vector<aZero::Asset::MeshletMeshData>();
+	if (sourceHash.has_value() && !meshes.empty())
+	{
+		MeshletCache::Save(cachePath, sourceHash.value(), settings, meshes);
+	}
+
+	return meshes;
 }
 
-bool aZero::Asset::Mesh::LoadFromFile(const std::string& filename)
+aZero::Asset::MeshletMeshData aZero::Asset::GenerateMeshletMeshData(
+	const std::vector<VertexPosition>& positions,
+	const std::vector<GenericVertexData>& vertexData,
+	const std::vector<VertexIndex>& indices,
+	const MeshletBuildSettings& settings)
 {
-	const auto& meshes = Asset::LoadFromFile(filename);
-	if (meshes.size())
+	if (positions.size() != vertexData.size() || indices.size() % 3 != 0)
 	{
+		throw std::runtime_error("Asset::GenerateMeshletMeshData() => Mismatching vertex data or incomplete triangles");
+	}
+
+	MeshletMeshData output;
+	if (indices.empty())
+	{
+		return output;
+	}
+
+	MeshletBuildScratch scratch;
+	scratch.Positions = positions;
+	scratch.GenericVertexData = vertexData;
+	scratch.Indices = indices;
+	GenerateMeshletData(scratch, ComputeBoundingSphere(scratch.Positions), settings, output);
+	return output;
+}
 
-		m_VertexData = meshes[0];
+bool aZero::Asset::Mesh::LoadFromFile(const std::string& filename, const MeshletBuildSettings& settings)
+{
+	auto meshes = Asset::LoadFromFile(filename, settings);
+	if (meshes.size())
+	{
+		m_VertexData = std::move(meshes[0]);
 	}
 
 	return !meshes.empty();
+}
+
+std::vector<aZero::Asset::Mesh> aZero::Asset::LoadMeshesFromFile(const std::string& filename, AssetID firstAssetID, const MeshletBuildSettings& settings)
+{
+	auto meshData = Asset::LoadFromFile(filename, settings);
+
+	std::vector<Mesh> meshes;
+	meshes.reserve(meshData.size());
+	for (size_t i = 0; i < meshData.size(); i++)
+	{
+		meshes.emplace_back(firstAssetID + static_cast<AssetID>(i), std::move(meshData[i]));
+	}
+
+	return meshes;
 }
\ No newline at end of file
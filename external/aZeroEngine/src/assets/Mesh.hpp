@@ -13,6 +13,17 @@ namespace aZero
 	{
 		using VertexIndex = uint32_t;
 
+		constexpr uint32_t InvalidMeshletGroup = std::numeric_limits<uint32_t>::max();
+
+		// Sphere and simplification error (in mesh units) that a LOD is selected with, see MeshletLod.hpp
+		struct MeshletLodBounds
+		{
+			DXM::Vector3 Center;
+			float Radius = 0.f;
+			float Error = 0.f;
+		};
+
+		// NOTE: Uploaded as is, has to match Meshlet in MeshletCommon.hlsli
 		struct Meshlet
 		{
 			uint32_t VerticesCount;
@@ -20,6 +31,34 @@ namespace aZero
 			uint32_t PrimitivesCount;
 			uint32_t PrimitiveOffset;
 			DirectX::BoundingSphere Bounds;
+
+			// Error of the group this meshlet was simplified from, zero for the full detail meshlets
+			MeshletLodBounds Lod;
+
+			// Error of the group this meshlet was simplified into, infinite if it's a root of the hierarchy
+			MeshletLodBounds ParentLod = { DXM::Vector3(), 0.f, std::numeric_limits<float>::max() };
+
+			// Index into MeshletMeshData::MeshletGroups of the group that produced this meshlet and of the group it was merged into
+			uint32_t SourceGroup = InvalidMeshletGroup;
+			uint32_t ParentGroup = InvalidMeshletGroup;
+		};
+
+		/** @brief A set of neighbouring meshlets of one LOD level that was merged and simplified into the coarser meshlets of the next level.
+		* The children are the finer meshlets that were merged and the parents are the coarser meshlets that replace them.
+		*/
+		struct MeshletGroup
+		{
+			// Range in MeshletMeshData::MeshletGroupChildren
+			uint32_t FirstChild;
+			uint32_t NumChildren;
+
+			// Range in MeshletMeshData::Meshlets
+			uint32_t FirstParent;
+			uint32_t NumParents;
+
+			// LOD level of the parents, the full detail meshlets are level 0
+			uint32_t Level;
+			MeshletLodBounds Lod;
 		};
 
 		using VertexPosition = DXM::Vector3;
@@ -31,6 +70,36 @@ namespace aZero
 			DXM::Vector3 Tangent;
 		};
 
+		enum class VertexFormat : uint32_t
+		{
+			// VertexPosition and GenericVertexData, 44 bytes per vertex
+			Float,
+
+			// QuantizedVertexPosition and QuantizedVertexData, 20 bytes per vertex. See VertexQuantization.hpp
+			Quantized
+		};
+
+		// NOTE: Uploaded as is, has to match QuantizedVertexPosition in MeshletCommon.hlsli
+		struct QuantizedVertexPosition
+		{
+			// snorm16 offset from the center of MeshletMeshData::Bounds in units of its radius
+			int16_t X;
+			int16_t Y;
+			int16_t Z;
+			int16_t Padding;
+		};
+
+		// NOTE: Uploaded as is, has to match QuantizedVertexData in MeshletCommon.hlsli
+		struct QuantizedVertexData
+		{
+			// Two half floats
+			uint32_t UV;
+
+			// Octahedral encoded directions, two snorm16
+			uint32_t Normal;
+			uint32_t Tangent;
+		};
+
 		struct MeshletMeshData
 		{
 			std::string Name;
@@ -38,11 +107,56 @@ namespace aZero
 			std::vector<VertexIndex> MeshletIndices;
 			std::vector<uint32_t> MeshletPrimitives;
 			std::vector<VertexPosition> Positions;
-			std::vector<GenericVertexData> GenericVertexData;
+			std::vector<Asset::GenericVertexData> GenericVertexData;
 			DirectX::BoundingSphere Bounds;
+
+			// Only the streams of the format are filled, the quantized positions are relative to Bounds
+			Asset::VertexFormat VertexFormat = Asset::VertexFormat::Float;
+			std::vector<QuantizedVertexPosition> QuantizedPositions;
+			std::vector<Asset::QuantizedVertexData> QuantizedVertexData;
+
+			// Cluster LOD hierarchy, empty if it wasn't generated. Meshlets holds every level, starting with the full detail meshlets.
+			std::vector<MeshletGroup> MeshletGroups;
+			std::vector<uint32_t> MeshletGroupChildren;
 		};
 
-		std::vector<MeshletMeshData> LoadFromFile(const std::string& filename);
+		/** @brief Parameters used when building the meshlets of a mesh.
+		* NOTE: MaxVertices and MaxTriangles can't exceed the output limits declared in MeshletDraw.ms.hlsl
+		*/
+		struct MeshletBuildSettings
+		{
+			uint32_t MaxVertices = 64;
+			uint32_t MaxTriangles = 126;
+
+			// If true the cooked meshlet data is read from/written to the mesh cache directory
+			bool UseCache = true;
+
+			// If true the meshlets are simplified into a cluster LOD hierarchy, see MeshletLod.hpp
+			bool GenerateLods = true;
+
+			// Format of the vertex streams that are kept and uploaded
+			Asset::VertexFormat VertexFormat = Asset::VertexFormat::Float;
+
+			// Number of jobs that convert and build the meshlets of the submeshes in parallel. 0 uses one per job system worker.
+			// NOTE: Doesn't affect the output so it isn't part of the cache key
+			uint32_t NumImportThreads = 0;
+		};
+
+		std::vector<MeshletMeshData> LoadFromFile(const std::string& filename, const MeshletBuildSettings& settings = MeshletBuildSettings());
+
+		/** Builds the meshlets (and LOD hierarchy if enabled) of an indexed triangle list that didn't come from a file, ex. procedural geometry.
+		* The cache is never used since there's no source file to key it with.
+		@param positions
+		@param vertexData One entry per position
+		@param indices Three per triangle
+		@param settings
+		@return MeshletMeshData
+		*/
+		MeshletMeshData GenerateMeshletMeshData(
+			const std::vector<VertexPosition>& positions,
+			const std::vector<GenericVertexData>& vertexData,
+			const std::vector<VertexIndex>& indices,
+			const MeshletBuildSettings& settings = MeshletBuildSettings());
 
 		class Mesh : public AssetBase
 		{
@@ -52,11 +166,28 @@ namespace aZero
 			Mesh(AssetID id)
 				:AssetBase(id) { }
 
+			Mesh(AssetID id, MeshletMeshData&& vertexData)
+				:AssetBase(id), m_VertexData(std::move(vertexData)) { }
+
 			const MeshletMeshData& GetVertexData() const { return m_VertexData; }
 
-			bool LoadFromFile(const std::string& filename);
+			/** Loads the first submesh of the file, LoadMeshesFromFile() keeps every submesh.
+			@param filename Filename relative to the mesh asset directory
+			@param settings
+			@return bool False if the file has no submesh with triangles
+			*/
+			bool LoadFromFile(const std::string& filename, const MeshletBuildSettings& settings = MeshletBuildSettings());
 		private:
 			MeshletMeshData m_VertexData;
 		};
+
+		/** Loads every submesh in the file as a separate Mesh.
+		* AssetIDs are assigned sequentially starting at firstAssetID.
+		@param filename Filename relative to the mesh asset directory
+		@param firstAssetID
+		@param settings
+		@return std::vector<Mesh>
+		*/
+		std::vector<Mesh> LoadMeshesFromFile(const std::string& filename, AssetID firstAssetID, const MeshletBuildSettings& settings = MeshletBuildSettings());
 	}
 }
\ No newline at end of file
@@ -0,0 +1,252 @@
+#include "MeshletCache.hpp"
+#include <filesystem>
+#include <fstream>
+#include "misc/EngineDebugMacros.hpp"
+#include "misc/Hash.hpp"
+#include "misc/MappedFile.hpp"
+#include "misc/Profiler.hpp"
+#include "misc/RelativePathMacros.hpp"
+
+namespace
+{
+	constexpr uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	class SectionReader
+	{
+	public:
+		SectionReader(const uint8_t* data, size_t size)
+			:m_Data(data), m_Size(size) { }
+
+		template<typename T>
+		bool Read(T& out)
+		{
+			if (m_Offset + sizeof(T) > m_Size)
+			{
+				return false;
+			}
+
+			memcpy(&out, m_Data + m_Offset, sizeof(T));
+			m_Offset += sizeof(T);
+			return true;
+		}
+
+		bool Read(std::string& out, uint32_t length)
+		{
+			if (m_Offset + length > m_Size)
+			{
+				return false;
+			}
+
+			out.assign(reinterpret_cast<const char*>(m_Data + m_Offset), length);
+			m_Offset += length;
+			return true;
+		}
+
+		template<typename T>
+		bool ReadSection(std::vector<T>& out, uint32_t count)
+		{
+			m_Offset = AlignUp(m_Offset, aZero::Asset::MeshletCache::SectionAlignment);
+			const uint64_t numBytes = static_cast<uint64_t>(count) * sizeof(T);
+			if (m_Offset + numBytes > m_Size)
+			{
+				return false;
+			}
+
+			// Empty sections are common, ex. the float vertex streams of quantized meshes
+			out.resize(count);
+			if (numBytes > 0)
+			{
+				memcpy(out.data(), m_Data + m_Offset, numBytes);
+			}
+			m_Offset += numBytes;
+			return true;
+		}
+
+		uint64_t GetRemaining() const { return m_Offset < m_Size ? m_Size - m_Offset : 0; }
+
+	private:
+		const uint8_t* m_Data;
+		size_t m_Size;
+		uint64_t m_Offset = 0;
+	};
+
+	class SectionWriter
+	{
+	public:
+		SectionWriter(std::ofstream& stream)
+			:m_Stream(stream) { }
+
+		void Write(const void* data, uint64_t numBytes)
+		{
+			m_Stream.write(static_cast<const char*>(data), numBytes);
+			m_Offset += numBytes;
+		}
+
+		template<typename T>
+		void WriteSection(const std::vector<T>& data)
+		{
+			static constexpr char padding[aZero::Asset::MeshletCache::SectionAlignment] = {};
+			const uint64_t alignedOffset = AlignUp(m_Offset, aZero::Asset::MeshletCache::SectionAlignment);
+			this->Write(padding, alignedOffset - m_Offset);
+			this->Write(data.data(), data.size() * sizeof(T));
+		}
+
+		uint64_t GetOffset() const { return m_Offset; }
+
+	private:
+		std::ofstream& m_Stream;
+		uint64_t m_Offset = 0;
+	};
+}
+
+std::string aZero::Asset::MeshletCache::GetCachePath(const std::string& sourceFilename, const MeshletBuildSettings& settings)
+{
+	// The stem keeps the name readable, the path hash keeps equally named sources in different directories or with different extensions apart
+	const std::filesystem::path sourcePath = std::filesystem::path(sourceFilename).lexically_normal();
+	const std::string stem = sourcePath.stem().string() + "_" + Helper::HashToHexString(Helper::HashString(sourcePath.generic_string()));
+	return PROJECT_DIRECTORY + MESH_CACHED_RELATIVE_PATH + stem + "_" + std::to_string(settings.MaxVertices) + "_" + std::to_string(settings.MaxTriangles) + (settings.GenerateLods ? "_lod" : "")
+		+ (settings.VertexFormat == VertexFormat::Quantized ? "_q" : "") + ".azmeshlets";
+}
+
+std::optional<std::vector<aZero::Asset::MeshletMeshData>> aZero::Asset::MeshletCache::Load(const std::string& cachePath, uint64_t sourceHash, const MeshletBuildSettings& settings)
+{
+	PROFILE_SCOPE("MeshletCache::Load");
+	Helper::MappedFile file;
+	if (!file.Open(cachePath))
+	{
+		return std::nullopt;
+	}
+
+	SectionReader reader(file.GetData(), file.GetSize());
+
+	FileHeader header;
+	if (!reader.Read(header)
+		|| header.Magic != Magic
+		|| header.Version != Version
+		|| header.SourceHash != sourceHash
+		|| header.MaxVertices != settings.MaxVertices
+		|| header.MaxTriangles != settings.MaxTriangles
+		|| header.GenerateLods != static_cast<uint32_t>(settings.GenerateLods)
+		|| header.VertexFormat != static_cast<uint32_t>(settings.VertexFormat)
+		|| header.FileSize != file.GetSize())
+	{
+		DEBUG_PRINT("Stale or invalid mesh cache: " + cachePath);
+		return std::nullopt;
+	}
+
+	// Every mesh starts with its header, so the count can't exceed what the rest of the file holds
+	if (header.NumMeshes > reader.GetRemaining() / sizeof(MeshHeader))
+	{
+		DEBUG_PRINT("Truncated mesh cache: " + cachePath);
+		return std::nullopt;
+	}
+
+	std::vector<MeshletMeshData> meshes(header.NumMeshes);
+	for (MeshletMeshData& mesh : meshes)
+	{
+		MeshHeader meshHeader;
+		if (!reader.Read(meshHeader)
+			|| !reader.Read(mesh.Name, meshHeader.NameLength)
+			|| !reader.ReadSection(mesh.Meshlets, meshHeader.NumMeshlets)
+			|| !reader.ReadSection(mesh.MeshletIndices, meshHeader.NumMeshletIndices)
+			|| !reader.ReadSection(mesh.MeshletPrimitives, meshHeader.NumMeshletPrimitives)
+			|| !reader.ReadSection(mesh.Positions, meshHeader.NumPositions)
+			|| !reader.ReadSection(mesh.GenericVertexData, meshHeader.NumGenericVertices)
+			|| !reader.ReadSection(mesh.QuantizedPositions, meshHeader.NumQuantizedPositions)
+			|| !reader.ReadSection(mesh.QuantizedVertexData, meshHeader.NumQuantizedVertices)
+			|| !reader.ReadSection(mesh.MeshletGroups, meshHeader.NumMeshletGroups)
+			|| !reader.ReadSection(mesh.MeshletGroupChildren, meshHeader.NumMeshletGroupChildren))
+		{
+			DEBUG_PRINT("Truncated mesh cache: " + cachePath);
+			return std::nullopt;
+		}
+
+		mesh.Bounds = meshHeader.Bounds;
+		mesh.VertexFormat = settings.VertexFormat;
+	}
+
+	return meshes;
+}
+
+bool aZero::Asset::MeshletCache::Save(const std::string& cachePath, uint64_t sourceHash, const MeshletBuildSettings& settings, const std::vector<MeshletMeshData>& meshes)
+{
+	PROFILE_SCOPE("MeshletCache::Save");
+	const std::filesystem::path path(cachePath);
+	std::error_code error;
+	std::filesystem::create_directories(path.parent_path(), error);
+
+	const std::filesystem::path tempPath = path.string() + ".tmp";
+	{
+		std::ofstream stream(tempPath, std::ios::out | std::ios::trunc | std::ios::binary);
+		if (!stream.is_open())
+		{
+			DEBUG_PRINT("Failed to open mesh cache for writing: " + tempPath.string());
+			return false;
+		}
+
+		SectionWriter writer(stream);
+
+		FileHeader header{};
+		header.Magic = Magic;
+		header.Version = Version;
+		header.SourceHash = sourceHash;
+		header.MaxVertices = settings.MaxVertices;
+		header.MaxTriangles = settings.MaxTriangles;
+		header.NumMeshes = static_cast<uint32_t>(meshes.size());
+		header.GenerateLods = static_cast<uint32_t>(settings.GenerateLods);
+		header.VertexFormat = static_cast<uint32_t>(settings.VertexFormat);
+		writer.Write(&header, sizeof(header));
+
+		for (const MeshletMeshData& mesh : meshes)
+		{
+			MeshHeader meshHeader{};
+			meshHeader.NameLength = static_cast<uint32_t>(mesh.Name.size());
+			meshHeader.NumMeshlets = static_cast<uint32_t>(mesh.Meshlets.size());
+			meshHeader.NumMeshletIndices = static_cast<uint32_t>(mesh.MeshletIndices.size());
+			meshHeader.NumMeshletPrimitives = static_cast<uint32_t>(mesh.MeshletPrimitives.size());
+			meshHeader.NumPositions = static_cast<uint32_t>(mesh.Positions.size());
+			meshHeader.NumGenericVertices = static_cast<uint32_t>(mesh.GenericVertexData.size());
+			meshHeader.NumQuantizedPositions = static_cast<uint32_t>(mesh.QuantizedPositions.size());
+			meshHeader.NumQuantizedVertices = static_cast<uint32_t>(mesh.QuantizedVertexData.size());
+			meshHeader.NumMeshletGroups = static_cast<uint32_t>(mesh.MeshletGroups.size());
+			meshHeader.NumMeshletGroupChildren = static_cast<uint32_t>(mesh.MeshletGroupChildren.size());
+			meshHeader.Bounds = mesh.Bounds;
+
+			writer.Write(&meshHeader, sizeof(meshHeader));
+			writer.Write(mesh.Name.data(), mesh.Name.size());
+			writer.WriteSection(mesh.Meshlets);
+			writer.WriteSection(mesh.MeshletIndices);
+			writer.WriteSection(mesh.MeshletPrimitives);
+			writer.WriteSection(mesh.Positions);
+			writer.WriteSection(mesh.GenericVertexData);
+			writer.WriteSection(mesh.QuantizedPositions);
+			writer.WriteSection(mesh.QuantizedVertexData);
+			writer.WriteSection(mesh.MeshletGroups);
+			writer.WriteSection(mesh.MeshletGroupChildren);
+		}
+
+		// Patch the final size into the header so truncated files are rejected on load
+		header.FileSize = writer.GetOffset();
+		stream.seekp(0);
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		if (!stream.good())
+		{
+			DEBUG_PRINT("Failed to write mesh cache: " + tempPath.string());
+			return false;
+		}
+	}
+
+	std::filesystem::rename(tempPath, path, error);
+	if (error)
+	{
+		DEBUG_PRINT("Failed to move mesh cache into place: " + cachePath);
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <optional>
+#include "Mesh.hpp"
+
+namespace aZero
+{
+	namespace Asset
+	{
+		/*
+		Cooked binary format for MeshletMeshData so that warm loads skip the import and meshlet generation.
+
+		Layout:
+			FileHeader
+			For each mesh:
+				MeshHeader
+				Name bytes
+				Meshlets, MeshletIndices, MeshletPrimitives, Positions, GenericVertexData, QuantizedPositions, QuantizedVertexData, MeshletGroups, MeshletGroupChildren (each section starts at a SectionAlignment boundary)
+
+		A cooked file is only considered valid if the magic, version, source hash and build settings all match.
+		*/
+		namespace MeshletCache
+		{
+			constexpr uint32_t Magic = 0x4C4D5A61; // "aZML"
+
+			// NOTE: Bump whenever the layout below, the meshlet structs or the meshlet generation changes
+			constexpr uint32_t Version = 4;
+
+			constexpr uint32_t SectionAlignment = 16;
+
+			struct FileHeader
+			{
+				uint32_t Magic;
+				uint32_t Version;
+				uint64_t SourceHash;
+				uint32_t MaxVertices;
+				uint32_t MaxTriangles;
+				uint32_t NumMeshes;
+				uint32_t GenerateLods;
+				uint32_t VertexFormat;
+				uint32_t Padding;
+				uint64_t FileSize;
+			};
+
+			struct MeshHeader
+			{
+				uint32_t NameLength;
+				uint32_t NumMeshlets;
+				uint32_t NumMeshletIndices;
+				uint32_t NumMeshletPrimitives;
+				uint32_t NumPositions;
+				uint32_t NumGenericVertices;
+				uint32_t NumQuantizedPositions;
+				uint32_t NumQuantizedVertices;
+				uint32_t NumMeshletGroups;
+				uint32_t NumMeshletGroupChildren;
+				DirectX::BoundingSphere Bounds;
+			};
+
+			/** Returns the path of the cooked file for the source file and build settings.
+			@param sourceFilename Filename relative to the mesh asset directory
+			@param settings
+			@return std::string
+			*/
+			std::string GetCachePath(const std::string& sourceFilename, const MeshletBuildSettings& settings);
+
+			/** Maps and validates the cooked file and returns its meshes.
+			* Returns an empty optional if the file doesn't exist or doesn't match the source hash, build settings or version.
+			@param cachePath
+			@param sourceHash
+			@param settings
+			@return std::optional<std::vector<MeshletMeshData>>
+			*/
+			std::optional<std::vector<MeshletMeshData>> Load(const std::string& cachePath, uint64_t sourceHash, const MeshletBuildSettings& settings);
+
+			/** Writes the meshes to the cooked file. The file is written to a temporary path and then renamed so a failed write never leaves a partial file.
+			@param cachePath
+			@param sourceHash
+			@param settings
+			@param meshes
+			@return bool
+			*/
+			bool Save(const std::string& cachePath, uint64_t sourceHash, const MeshletBuildSettings& settings, const std::vector<MeshletMeshData>& meshes);
+		}
+	}
+}
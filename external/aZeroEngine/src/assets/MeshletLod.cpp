@@ -0,0 +1,378 @@
+#include "MeshletLod.hpp"
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include "meshoptimizer.h"
+#include "misc/HelperFunctions.hpp"
+#include "misc/JobSystem.hpp"
+#include "misc/Profiler.hpp"
+
+namespace
+{
+	// Number of neighbouring meshlets that are merged and simplified together, the result is about half as many meshlets
+	constexpr uint32_t GroupSize = 8;
+
+	// A group that keeps more than this fraction of its triangles isn't worth another level, usually because most of it is locked border
+	constexpr float MaxSimplifiedRatio = 0.85f;
+
+	constexpr uint32_t MaxLevels = 32;
+
+	struct Neighbour
+	{
+		uint32_t Slot;
+		uint32_t NumSharedVertices;
+	};
+
+	// Output of simplifying one group, offsets are relative to the group until it's appended to the mesh
+	struct GroupResult
+	{
+		bool Simplified = false;
+		float Error = 0.f;
+		std::vector<aZero::Asset::Meshlet> Meshlets;
+		std::vector<aZero::Asset::VertexIndex> MeshletIndices;
+		std::vector<uint32_t> MeshletPrimitives;
+	};
+
+	// Per job buffers that are reused between the groups of a batch
+	struct GroupScratch
+	{
+		std::vector<uint32_t> Indices;
+		std::vector<uint32_t> SimplifiedIndices;
+		std::vector<aZero::Asset::VertexPosition> Positions;
+		std::vector<aZero::Asset::VertexIndex> LocalToGlobal;
+		std::unordered_map<aZero::Asset::VertexIndex, uint32_t> GlobalToLocal;
+		std::vector<meshopt_Meshlet> Meshlets;
+		std::vector<unsigned int> MeshletVertices;
+		std::vector<unsigned char> MeshletTriangles;
+	};
+
+	aZero::Asset::MeshletLodBounds MergeLodBounds(const aZero::Asset::MeshletLodBounds& a, const aZero::Asset::MeshletLodBounds& b)
+	{
+		aZero::Asset::MeshletLodBounds merged;
+		merged.Error = std::max(a.Error, b.Error);
+
+		const DXM::Vector3 offset = b.Center - a.Center;
+		const float distance = offset.Length();
+		if (distance + b.Radius <= a.Radius)
+		{
+			merged.Center = a.Center;
+			merged.Radius = a.Radius;
+		}
+		else if (distance + a.Radius <= b.Radius)
+		{
+			merged.Center = b.Center;
+			merged.Radius = b.Radius;
+		}
+		else
+		{
+			merged.Radius = (distance + a.Radius + b.Radius) * 0.5f;
+			merged.Center = a.Center + offset * ((merged.Radius - a.Radius) / distance);
+		}
+		return merged;
+	}
+
+	/*
+	Splits the meshlets into groups of up to GroupSize meshlets.
+	Groups are grown greedily from a seed by adding the unassigned meshlet that shares the most vertices with the group, so the groups stay compact
+	and the locked border between them stays short.
+	*/
+	std::vector<std::vector<uint32_t>> GroupMeshlets(const aZero::Asset::MeshletMeshData& mesh, const std::vector<uint32_t>& meshlets)
+	{
+		// (vertex, slot) pairs sorted by vertex, the meshlet vertex lists never contain duplicates
+		std::vector<std::pair<aZero::Asset::VertexIndex, uint32_t>> vertexSlots;
+		for (uint32_t slot = 0; slot < meshlets.size(); slot++)
+		{
+			const aZero::Asset::Meshlet& meshlet = mesh.Meshlets[meshlets[slot]];
+			for (uint32_t vertex = 0; vertex < meshlet.VerticesCount; vertex++)
+			{
+				vertexSlots.emplace_back(mesh.MeshletIndices[meshlet.VertexOffset + vertex], slot);
+			}
+		}
+		std::sort(vertexSlots.begin(), vertexSlots.end());
+
+		std::vector<std::vector<Neighbour>> neighbours(meshlets.size());
+		const auto addSharedVertex = [&neighbours](uint32_t slot, uint32_t otherSlot)
+			{
+				auto it = std::find_if(neighbours[slot].begin(), neighbours[slot].end(), [otherSlot](const Neighbour& neighbour) { return neighbour.Slot == otherSlot; });
+				if (it == neighbours[slot].end())
+				{
+					neighbours[slot].push_back({ otherSlot, 1 });
+				}
+				else
+				{
+					it->NumSharedVertices++;
+				}
+			};
+
+		for (size_t runStart = 0; runStart < vertexSlots.size();)
+		{
+			size_t runEnd = runStart + 1;
+			while (runEnd < vertexSlots.size() && vertexSlots[runEnd].first == vertexSlots[runStart].first)
+			{
+				runEnd++;
+			}
+
+			for (size_t a = runStart; a < runEnd; a++)
+			{
+				for (size_t b = a + 1; b < runEnd; b++)
+				{
+					addSharedVertex(vertexSlots[a].second, vertexSlots[b].second);
+					addSharedVertex(vertexSlots[b].second, vertexSlots[a].second);
+				}
+			}
+			runStart = runEnd;
+		}
+
+		std::vector<std::vector<uint32_t>> groups;
+		std::vector<bool> assigned(meshlets.size(), false);
+		std::vector<Neighbour> candidates;
+
+		// Seeds are taken in meshlet order, which is already spatially coherent
+		for (uint32_t seed = 0; seed < meshlets.size(); seed++)
+		{
+			if (assigned[seed])
+			{
+				continue;
+			}
+
+			std::vector<uint32_t> groupSlots = { seed };
+			assigned[seed] = true;
+			while (groupSlots.size() < GroupSize)
+			{
+				candidates.clear();
+				for (const uint32_t member : groupSlots)
+				{
+					for (const Neighbour& neighbour : neighbours[member])
+					{
+						if (assigned[neighbour.Slot])
+						{
+							continue;
+						}
+
+						auto it = std::find_if(candidates.begin(), candidates.end(), [&neighbour](const Neighbour& candidate) { return candidate.Slot == neighbour.Slot; });
+						if (it == candidates.end())
+						{
+							candidates.push_back(neighbour);
+						}
+						else
+						{
+							it->NumSharedVertices += neighbour.NumSharedVertices;
+						}
+					}
+				}
+
+				if (candidates.empty())
+				{
+					break;
+				}
+
+				const Neighbour& best = *std::max_element(candidates.begin(), candidates.end(),
+					[](const Neighbour& a, const Neighbour& b) { return a.NumSharedVertices < b.NumSharedVertices; });
+				groupSlots.push_back(best.Slot);
+				assigned[best.Slot] = true;
+			}
+
+			std::vector<uint32_t>& group = groups.emplace_back();
+			for (const uint32_t slot : groupSlots)
+			{
+				group.push_back(meshlets[slot]);
+			}
+		}
+
+		return groups;
+	}
+
+	/*
+	Simplifies the triangles of the group to about half with the group border locked and splits the result into meshlets.
+	The group's vertices are compacted first so the simplifier and meshlet builder only touch the vertices of the group.
+	*/
+	void SimplifyGroup(const aZero::Asset::MeshletMeshData& mesh, const std::vector<uint32_t>& group, const aZero::Asset::MeshletBuildSettings& settings, GroupScratch& scratch, GroupResult& result)
+	{
+		scratch.Indices.clear();
+		scratch.Positions.clear();
+		scratch.LocalToGlobal.clear();
+		scratch.GlobalToLocal.clear();
+		for (const uint32_t meshletIndex : group)
+		{
+			const aZero::Asset::Meshlet& meshlet = mesh.Meshlets[meshletIndex];
+			for (uint32_t primitive = 0; primitive < meshlet.PrimitivesCount; primitive++)
+			{
+				const uint32_t packedPrimitive = mesh.MeshletPrimitives[meshlet.PrimitiveOffset + primitive];
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					const aZero::Asset::VertexIndex vertex = mesh.MeshletIndices[meshlet.VertexOffset + ((packedPrimitive >> (corner * 8)) & 0xFF)];
+					const auto [it, inserted] = scratch.GlobalToLocal.try_emplace(vertex, static_cast<uint32_t>(scratch.LocalToGlobal.size()));
+					if (inserted)
+					{
+						scratch.LocalToGlobal.push_back(vertex);
+						scratch.Positions.push_back(mesh.Positions[vertex]);
+					}
+					scratch.Indices.push_back(it->second);
+				}
+			}
+		}
+
+		const size_t numIndices = scratch.Indices.size();
+		const size_t targetIndexCount = (numIndices / 6) * 3;
+		scratch.SimplifiedIndices.resize(numIndices);
+		float simplificationError = 0.f;
+		const size_t numSimplifiedIndices = meshopt_simplify(
+			scratch.SimplifiedIndices.data(), scratch.Indices.data(), numIndices,
+			&scratch.Positions[0].x, scratch.Positions.size(), sizeof(aZero::Asset::VertexPosition),
+			targetIndexCount, std::numeric_limits<float>::max(), meshopt_SimplifyLockBorder | meshopt_SimplifyErrorAbsolute, &simplificationError);
+
+		if (numSimplifiedIndices == 0 || numSimplifiedIndices > numIndices * MaxSimplifiedRatio)
+		{
+			return;
+		}
+
+		const size_t maxMeshlets = meshopt_buildMeshletsBound(numSimplifiedIndices, settings.MaxVertices, settings.MaxTriangles);
+		scratch.Meshlets.resize(maxMeshlets);
+		scratch.MeshletVertices.resize(maxMeshlets * settings.MaxVertices);
+		scratch.MeshletTriangles.resize(maxMeshlets * settings.MaxTriangles * 3);
+		const size_t numMeshlets = meshopt_buildMeshlets(scratch.Meshlets.data(), scratch.MeshletVertices.data(), scratch.MeshletTriangles.data(),
+			scratch.SimplifiedIndices.data(), numSimplifiedIndices, &scratch.Positions[0].x, scratch.Positions.size(), sizeof(aZero::Asset::VertexPosition),
+			settings.MaxVertices, settings.MaxTriangles, 0.f);
+
+		result.Simplified = true;
+		result.Error = simplificationError;
+		result.Meshlets.reserve(numMeshlets);
+		for (size_t meshletIndex = 0; meshletIndex < numMeshlets; meshletIndex++)
+		{
+			const meshopt_Meshlet& meshlet = scratch.Meshlets[meshletIndex];
+			meshopt_optimizeMeshlet(&scratch.MeshletVertices[meshlet.vertex_offset], &scratch.MeshletTriangles[meshlet.triangle_offset], meshlet.triangle_count, meshlet.vertex_count);
+			const meshopt_Bounds bounds = meshopt_computeMeshletBounds(&scratch.MeshletVertices[meshlet.vertex_offset], &scratch.MeshletTriangles[meshlet.triangle_offset],
+				meshlet.triangle_count, &scratch.Positions[0].x, scratch.Positions.size(), sizeof(aZero::Asset::VertexPosition));
+
+			aZero::Asset::Meshlet& output = result.Meshlets.emplace_back();
+			output.VerticesCount = meshlet.vertex_count;
+			output.VertexOffset = static_cast<uint32_t>(result.MeshletIndices.size());
+			output.PrimitivesCount = meshlet.triangle_count;
+			output.PrimitiveOffset = static_cast<uint32_t>(result.MeshletPrimitives.size());
+			output.Bounds = DirectX::BoundingSphere(DXM::Vector3(bounds.center[0], bounds.center[1], bounds.center[2]), bounds.radius);
+
+			for (uint32_t vertex = 0; vertex < meshlet.vertex_count; vertex++)
+			{
+				result.MeshletIndices.push_back(scratch.LocalToGlobal[scratch.MeshletVertices[meshlet.vertex_offset + vertex]]);
+			}
+
+			const unsigned char* triangles = &scratch.MeshletTriangles[meshlet.triangle_offset];
+			for (uint32_t primitive = 0; primitive < meshlet.triangle_count; primitive++)
+			{
+				result.MeshletPrimitives.push_back(aZero::Helper::Pack8To32(triangles[primitive * 3], triangles[primitive * 3 + 1], triangles[primitive * 3 + 2], 0));
+			}
+		}
+	}
+}
+
+void aZero::Asset::BuildMeshletLods(MeshletMeshData& mesh, const MeshletBuildSettings& settings)
+{
+	PROFILE_SCOPE("Asset::BuildMeshletLods");
+	mesh.MeshletGroups.clear();
+	mesh.MeshletGroupChildren.clear();
+
+	for (Meshlet& meshlet : mesh.Meshlets)
+	{
+		meshlet.Lod = { DXM::Vector3(meshlet.Bounds.Center), meshlet.Bounds.Radius, 0.f };
+		meshlet.ParentLod = { DXM::Vector3(), 0.f, std::numeric_limits<float>::max() };
+		meshlet.SourceGroup = InvalidMeshletGroup;
+		meshlet.ParentGroup = InvalidMeshletGroup;
+	}
+
+	std::vector<uint32_t> levelMeshlets(mesh.Meshlets.size());
+	std::iota(levelMeshlets.begin(), levelMeshlets.end(), 0);
+	for (uint32_t level = 1; level < MaxLevels && levelMeshlets.size() > 1; level++)
+	{
+		const std::vector<std::vector<uint32_t>> groups = GroupMeshlets(mesh, levelMeshlets);
+
+		// The groups only read the mesh, the results are appended in group order afterwards so the output doesn't depend on the scheduling
+		std::vector<GroupResult> results(groups.size());
+		Jobs::GetJobSystem().ParallelFor(static_cast<uint32_t>(groups.size()), 4, [&](uint32_t begin, uint32_t end)
+			{
+				GroupScratch scratch;
+				for (uint32_t groupIndex = begin; groupIndex < end; groupIndex++)
+				{
+					SimplifyGroup(mesh, groups[groupIndex], settings, scratch, results[groupIndex]);
+				}
+			});
+
+		std::vector<uint32_t> nextLevelMeshlets;
+		bool simplifiedAny = false;
+		for (size_t groupIndex = 0; groupIndex < groups.size(); groupIndex++)
+		{
+			const std::vector<uint32_t>& group = groups[groupIndex];
+			GroupResult& result = results[groupIndex];
+			if (!result.Simplified)
+			{
+				// Retried together with other neighbours on the next level
+				nextLevelMeshlets.insert(nextLevelMeshlets.end(), group.begin(), group.end());
+				continue;
+			}
+			simplifiedAny = true;
+
+			// The group error and sphere contain the ones of every child, which keeps the projected error monotonic towards the root
+			MeshletLodBounds groupLod = mesh.Meshlets[group[0]].Lod;
+			for (const uint32_t child : group)
+			{
+				groupLod = MergeLodBounds(groupLod, mesh.Meshlets[child].Lod);
+			}
+			groupLod.Error = std::max(groupLod.Error, result.Error);
+
+			MeshletGroup meshletGroup;
+			meshletGroup.FirstChild = static_cast<uint32_t>(mesh.MeshletGroupChildren.size());
+			meshletGroup.NumChildren = static_cast<uint32_t>(group.size());
+			meshletGroup.FirstParent = static_cast<uint32_t>(mesh.Meshlets.size());
+			meshletGroup.NumParents = static_cast<uint32_t>(result.Meshlets.size());
+			meshletGroup.Level = level;
+			meshletGroup.Lod = groupLod;
+
+			const uint32_t meshletGroupIndex = static_cast<uint32_t>(mesh.MeshletGroups.size());
+			mesh.MeshletGroups.push_back(meshletGroup);
+			mesh.MeshletGroupChildren.insert(mesh.MeshletGroupChildren.end(), group.begin(), group.end());
+			for (const uint32_t child : group)
+			{
+				mesh.Meshlets[child].ParentLod = groupLod;
+				mesh.Meshlets[child].ParentGroup = meshletGroupIndex;
+			}
+
+			const uint32_t indexOffset = static_cast<uint32_t>(mesh.MeshletIndices.size());
+			const uint32_t primitiveOffset = static_cast<uint32_t>(mesh.MeshletPrimitives.size());
+			for (Meshlet& parent : result.Meshlets)
+			{
+				parent.VertexOffset += indexOffset;
+				parent.PrimitiveOffset += primitiveOffset;
+				parent.Lod = groupLod;
+				parent.SourceGroup = meshletGroupIndex;
+				nextLevelMeshlets.push_back(static_cast<uint32_t>(mesh.Meshlets.size()));
+				mesh.Meshlets.push_back(parent);
+			}
+			mesh.MeshletIndices.insert(mesh.MeshletIndices.end(), result.MeshletIndices.begin(), result.MeshletIndices.end());
+			mesh.MeshletPrimitives.insert(mesh.MeshletPrimitives.end(), result.MeshletPrimitives.begin(), result.MeshletPrimitives.end());
+		}
+
+		if (!simplifiedAny)
+		{
+			break;
+		}
+
+		levelMeshlets = std::move(nextLevelMeshlets);
+	}
+}
+
+float aZero::Asset::ComputeProjectedLodError(const MeshletLodBounds& bounds, const MeshletLodView& view)
+{
+	const float distance = std::max((bounds.Center - view.Position).Length() - bounds.Radius, view.NearZ);
+	return bounds.Error / distance * view.ProjectionScale;
+}
+
+void aZero::Asset::SelectMeshletLods(const MeshletMeshData& mesh, const MeshletLodView& view, std::vector<uint32_t>& output)
+{
+	for (uint32_t meshletIndex = 0; meshletIndex < mesh.Meshlets.size(); meshletIndex++)
+	{
+		const Meshlet& meshlet = mesh.Meshlets[meshletIndex];
+		if (ComputeProjectedLodError(meshlet.Lod, view) <= view.ErrorThreshold && ComputeProjectedLodError(meshlet.ParentLod, view) > view.ErrorThreshold)
+		{
+			output.push_back(meshletIndex);
+		}
+	}
+}
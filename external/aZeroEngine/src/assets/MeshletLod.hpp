@@ -0,0 +1,60 @@
+#pragma once
+#include "Mesh.hpp"
+
+namespace aZero
+{
+	namespace Asset
+	{
+		/*
+		Cluster LOD hierarchy of the meshlets of a mesh.
+
+		Each level is built by grouping neighbouring meshlets, simplifying every group to about half its triangles with the group border locked
+		and splitting the result into new meshlets, until the mesh can't be simplified further.
+		Since the group borders are locked, any set of meshlets where each one is selected independently by the rule below is crack-free:
+
+			ProjectedError(meshlet.Lod) <= threshold && ProjectedError(meshlet.ParentLod) > threshold
+
+		This holds because the error and sphere of a group always contain the ones of its children, so the projected error can only grow towards the root.
+		The same test runs per meshlet in MeshletCulling.cs.hlsl.
+		*/
+
+		struct MeshletLodView
+		{
+			// Camera position in the local space of the mesh
+			DXM::Vector3 Position;
+
+			// Converts an error at distance 1 into pixels, ScreenHeight / (2 * tan(FovY / 2))
+			float ProjectionScale = 1.f;
+
+			// Distances are clamped to the near plane so meshlets around the camera don't divide by zero
+			// NOTE: A uniformly scaled instance is handled by dividing NearZ by the scale, the projected error doesn't change otherwise
+			float NearZ = 0.1f;
+
+			// Largest allowed projected error in pixels
+			float ErrorThreshold = 1.f;
+		};
+
+		/** Builds the LOD hierarchy from the full detail meshlets of the mesh and appends the coarser meshlets to it.
+		@param mesh
+		@param settings
+		@return void
+		*/
+		void BuildMeshletLods(MeshletMeshData& mesh, const MeshletBuildSettings& settings);
+
+		/** Returns the error of the LOD bounds projected to the screen in pixels
+		@param bounds
+		@param view
+		@return float
+		*/
+		float ComputeProjectedLodError(const MeshletLodBounds& bounds, const MeshletLodView& view);
+
+		/** Appends the indices of the meshlets that are selected for the view.
+		* The selection covers the whole mesh exactly once, using the coarsest meshlets whose projected error is within the threshold.
+		@param mesh
+		@param view
+		@param output
+		@return void
+		*/
+		void SelectMeshletLods(const MeshletMeshData& mesh, const MeshletLodView& view, std::vector<uint32_t>& output);
+	}
+}
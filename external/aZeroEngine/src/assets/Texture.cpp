@@ -1,9 +1,128 @@
 #include "Texture.hpp"
+#include "TextureCache.hpp"
 #include "misc/EngineDebugMacros.hpp"
 #include "misc/stb_image.h"
+#include "misc/JobSystem.hpp"
+#include "misc/Hash.hpp"
+#include "misc/Profiler.hpp"
+#include <atomic>
+
+namespace
+{
+	struct CookFormat
+	{
+		bool IsCompressed = false;
+		aZero::Asset::TextureProcessing::BlockFormat Block = aZero::Asset::TextureProcessing::BlockFormat::BC1;
+		bool IsSRGB = false;
+
+		// Used if the format isn't compressed or the texture can't be block compressed
+		DXGI_FORMAT UncompressedFormat = DXGI_FORMAT_UNKNOWN;
+	};
+
+	std::optional<CookFormat> GetCookFormat(DXGI_FORMAT format)
+	{
+		using aZero::Asset::TextureProcessing::BlockFormat;
+		switch (format)
+		{
+		case DXGI_FORMAT_R8G8B8A8_UNORM: return CookFormat{ false, BlockFormat::BC1, false, DXGI_FORMAT_R8G8B8A8_UNORM };
+		case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB: return CookFormat{ false, BlockFormat::BC1, true, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB };
+		case DXGI_FORMAT_BC1_UNORM: return CookFormat{ true, BlockFormat::BC1, false, DXGI_FORMAT_R8G8B8A8_UNORM };
+		case DXGI_FORMAT_BC1_UNORM_SRGB: return CookFormat{ true, BlockFormat::BC1, true, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB };
+		case DXGI_FORMAT_BC3_UNORM: return CookFormat{ true, BlockFormat::BC3, false, DXGI_FORMAT_R8G8B8A8_UNORM };
+		case DXGI_FORMAT_BC3_UNORM_SRGB: return CookFormat{ true, BlockFormat::BC3, true, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB };
+		case DXGI_FORMAT_BC5_UNORM: return CookFormat{ true, BlockFormat::BC5, false, DXGI_FORMAT_R8G8B8A8_UNORM };
+		case DXGI_FORMAT_BC7_UNORM: return CookFormat{ true, BlockFormat::BC7, false, DXGI_FORMAT_R8G8B8A8_UNORM };
+		case DXGI_FORMAT_BC7_UNORM_SRGB: return CookFormat{ true, BlockFormat::BC7, true, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB };
+		default: return std::nullopt;
+		}
+	}
+
+	aZero::Asset::TextureMip GetMipLayout(uint32_t width, uint32_t height, const CookFormat& format, bool compress)
+	{
+		aZero::Asset::TextureMip mip;
+		mip.Width = width;
+		mip.Height = height;
+		if (compress)
+		{
+			mip.RowPitch = ((width + 3) / 4) * aZero::Asset::TextureProcessing::GetBlockSize(format.Block);
+			mip.NumRows = (height + 3) / 4;
+		}
+		else
+		{
+			mip.RowPitch = width * 4;
+			mip.NumRows = height;
+		}
+		mip.Size = static_cast<uint64_t>(mip.RowPitch) * mip.NumRows;
+		return mip;
+	}
+}
+
+std::optional<aZero::Asset::TextureData> aZero::Asset::CookTexture(const uint8_t* texels, uint32_t width, uint32_t height, uint32_t numChannels, const TextureCookSettings& settings)
+{
+	PROFILE_SCOPE("Asset::CookTexture");
+	const std::optional<CookFormat> format = GetCookFormat(settings.Format);
+	if (!format.has_value())
+	{
+		DEBUG_PRINT("Unsupported texture cook format: " + std::to_string(static_cast<uint32_t>(settings.Format)));
+		return std::nullopt;
+	}
+
+	TextureData data;
+	data.Width = width;
+	data.Height = height;
+	data.NumChannels = numChannels;
+	data.Format = settings.Format;
+
+	// D3D12 requires the top level of a block compressed texture to be a whole number of blocks
+	bool compress = format->IsCompressed;
+	if (compress && (width % 4 != 0 || height % 4 != 0))
+	{
+		DEBUG_PRINT("Texture size isn't a multiple of 4, falling back to an uncompressed format");
+		compress = false;
+		data.Format = format->UncompressedFormat;
+	}
+
+	std::vector<TextureProcessing::MipLevel> lowerMips;
+	if (settings.GenerateMips)
+	{
+		lowerMips = TextureProcessing::GenerateMipChain(texels, width, height, settings.Filter, format->IsSRGB);
+	}
+
+	data.Mips.reserve(lowerMips.size() + 1);
+	uint64_t totalSize = 0;
+	data.Mips.push_back(GetMipLayout(width, height, *format, compress));
+	for (const TextureProcessing::MipLevel& level : lowerMips)
+	{
+		data.Mips.push_back(GetMipLayout(level.Width, level.Height, *format, compress));
+	}
+
+	for (TextureMip& mip : data.Mips)
+	{
+		mip.Offset = totalSize;
+		totalSize += mip.Size;
+	}
+
+	data.TexelData.resize(totalSize);
+	for (size_t mipIndex = 0; mipIndex < data.Mips.size(); mipIndex++)
+	{
+		const TextureMip& mip = data.Mips[mipIndex];
+		const uint8_t* mipTexels = mipIndex == 0 ? texels : lowerMips[mipIndex - 1].Texels.data();
+		if (compress)
+		{
+			TextureProcessing::CompressImage(mipTexels, mip.Width, mip.Height, format->Block, data.TexelData.data() + mip.Offset);
+		}
+		else
+		{
+			memcpy(data.TexelData.data() + mip.Offset, mipTexels, mip.Size);
+		}
+	}
+
+	return data;
+}
 
 bool aZero::Asset::Texture::Load(const std::string& filePath, DXGI_FORMAT format)
 {
+	PROFILE_SCOPE("Texture::Load");
 	std::int32_t width, height, channels;
 	stbi_uc* loadedImage = stbi_load(filePath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
 	if (!loadedImage)
@@ -12,22 +131,112 @@ bool aZero::Asset::Texture::Load(const std::string& filePath, DXGI_FORMAT format
 		return false;
 	}
 
-	if (channels == 4 || channels == 3)
+	if (channels != 4 && channels != 3)
 	{
-		m_Data.TexelData.resize(width * height * 4);
-		memcpy(m_Data.TexelData.data(), loadedImage, m_Data.TexelData.size());
-		m_Data.Width = width;
-		m_Data.Height = height;
-		m_Data.NumChannels = channels;
+		stbi_image_free(loadedImage);
+		DEBUG_PRINT("Loading a texture with less than 3 channels isn't supported");
+		return false;
 	}
-	else
+
+	m_Data = TextureData();
+	m_Data.TexelData.resize(width * height * 4);
+	memcpy(m_Data.TexelData.data(), loadedImage, m_Data.TexelData.size());
+	m_Data.Width = width;
+	m_Data.Height = height;
+	m_Data.NumChannels = channels;
+	m_Data.Format = format;
+
+	TextureMip mip;
+	mip.Width = width;
+	mip.Height = height;
+	mip.RowPitch = width * 4;
+	mip.NumRows = height;
+	mip.Size = m_Data.TexelData.size();
+	m_Data.Mips.push_back(mip);
+
+	stbi_image_free(loadedImage);
+
+	return true;
+}
+
+bool aZero::Asset::Texture::Load(const std::string& filePath, const TextureCookSettings& settings)
+{
+	PROFILE_SCOPE("Texture::Load");
+	Helper::MappedFile sourceFile;
+	if (!sourceFile.Open(filePath))
 	{
+		DEBUG_PRINT("Failed to load file: " + filePath);
+		return false;
+	}
+
+	// The source hash keys the cooked file so any edit to the source invalidates it
+	std::optional<uint64_t> sourceHash;
+	std::string cachePath;
+	if (settings.UseCache)
+	{
+		sourceHash = Helper::HashBytes(sourceFile.GetData(), sourceFile.GetSize());
+		cachePath = TextureCache::GetCachePath(filePath, settings);
+		if (auto cachedTexture = TextureCache::Load(cachePath, sourceHash.value(), settings))
+		{
+			m_Data = std::move(cachedTexture.value());
+			return true;
+		}
+	}
+
+	std::int32_t width, height, channels;
+	stbi_uc* loadedImage = stbi_load_from_memory(sourceFile.GetData(), static_cast<int>(sourceFile.GetSize()), &width, &height, &channels, STBI_rgb_alpha);
+	if (!loadedImage)
+	{
+		DEBUG_PRINT("Failed to decode file: " + filePath);
+		return false;
+	}
+
+	if (channels != 4 && channels != 3)
+	{
+		stbi_image_free(loadedImage);
 		DEBUG_PRINT("Loading a texture with less than 3 channels isn't supported");
 		return false;
 	}
 
+	std::optional<TextureData> cookedTexture = CookTexture(loadedImage, width, height, channels, settings);
 	stbi_image_free(loadedImage);
-	m_Data.Format = format;
+	if (!cookedTexture.has_value())
+	{
+		return false;
+	}
+
+	if (sourceHash.has_value())
+	{
+		TextureCache::Save(cachePath, sourceHash.value(), settings, cookedTexture.value());
+	}
 
+	m_Data = std::move(cookedTexture.value());
 	return true;
+}
+
+uint32_t aZero::Asset::LoadTextures(std::span<const TextureLoadRequest> requests)
+{
+	// Every request writes to its own texture, so the decodes don't share any state
+	std::atomic<uint32_t> numLoaded = 0;
+	Jobs::GetJobSystem().ParallelFor(static_cast<uint32_t>(requests.size()), 1, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t requestIndex = begin; requestIndex < end; requestIndex++)
+			{
+				const TextureLoadRequest& request = requests[requestIndex];
+				if (!request.Target)
+				{
+					continue;
+				}
+
+				const bool loaded = request.CookSettings.has_value()
+					? request.Target->Load(request.FilePath, request.CookSettings.value())
+					: request.Target->Load(request.FilePath, request.Format);
+				if (loaded)
+				{
+					numLoaded++;
+				}
+			}
+		});
+
+	return numLoaded;
 }
\ No newline at end of file
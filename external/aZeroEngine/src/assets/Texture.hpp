@@ -1,6 +1,11 @@
 #pragma once
 #include <vector>
+#include <span>
+#include <optional>
 #include "Asset.hpp"
+#include "graphics_api/D3D12Include.hpp"
+#include "TextureProcessing.hpp"
+#include "misc/MappedFile.hpp"
 
 namespace aZero
 {
@@ -11,14 +16,60 @@ namespace aZero
 
 	namespace Asset
 	{
-		// TODO: Support mips
+		struct TextureMip
+		{
+			uint32_t Width = 0;
+			uint32_t Height = 0;
+
+			// Bytes per row and number of rows, a row is a row of 4x4 blocks for the block compressed formats
+			uint32_t RowPitch = 0;
+			uint32_t NumRows = 0;
+
+			// Offset from TextureData::GetTexels()
+			uint64_t Offset = 0;
+			uint64_t Size = 0;
+		};
+
 		struct TextureData
 		{
+			// Texels of every mip, either owned or, for textures loaded from the texture cache, read directly from the mapped cooked file
+			// NOTE: The mapping is released once the upload has been recorded so the cache file can be replaced, the texels aren't available after that
 			std::vector<uint8_t> TexelData;
+			Helper::MappedFile CookedFile;
+
+			// Top level first
+			std::vector<TextureMip> Mips;
+
 			uint32_t Width, Height, NumChannels;
 			DXGI_FORMAT Format;
+
+			const uint8_t* GetTexels() const { return CookedFile.IsOpen() ? CookedFile.GetData() : TexelData.data(); }
+			bool HasTexels() const { return CookedFile.IsOpen() || !TexelData.empty(); }
+		};
+
+		struct TextureCookSettings
+		{
+			// R8G8B8A8, BC1, BC3, BC5 or BC7. The sRGB formats filter the mips in linear space.
+			// NOTE: Block compressed formats fall back to R8G8B8A8 if the texture size isn't a multiple of 4
+			DXGI_FORMAT Format = DXGI_FORMAT::DXGI_FORMAT_BC7_UNORM_SRGB;
+
+			TextureProcessing::MipFilter Filter = TextureProcessing::MipFilter::Kaiser;
+			bool GenerateMips = true;
+
+			// If true the cooked texture is read from/written to the texture cache directory
+			bool UseCache = true;
 		};
 
+		/** Generates the mips and compresses the decoded RGBA8 image according to the settings.
+		@param texels Tightly packed RGBA8
+		@param width
+		@param height
+		@param numChannels Number of channels in the source file
+		@param settings
+		@return std::optional<TextureData> Empty if the format isn't supported
+		*/
+		std::optional<TextureData> CookTexture(const uint8_t* texels, uint32_t width, uint32_t height, uint32_t numChannels, const TextureCookSettings& settings);
+
 		class Texture : public AssetBase
 		{
 			friend class Rendering::Renderer;
@@ -31,8 +82,12 @@ namespace aZero
 
 			}
 
+			// Decodes the file into a single uncompressed mip
 			bool Load(const std::string& filePath, DXGI_FORMAT format);
 
+			// Loads the cooked texture from the texture cache, or decodes and cooks the file if it isn't cached
+			bool Load(const std::string& filePath, const TextureCookSettings& settings);
+
 			const TextureData& GetData() {
 				return m_Data;
 			}
@@ -40,5 +95,21 @@ namespace aZero
 		private:
 			TextureData m_Data;
 		};
+
+		struct TextureLoadRequest
+		{
+			Texture* Target = nullptr;
+			std::string FilePath;
+			DXGI_FORMAT Format = DXGI_FORMAT_UNKNOWN;
+
+			// If set the texture is cooked with these settings and Format is ignored
+			std::optional<TextureCookSettings> CookSettings;
+		};
+
+		/** Decodes the textures in parallel on the engine job system
+		@param requests
+		@return uint32_t Number of textures that were loaded
+		*/
+		uint32_t LoadTextures(std::span<const TextureLoadRequest> requests);
 	}
 }
\ No newline at end of file
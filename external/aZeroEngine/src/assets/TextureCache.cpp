@@ -0,0 +1,150 @@
+#include "TextureCache.hpp"
+#include "misc/EngineDebugMacros.hpp"
+#include "misc/Hash.hpp"
+#include <filesystem>
+#include <fstream>
+#include "misc/RelativePathMacros.hpp"
+
+namespace
+{
+	constexpr uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	uint32_t GetExpectedNumMips(uint32_t width, uint32_t height, const aZero::Asset::TextureCookSettings& settings)
+	{
+		return settings.GenerateMips ? aZero::Asset::TextureProcessing::GetNumMipLevels(width, height) : 1;
+	}
+}
+
+std::string aZero::Asset::TextureCache::GetCachePath(const std::string& sourceFilePath, const TextureCookSettings& settings)
+{
+	// The stem keeps the name readable, the path hash keeps equally named sources in different directories or with different extensions apart
+	const std::filesystem::path sourcePath = std::filesystem::path(sourceFilePath).lexically_normal();
+	const std::string stem = sourcePath.stem().string() + "_" + Helper::HashToHexString(Helper::HashString(sourcePath.generic_string()));
+	const std::string filter = !settings.GenerateMips ? "nomips" : (settings.Filter == TextureProcessing::MipFilter::Kaiser ? "kaiser" : "box");
+	return PROJECT_DIRECTORY + TEXTURE_CACHED_RELATIVE_PATH + stem + "_" + std::to_string(static_cast<uint32_t>(settings.Format)) + "_" + filter + ".aztex";
+}
+
+std::optional<aZero::Asset::TextureData> aZero::Asset::TextureCache::Load(const std::string& cachePath, uint64_t sourceHash, const TextureCookSettings& settings)
+{
+	Helper::MappedFile file;
+	if (!file.Open(cachePath))
+	{
+		return std::nullopt;
+	}
+
+	FileHeader header;
+	if (file.GetSize() < sizeof(FileHeader))
+	{
+		DEBUG_PRINT("Truncated texture cache: " + cachePath);
+		return std::nullopt;
+	}
+
+	memcpy(&header, file.GetData(), sizeof(header));
+	if (header.Magic != Magic
+		|| header.Version != Version
+		|| header.SourceHash != sourceHash
+		|| header.RequestedFormat != static_cast<uint32_t>(settings.Format)
+		|| header.Filter != static_cast<uint32_t>(settings.Filter)
+		|| header.NumMips != GetExpectedNumMips(header.Width, header.Height, settings)
+		|| header.FileSize != file.GetSize())
+	{
+		DEBUG_PRINT("Stale or invalid texture cache: " + cachePath);
+		return std::nullopt;
+	}
+
+	if (sizeof(FileHeader) + static_cast<uint64_t>(header.NumMips) * sizeof(TextureMip) > file.GetSize())
+	{
+		DEBUG_PRINT("Truncated texture cache: " + cachePath);
+		return std::nullopt;
+	}
+
+	TextureData texture;
+	texture.Mips.resize(header.NumMips);
+	memcpy(texture.Mips.data(), file.GetData() + sizeof(FileHeader), texture.Mips.size() * sizeof(TextureMip));
+	for (const TextureMip& mip : texture.Mips)
+	{
+		if (mip.Size != static_cast<uint64_t>(mip.RowPitch) * mip.NumRows || mip.Offset + mip.Size > file.GetSize())
+		{
+			DEBUG_PRINT("Truncated texture cache: " + cachePath);
+			return std::nullopt;
+		}
+	}
+
+	texture.Width = header.Width;
+	texture.Height = header.Height;
+	texture.NumChannels = header.NumChannels;
+	texture.Format = static_cast<DXGI_FORMAT>(header.Format);
+	texture.CookedFile = std::move(file);
+	return texture;
+}
+
+bool aZero::Asset::TextureCache::Save(const std::string& cachePath, uint64_t sourceHash, const TextureCookSettings& settings, const TextureData& texture)
+{
+	const std::filesystem::path path(cachePath);
+	std::error_code error;
+	std::filesystem::create_directories(path.parent_path(), error);
+
+	const std::filesystem::path tempPath = path.string() + ".tmp";
+	{
+		std::ofstream stream(tempPath, std::ios::out | std::ios::trunc | std::ios::binary);
+		if (!stream.is_open())
+		{
+			DEBUG_PRINT("Failed to open texture cache for writing: " + tempPath.string());
+			return false;
+		}
+
+		// The mips are laid out first so their file offsets can be written in front of the texels
+		std::vector<TextureMip> mips = texture.Mips;
+		uint64_t offset = sizeof(FileHeader) + mips.size() * sizeof(TextureMip);
+		for (TextureMip& mip : mips)
+		{
+			offset = AlignUp(offset, SectionAlignment);
+			mip.Offset = offset;
+			offset += mip.Size;
+		}
+
+		FileHeader header{};
+		header.Magic = Magic;
+		header.Version = Version;
+		header.SourceHash = sourceHash;
+		header.RequestedFormat = static_cast<uint32_t>(settings.Format);
+		header.Format = static_cast<uint32_t>(texture.Format);
+		header.Filter = static_cast<uint32_t>(settings.Filter);
+		header.Width = texture.Width;
+		header.Height = texture.Height;
+		header.NumMips = static_cast<uint32_t>(mips.size());
+		header.NumChannels = texture.NumChannels;
+		header.FileSize = offset;
+
+		stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		stream.write(reinterpret_cast<const char*>(mips.data()), mips.size() * sizeof(TextureMip));
+
+		static constexpr char padding[SectionAlignment] = {};
+		uint64_t writtenBytes = sizeof(FileHeader) + mips.size() * sizeof(TextureMip);
+		for (size_t mipIndex = 0; mipIndex < mips.size(); mipIndex++)
+		{
+			stream.write(padding, mips[mipIndex].Offset - writtenBytes);
+			stream.write(reinterpret_cast<const char*>(texture.GetTexels() + texture.Mips[mipIndex].Offset), mips[mipIndex].Size);
+			writtenBytes = mips[mipIndex].Offset + mips[mipIndex].Size;
+		}
+
+		if (!stream.good())
+		{
+			DEBUG_PRINT("Failed to write texture cache: " + tempPath.string());
+			return false;
+		}
+	}
+
+	std::filesystem::rename(tempPath, path, error);
+	if (error)
+	{
+		DEBUG_PRINT("Failed to move texture cache into place: " + cachePath);
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+
+	return true;
+}
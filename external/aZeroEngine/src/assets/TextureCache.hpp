@@ -0,0 +1,74 @@
+#pragma once
+#include <optional>
+#include "Texture.hpp"
+
+namespace aZero
+{
+	namespace Asset
+	{
+		/*
+		Cooked binary format for TextureData so that warm loads skip the decode, mip generation and compression.
+		The texels are never copied on load, the mips point straight into the mapped file and are uploaded from there.
+
+		Layout:
+			FileHeader
+			TextureMip for each mip
+			Texels of each mip (each section starts at a SectionAlignment boundary)
+
+		A cooked file is only considered valid if the magic, version, source hash and cook settings all match.
+		*/
+		namespace TextureCache
+		{
+			constexpr uint32_t Magic = 0x58545A61; // "aZTX"
+
+			// NOTE: Bump whenever the layout below, the mip filters or the block encoders change
+			constexpr uint32_t Version = 1;
+
+			constexpr uint32_t SectionAlignment = 16;
+
+			struct FileHeader
+			{
+				uint32_t Magic;
+				uint32_t Version;
+				uint64_t SourceHash;
+
+				// The format in the cook settings and the format that was written, which differ if the texture fell back to R8G8B8A8
+				uint32_t RequestedFormat;
+				uint32_t Format;
+
+				uint32_t Filter;
+				uint32_t Width;
+				uint32_t Height;
+				uint32_t NumMips;
+				uint32_t NumChannels;
+				uint32_t Padding;
+				uint64_t FileSize;
+			};
+
+			/** Returns the path of the cooked file for the source file and cook settings.
+			@param sourceFilePath
+			@param settings
+			@return std::string
+			*/
+			std::string GetCachePath(const std::string& sourceFilePath, const TextureCookSettings& settings);
+
+			/** Maps and validates the cooked file and returns the texture with its mips pointing into the mapped file.
+			* Returns an empty optional if the file doesn't exist or doesn't match the source hash, cook settings or version.
+			@param cachePath
+			@param sourceHash
+			@param settings
+			@return std::optional<TextureData>
+			*/
+			std::optional<TextureData> Load(const std::string& cachePath, uint64_t sourceHash, const TextureCookSettings& settings);
+
+			/** Writes the texture to the cooked file. The file is written to a temporary path and then renamed so a failed write never leaves a partial file.
+			@param cachePath
+			@param sourceHash
+			@param settings
+			@param texture
+			@return bool
+			*/
+			bool Save(const std::string& cachePath, uint64_t sourceHash, const TextureCookSettings& settings, const TextureData& texture);
+		}
+	}
+}
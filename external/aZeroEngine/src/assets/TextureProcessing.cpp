@@ -0,0 +1,1144 @@
+#include "TextureProcessing.hpp"
+#include <cmath>
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include "misc/JobSystem.hpp"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define AZERO_TEXTURE_SSE 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	using namespace aZero::Asset::TextureProcessing;
+
+	// Rows per job when filtering or compressing, small images run on the calling thread
+	constexpr uint32_t MinRowsPerJob = 16;
+	constexpr uint32_t MinBlockRowsPerJob = 4;
+
+	// The Kaiser filter reads KaiserRadius source texels on each side of the destination texel center
+	constexpr uint32_t KaiserRadius = 4;
+	constexpr uint32_t KaiserNumTaps = KaiserRadius * 2;
+	constexpr float KaiserAlpha = 4.f;
+
+	constexpr float Pi = 3.14159265358979f;
+
+	constexpr uint32_t SRGBEncodeBuckets = 4096;
+
+	// Interpolation weights of the 4-bit BC7 indices, out of 64
+	constexpr uint32_t BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// RGBA float image used between the mip levels so that the chain isn't requantized at every level
+	struct LinearImage
+	{
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		std::vector<float> Texels;
+
+		LinearImage(uint32_t width, uint32_t height)
+			:Width(width), Height(height), Texels(static_cast<size_t>(width) * height * 4) { }
+
+		float* GetRow(uint32_t y) { return Texels.data() + static_cast<size_t>(y) * Width * 4; }
+		const float* GetRow(uint32_t y) const { return Texels.data() + static_cast<size_t>(y) * Width * 4; }
+	};
+
+	float DecodeSRGB(float value)
+	{
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	struct ColorTables
+	{
+		float SRGBToLinear[256];
+
+		// Linear values halfway (in sRGB space) between two consecutive 8-bit codes, so encoding rounds to the nearest code
+		float LinearThresholds[255];
+
+		// Smallest code of the linear values in each bucket, encoding starts there and steps over the few remaining thresholds
+		uint8_t BucketCodes[SRGBEncodeBuckets];
+	};
+
+	const ColorTables& GetColorTables()
+	{
+		static const ColorTables tables = []()
+			{
+				ColorTables result;
+				for (uint32_t code = 0; code < 256; code++)
+				{
+					result.SRGBToLinear[code] = DecodeSRGB(code / 255.f);
+				}
+
+				for (uint32_t code = 0; code < 255; code++)
+				{
+					result.LinearThresholds[code] = DecodeSRGB((code + 0.5f) / 255.f);
+				}
+
+				for (uint32_t bucket = 0; bucket < SRGBEncodeBuckets; bucket++)
+				{
+					const float bucketStart = static_cast<float>(bucket) / SRGBEncodeBuckets;
+					result.BucketCodes[bucket] = static_cast<uint8_t>(std::upper_bound(result.LinearThresholds, result.LinearThresholds + 255, bucketStart) - result.LinearThresholds);
+				}
+				return result;
+			}();
+		return tables;
+	}
+
+	uint8_t EncodeSRGB(float linear)
+	{
+		const ColorTables& tables = GetColorTables();
+		const uint32_t bucket = static_cast<uint32_t>(std::clamp(linear * SRGBEncodeBuckets, 0.f, SRGBEncodeBuckets - 1.f));
+		uint32_t code = tables.BucketCodes[bucket];
+		while (code < 255 && tables.LinearThresholds[code] <= linear)
+		{
+			code++;
+		}
+		return static_cast<uint8_t>(code);
+	}
+
+	uint8_t EncodeUNorm(float value)
+	{
+		return static_cast<uint8_t>(std::clamp(value, 0.f, 1.f) * 255.f + 0.5f);
+	}
+
+	float BesselI0(float x)
+	{
+		// Power series, converges quickly for the small arguments used by the window
+		float sum = 1.f;
+		float term = 1.f;
+		const float halfSquared = x * x * 0.25f;
+		for (uint32_t k = 1; k < 32; k++)
+		{
+			term *= halfSquared / static_cast<float>(k * k);
+			sum += term;
+		}
+		return sum;
+	}
+
+	// Weights of the taps at source offsets -KaiserRadius + 1 ... KaiserRadius from the texel pair under the destination texel
+	const std::array<float, KaiserNumTaps>& GetKaiserWeights()
+	{
+		static const std::array<float, KaiserNumTaps> weights = []()
+			{
+				std::array<float, KaiserNumTaps> result;
+				const float windowWidth = KaiserRadius * 0.5f;
+				float sum = 0.f;
+				for (uint32_t tap = 0; tap < KaiserNumTaps; tap++)
+				{
+					// Distance from the destination texel center in destination texels
+					const float t = (static_cast<float>(tap) + 0.5f - static_cast<float>(KaiserRadius)) * 0.5f;
+					const float ratio = t / windowWidth;
+					const float window = BesselI0(KaiserAlpha * std::sqrt(std::max(0.f, 1.f - ratio * ratio))) / BesselI0(KaiserAlpha);
+					const float sinc = t == 0.f ? 1.f : std::sin(Pi * t) / (Pi * t);
+					result[tap] = window * sinc;
+					sum += result[tap];
+				}
+
+				for (float& weight : result)
+				{
+					weight /= sum;
+				}
+				return result;
+			}();
+		return weights;
+	}
+
+	LinearImage DecodeImage(const uint8_t* texels, uint32_t width, uint32_t height, bool sRGB)
+	{
+		LinearImage image(width, height);
+		const ColorTables& tables = GetColorTables();
+		aZero::Jobs::GetJobSystem().ParallelFor(height, MinRowsPerJob, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t y = begin; y < end; y++)
+				{
+					const uint8_t* source = texels + static_cast<size_t>(y) * width * 4;
+					float* destination = image.GetRow(y);
+					for (uint32_t channel = 0; channel < width * 4; channel++)
+					{
+						destination[channel] = (sRGB && channel % 4 != 3) ? tables.SRGBToLinear[source[channel]] : source[channel] / 255.f;
+					}
+				}
+			});
+		return image;
+	}
+
+	MipLevel EncodeImage(const LinearImage& image, bool sRGB)
+	{
+		MipLevel level;
+		level.Width = image.Width;
+		level.Height = image.Height;
+		level.Texels.resize(static_cast<size_t>(image.Width) * image.Height * 4);
+		aZero::Jobs::GetJobSystem().ParallelFor(image.Height, MinRowsPerJob, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t y = begin; y < end; y++)
+				{
+					const float* source = image.GetRow(y);
+					uint8_t* destination = level.Texels.data() + static_cast<size_t>(y) * image.Width * 4;
+					for (uint32_t channel = 0; channel < image.Width * 4; channel++)
+					{
+						destination[channel] = (sRGB && channel % 4 != 3) ? EncodeSRGB(source[channel]) : EncodeUNorm(source[channel]);
+					}
+				}
+			});
+		return level;
+	}
+
+	void DownsampleBox(const LinearImage& source, LinearImage& destination)
+	{
+		aZero::Jobs::GetJobSystem().ParallelFor(destination.Height, MinRowsPerJob, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t y = begin; y < end; y++)
+				{
+					// Clamped so that a dimension of 1 keeps its single row or column
+					const float* row0 = source.GetRow(std::min(y * 2, source.Height - 1));
+					const float* row1 = source.GetRow(std::min(y * 2 + 1, source.Height - 1));
+					float* output = destination.GetRow(y);
+					for (uint32_t x = 0; x < destination.Width; x++)
+					{
+						const uint32_t x0 = std::min(x * 2, source.Width - 1) * 4;
+						const uint32_t x1 = std::min(x * 2 + 1, source.Width - 1) * 4;
+#ifdef AZERO_TEXTURE_SSE
+						const __m128 sum = _mm_add_ps(
+							_mm_add_ps(_mm_loadu_ps(row0 + x0), _mm_loadu_ps(row0 + x1)),
+							_mm_add_ps(_mm_loadu_ps(row1 + x0), _mm_loadu_ps(row1 + x1)));
+						_mm_storeu_ps(output + x * 4, _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#else
+						for (uint32_t channel = 0; channel < 4; channel++)
+						{
+							output[x * 4 + channel] = (row0[x0 + channel] + row0[x1 + channel] + row1[x0 + channel] + row1[x1 + channel]) * 0.25f;
+						}
+#endif
+					}
+				}
+			});
+	}
+
+	void DownsampleKaiser(const LinearImage& source, LinearImage& destination)
+	{
+		const std::array<float, KaiserNumTaps>& weights = GetKaiserWeights();
+
+		// Horizontal pass into an image with the destination width and the source height
+		LinearImage horizontal(destination.Width, source.Height);
+		aZero::Jobs::GetJobSystem().ParallelFor(source.Height, MinRowsPerJob, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t y = begin; y < end; y++)
+				{
+					const float* input = source.GetRow(y);
+					float* output = horizontal.GetRow(y);
+					for (uint32_t x = 0; x < destination.Width; x++)
+					{
+						const int32_t firstTap = static_cast<int32_t>(x * 2 + 1) - static_cast<int32_t>(KaiserRadius);
+#ifdef AZERO_TEXTURE_SSE
+						__m128 sum = _mm_setzero_ps();
+						for (uint32_t tap = 0; tap < KaiserNumTaps; tap++)
+						{
+							const int32_t sourceX = std::clamp(firstTap + static_cast<int32_t>(tap), 0, static_cast<int32_t>(source.Width) - 1);
+							sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(input + sourceX * 4), _mm_set1_ps(weights[tap])));
+						}
+						_mm_storeu_ps(output + x * 4, sum);
+#else
+						float sum[4] = { 0.f, 0.f, 0.f, 0.f };
+						for (uint32_t tap = 0; tap < KaiserNumTaps; tap++)
+						{
+							const int32_t sourceX = std::clamp(firstTap + static_cast<int32_t>(tap), 0, static_cast<int32_t>(source.Width) - 1);
+							for (uint32_t channel = 0; channel < 4; channel++)
+							{
+								sum[channel] += input[sourceX * 4 + channel] * weights[tap];
+							}
+						}
+						memcpy(output + x * 4, sum, sizeof(sum));
+#endif
+					}
+				}
+			});
+
+		// Vertical pass, the negative lobes can overshoot so the result is clamped to keep the ringing from building up over the levels
+		aZero::Jobs::GetJobSystem().ParallelFor(destination.Height, MinRowsPerJob, [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t y = begin; y < end; y++)
+				{
+					const int32_t firstTap = static_cast<int32_t>(y * 2 + 1) - static_cast<int32_t>(KaiserRadius);
+					const float* rows[KaiserNumTaps];
+					for (uint32_t tap = 0; tap < KaiserNumTaps; tap++)
+					{
+						rows[tap] = horizontal.GetRow(std::clamp(firstTap + static_cast<int32_t>(tap), 0, static_cast<int32_t>(source.Height) - 1));
+					}
+
+					float* output = destination.GetRow(y);
+					const uint32_t numFloats = destination.Width * 4;
+#ifdef AZERO_TEXTURE_SSE
+					for (uint32_t index = 0; index < numFloats; index += 4)
+					{
+						__m128 sum = _mm_setzero_ps();
+						for (uint32_t tap = 0; tap < KaiserNumTaps; tap++)
+						{
+							sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(rows[tap] + index), _mm_set1_ps(weights[tap])));
+						}
+						_mm_storeu_ps(output + index, _mm_min_ps(_mm_max_ps(sum, _mm_setzero_ps()), _mm_set1_ps(1.f)));
+					}
+#else
+					for (uint32_t index = 0; index < numFloats; index++)
+					{
+						float sum = 0.f;
+						for (uint32_t tap = 0; tap < KaiserNumTaps; tap++)
+						{
+							sum += rows[tap][index] * weights[tap];
+						}
+						output[index] = std::clamp(sum, 0.f, 1.f);
+					}
+#endif
+				}
+			});
+	}
+
+	void FetchBlock(const uint8_t* texels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t block[16][4])
+	{
+		for (uint32_t y = 0; y < 4; y++)
+		{
+			const uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+			for (uint32_t x = 0; x < 4; x++)
+			{
+				const uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+				memcpy(block[y * 4 + x], texels + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+			}
+		}
+	}
+
+	void StoreBlock(const uint8_t block[16][4], uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t* texels)
+	{
+		for (uint32_t y = 0; y < 4 && blockY * 4 + y < height; y++)
+		{
+			for (uint32_t x = 0; x < 4 && blockX * 4 + x < width; x++)
+			{
+				memcpy(texels + (static_cast<size_t>(blockY * 4 + y) * width + blockX * 4 + x) * 4, block[y * 4 + x], 4);
+			}
+		}
+	}
+
+	/*
+	Principal axis of the block texels by power iteration, the endpoints of every encoder are placed along it.
+	The axis is zero if all texels are equal.
+	*/
+	template<uint32_t NumChannels>
+	void ComputePrincipalAxis(const float points[16][NumChannels], float mean[NumChannels], float axis[NumChannels])
+	{
+		for (uint32_t channel = 0; channel < NumChannels; channel++)
+		{
+			mean[channel] = 0.f;
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				mean[channel] += points[texel][channel];
+			}
+			mean[channel] /= 16.f;
+		}
+
+		float covariance[NumChannels][NumChannels] = {};
+		for (uint32_t texel = 0; texel < 16; texel++)
+		{
+			for (uint32_t row = 0; row < NumChannels; row++)
+			{
+				for (uint32_t column = 0; column < NumChannels; column++)
+				{
+					covariance[row][column] += (points[texel][row] - mean[row]) * (points[texel][column] - mean[column]);
+				}
+			}
+		}
+
+		// Starting from the row of the channel with the largest variance avoids starting orthogonal to the axis
+		uint32_t largestChannel = 0;
+		for (uint32_t channel = 1; channel < NumChannels; channel++)
+		{
+			if (covariance[channel][channel] > covariance[largestChannel][largestChannel])
+			{
+				largestChannel = channel;
+			}
+		}
+
+		for (uint32_t channel = 0; channel < NumChannels; channel++)
+		{
+			axis[channel] = covariance[largestChannel][channel];
+		}
+
+		for (uint32_t iteration = 0; iteration < 8; iteration++)
+		{
+			float next[NumChannels] = {};
+			float largest = 0.f;
+			for (uint32_t row = 0; row < NumChannels; row++)
+			{
+				for (uint32_t column = 0; column < NumChannels; column++)
+				{
+					next[row] += covariance[row][column] * axis[column];
+				}
+				largest = std::max(largest, std::abs(next[row]));
+			}
+
+			if (largest < 1e-6f)
+			{
+				std::fill(axis, axis + NumChannels, 0.f);
+				return;
+			}
+
+			for (uint32_t channel = 0; channel < NumChannels; channel++)
+			{
+				axis[channel] = next[channel] / largest;
+			}
+		}
+
+		float length = 0.f;
+		for (uint32_t channel = 0; channel < NumChannels; channel++)
+		{
+			length += axis[channel] * axis[channel];
+		}
+		length = std::sqrt(length);
+		for (uint32_t channel = 0; channel < NumChannels; channel++)
+		{
+			axis[channel] /= length;
+		}
+	}
+
+	// Places the endpoints at the extreme projections of the texels onto the principal axis
+	template<uint32_t NumChannels>
+	void ComputeAxisEndpoints(const float points[16][NumChannels], float start[NumChannels], float end[NumChannels])
+	{
+		float mean[NumChannels];
+		float axis[NumChannels];
+		ComputePrincipalAxis<NumChannels>(points, mean, axis);
+
+		float minProjection = std::numeric_limits<float>::max();
+		float maxProjection = std::numeric_limits<float>::lowest();
+		for (uint32_t texel = 0; texel < 16; texel++)
+		{
+			float projection = 0.f;
+			for (uint32_t channel = 0; channel < NumChannels; channel++)
+			{
+				projection += (points[texel][channel] - mean[channel]) * axis[channel];
+			}
+			minProjection = std::min(minProjection, projection);
+			maxProjection = std::max(maxProjection, projection);
+		}
+
+		for (uint32_t channel = 0; channel < NumChannels; channel++)
+		{
+			start[channel] = std::clamp(mean[channel] + axis[channel] * maxProjection, 0.f, 255.f);
+			end[channel] = std::clamp(mean[channel] + axis[channel] * minProjection, 0.f, 255.f);
+		}
+	}
+
+	/*
+	Least squares fit of the endpoints for fixed indices, where weights[texel] is how far the texel is from start towards end.
+	Returns false if the system is degenerate (ex. all texels use the same index).
+	*/
+	template<uint32_t NumChannels>
+	bool SolveEndpoints(const float points[16][NumChannels], const float weights[16], float start[NumChannels], float end[NumChannels])
+	{
+		float a = 0.f, b = 0.f, c = 0.f;
+		float x[NumChannels] = {};
+		float y[NumChannels] = {};
+		for (uint32_t texel = 0; texel < 16; texel++)
+		{
+			const float w = weights[texel];
+			a += (1.f - w) * (1.f - w);
+			b += (1.f - w) * w;
+			c += w * w;
+			for (uint32_t channel = 0; channel < NumChannels; channel++)
+			{
+				x[channel] += (1.f - w) * points[texel][channel];
+				y[channel] += w * points[texel][channel];
+			}
+		}
+
+		const float determinant = a * c - b * b;
+		if (std::abs(determinant) < 1e-6f)
+		{
+			return false;
+		}
+
+		for (uint32_t channel = 0; channel < NumChannels; channel++)
+		{
+			start[channel] = std::clamp((c * x[channel] - b * y[channel]) / determinant, 0.f, 255.f);
+			end[channel] = std::clamp((a * y[channel] - b * x[channel]) / determinant, 0.f, 255.f);
+		}
+		return true;
+	}
+
+	uint16_t PackRGB565(const float color[3])
+	{
+		const uint32_t r = static_cast<uint32_t>(std::clamp(color[0] * 31.f / 255.f + 0.5f, 0.f, 31.f));
+		const uint32_t g = static_cast<uint32_t>(std::clamp(color[1] * 63.f / 255.f + 0.5f, 0.f, 63.f));
+		const uint32_t b = static_cast<uint32_t>(std::clamp(color[2] * 31.f / 255.f + 0.5f, 0.f, 31.f));
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	void UnpackRGB565(uint16_t color, int32_t output[3])
+	{
+		const int32_t r = color >> 11;
+		const int32_t g = (color >> 5) & 63;
+		const int32_t b = color & 31;
+		output[0] = (r << 3) | (r >> 2);
+		output[1] = (g << 2) | (g >> 4);
+		output[2] = (b << 3) | (b >> 2);
+	}
+
+	// 4-color palette of a BC1 color block, the 3-color mode is only used by the decoder
+	void GetBC1Palette(uint16_t color0, uint16_t color1, int32_t palette[4][3])
+	{
+		UnpackRGB565(color0, palette[0]);
+		UnpackRGB565(color1, palette[1]);
+		for (uint32_t channel = 0; channel < 3; channel++)
+		{
+			palette[2][channel] = (2 * palette[0][channel] + palette[1][channel]) / 3;
+			palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel]) / 3;
+		}
+	}
+
+	// Picks the nearest palette entry for every texel and returns the squared error
+	uint32_t SelectBC1Indices(uint16_t color0, uint16_t color1, const uint8_t block[16][4], uint8_t indices[16])
+	{
+		int32_t palette[4][3];
+		GetBC1Palette(color0, color1, palette);
+
+		uint32_t totalError = 0;
+		for (uint32_t texel = 0; texel < 16; texel++)
+		{
+			uint32_t bestError = std::numeric_limits<uint32_t>::max();
+			for (uint8_t entry = 0; entry < 4; entry++)
+			{
+				uint32_t error = 0;
+				for (uint32_t channel = 0; channel < 3; channel++)
+				{
+					const int32_t difference = palette[entry][channel] - block[texel][channel];
+					error += difference * difference;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					indices[texel] = entry;
+				}
+			}
+			totalError += bestError;
+		}
+		return totalError;
+	}
+
+	void EncodeBC1Color(const uint8_t block[16][4], uint8_t* output)
+	{
+		float points[16][3];
+		for (uint32_t texel = 0; texel < 16; texel++)
+		{
+			for (uint32_t channel = 0; channel < 3; channel++)
+			{
+				points[texel][channel] = block[texel][channel];
+			}
+		}
+
+		float start[3];
+		float end[3];
+		ComputeAxisEndpoints<3>(points, start, end);
+
+		uint16_t bestColor0 = 0;
+		uint16_t bestColor1 = 0;
+		uint8_t bestIndices[16] = {};
+		uint32_t bestError = std::numeric_limits<uint32_t>::max();
+
+		// Refits the endpoints to the chosen indices a couple of times and keeps the best quantized result
+		static constexpr float indexWeights[4] = { 0.f, 1.f, 1.f / 3.f, 2.f / 3.f };
+		for (uint32_t iteration = 0; iteration < 3; iteration++)
+		{
+			uint16_t color0 = PackRGB565(start);
+			uint16_t color1 = PackRGB565(end);
+			if (color0 < color1)
+			{
+				std::swap(color0, color1);
+			}
+
+			uint8_t indices[16];
+			const uint32_t error = SelectBC1Indices(color0, color1, block, indices);
+			if (error < bestError)
+			{
+				bestError = error;
+				bestColor0 = color0;
+				bestColor1 = color1;
+				memcpy(bestIndices, indices, sizeof(indices));
+			}
+
+			if (bestError == 0 || color0 == color1)
+			{
+				break;
+			}
+
+			float weights[16];
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				weights[texel] = indexWeights[indices[texel]];
+			}
+
+			if (!SolveEndpoints<3>(points, weights, start, end))
+			{
+				break;
+			}
+		}
+
+		// Equal endpoints select the 3-color mode, where index 0 still decodes to the endpoint
+		uint32_t packedIndices = 0;
+		if (bestColor0 != bestColor1)
+		{
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				packedIndices |= static_cast<uint32_t>(bestIndices[texel]) << (texel * 2);
+			}
+		}
+
+		memcpy(output, &bestColor0, sizeof(uint16_t));
+		memcpy(output + 2, &bestColor1, sizeof(uint16_t));
+		memcpy(output + 4, &packedIndices, sizeof(uint32_t));
+	}
+
+	void GetBC4Palette(uint8_t endpoint0, uint8_t endpoint1, int32_t palette[8])
+	{
+		palette[0] = endpoint0;
+		palette[1] = endpoint1;
+		if (endpoint0 > endpoint1)
+		{
+			for (int32_t entry = 2; entry < 8; entry++)
+			{
+				palette[entry] = ((8 - entry) * endpoint0 + (entry - 1) * endpoint1 + 3) / 7;
+			}
+		}
+		else
+		{
+			for (int32_t entry = 2; entry < 6; entry++)
+			{
+				palette[entry] = ((6 - entry) * endpoint0 + (entry - 1) * endpoint1 + 2) / 5;
+			}
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+	}
+
+	void EncodeBC4(const uint8_t values[16], uint8_t* output)
+	{
+		uint8_t minValue = 255;
+		uint8_t maxValue = 0;
+		for (uint32_t texel = 0; texel < 16; texel++)
+		{
+			minValue = std::min(minValue, values[texel]);
+			maxValue = std::max(maxValue, values[texel]);
+		}
+
+		// The 8 value mode, endpoint 0 has to be the larger one
+		output[0] = maxValue;
+		output[1] = minValue;
+		uint64_t packedIndices = 0;
+		if (maxValue != minValue)
+		{
+			int32_t palette[8];
+			GetBC4Palette(maxValue, minValue, palette);
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				uint64_t bestEntry = 0;
+				int32_t bestError = std::numeric_limits<int32_t>::max();
+				for (uint32_t entry = 0; entry < 8; entry++)
+				{
+					const int32_t error = std::abs(palette[entry] - values[texel]);
+					if (error < bestError)
+					{
+						bestError = error;
+						bestEntry = entry;
+					}
+				}
+				packedIndices |= bestEntry << (texel * 3);
+			}
+		}
+
+		memcpy(output + 2, &packedIndices, 6);
+	}
+
+	void DecodeBC4(const uint8_t* input, uint8_t values[16])
+	{
+		int32_t palette[8];
+		GetBC4Palette(input[0], input[1], palette);
+
+		uint64_t packedIndices = 0;
+		memcpy(&packedIndices, input + 2, 6);
+		for (uint32_t texel = 0; texel < 16; texel++)
+		{
+			values[texel] = static_cast<uint8_t>(palette[(packedIndices >> (texel * 3)) & 7]);
+		}
+	}
+
+	class BlockBitWriter
+	{
+	public:
+		void Write(uint32_t value, uint32_t numBits)
+		{
+			for (uint32_t bit = 0; bit < numBits; bit++, m_Position++)
+			{
+				if ((value >> bit) & 1)
+				{
+					m_Bits[m_Position / 64] |= 1ull << (m_Position % 64);
+				}
+			}
+		}
+
+		void CopyTo(uint8_t* output) const { memcpy(output, m_Bits, sizeof(m_Bits)); }
+
+	private:
+		uint64_t m_Bits[2] = { 0, 0 };
+		uint32_t m_Position = 0;
+	};
+
+	class BlockBitReader
+	{
+	public:
+		BlockBitReader(const uint8_t* input) { memcpy(m_Bits, input, sizeof(m_Bits)); }
+
+		uint32_t Read(uint32_t numBits)
+		{
+			uint32_t value = 0;
+			for (uint32_t bit = 0; bit < numBits; bit++, m_Position++)
+			{
+				value |= static_cast<uint32_t>((m_Bits[m_Position / 64] >> (m_Position % 64)) & 1) << bit;
+			}
+			return value;
+		}
+
+	private:
+		uint64_t m_Bits[2];
+		uint32_t m_Position = 0;
+	};
+
+	// Quantizes an endpoint to 7 bits per channel plus the shared bit that gives the smallest error
+	void QuantizeBC7Endpoint(const float endpoint[4], uint8_t quantized[4], uint32_t& sharedBit)
+	{
+		float bestError = std::numeric_limits<float>::max();
+		for (uint32_t candidateBit = 0; candidateBit < 2; candidateBit++)
+		{
+			uint8_t candidate[4];
+			float error = 0.f;
+			for (uint32_t channel = 0; channel < 4; channel++)
+			{
+				candidate[channel] = static_cast<uint8_t>(std::clamp((endpoint[channel] - candidateBit) * 0.5f + 0.5f, 0.f, 127.f));
+				const float difference = static_cast<float>((candidate[channel] << 1) | candidateBit) - endpoint[channel];
+				error += difference * difference;
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				sharedBit = candidateBit;
+				memcpy(quantized, candidate, sizeof(candidate));
+			}
+		}
+	}
+
+	// Picks the 4-bit index of every texel by projecting it onto the endpoint line and checking the neighbouring indices
+	uint32_t SelectBC7Indices(const int32_t start[4], const int32_t end[4], const uint8_t block[16][4], uint8_t indices[16])
+	{
+		int32_t palette[16][4];
+		for (uint32_t entry = 0; entry < 16; entry++)
+		{
+			for (uint32_t channel = 0; channel < 4; channel++)
+			{
+				palette[entry][channel] = ((64 - BC7Weights[entry]) * start[channel] + BC7Weights[entry] * end[channel] + 32) >> 6;
+			}
+		}
+
+		int32_t direction[4];
+		int32_t lengthSquared = 0;
+		for (uint32_t channel = 0; channel < 4; channel++)
+		{
+			direction[channel] = end[channel] - start[channel];
+			lengthSquared += direction[channel] * direction[channel];
+		}
+
+		uint32_t totalError = 0;
+		for (uint32_t texel = 0; texel < 16; texel++)
+		{
+			int32_t estimate = 0;
+			if (lengthSquared > 0)
+			{
+				int32_t projection = 0;
+				for (uint32_t channel = 0; channel < 4; channel++)
+				{
+					projection += (block[texel][channel] - start[channel]) * direction[channel];
+				}
+				estimate = std::clamp(static_cast<int32_t>(static_cast<float>(projection) / lengthSquared * 15.f + 0.5f), 0, 15);
+			}
+
+			uint32_t bestError = std::numeric_limits<uint32_t>::max();
+			for (int32_t entry = std::max(estimate - 1, 0); entry <= std::min(estimate + 1, 15); entry++)
+			{
+				uint32_t error = 0;
+				for (uint32_t channel = 0; channel < 4; channel++)
+				{
+					const int32_t difference = palette[entry][channel] - block[texel][channel];
+					error += difference * difference;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					indices[texel] = static_cast<uint8_t>(entry);
+				}
+			}
+			totalError += bestError;
+		}
+		return totalError;
+	}
+
+	void EncodeBC7Mode6(const uint8_t block[16][4], uint8_t* output)
+	{
+		float points[16][4];
+		for (uint32_t texel = 0; texel < 16; texel++)
+		{
+			for (uint32_t channel = 0; channel < 4; channel++)
+			{
+				points[texel][channel] = block[texel][channel];
+			}
+		}
+
+		float start[4];
+		float end[4];
+		ComputeAxisEndpoints<4>(points, start, end);
+
+		uint8_t bestQuantized[2][4] = {};
+		uint32_t bestSharedBits[2] = {};
+		uint8_t bestIndices[16] = {};
+		uint32_t bestError = std::numeric_limits<uint32_t>::max();
+		for (uint32_t iteration = 0; iteration < 3; iteration++)
+		{
+			uint8_t quantized[2][4];
+			uint32_t sharedBits[2];
+			QuantizeBC7Endpoint(start, quantized[0], sharedBits[0]);
+			QuantizeBC7Endpoint(end, quantized[1], sharedBits[1]);
+
+			int32_t expanded[2][4];
+			for (uint32_t endpoint = 0; endpoint < 2; endpoint++)
+			{
+				for (uint32_t channel = 0; channel < 4; channel++)
+				{
+					expanded[endpoint][channel] = (quantized[endpoint][channel] << 1) | sharedBits[endpoint];
+				}
+			}
+
+			uint8_t indices[16];
+			const uint32_t error = SelectBC7Indices(expanded[0], expanded[1], block, indices);
+			if (error < bestError)
+			{
+				bestError = error;
+				memcpy(bestQuantized, quantized, sizeof(quantized));
+				memcpy(bestSharedBits, sharedBits, sizeof(sharedBits));
+				memcpy(bestIndices, indices, sizeof(indices));
+			}
+
+			if (bestError == 0)
+			{
+				break;
+			}
+
+			float weights[16];
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				weights[texel] = BC7Weights[indices[texel]] / 64.f;
+			}
+
+			if (!SolveEndpoints<4>(points, weights, start, end))
+			{
+				break;
+			}
+		}
+
+		// The most significant bit of the first index is implied to be zero, the weights are symmetric so swapping the endpoints and mirroring the indices decodes the same
+		if (bestIndices[0] & 8)
+		{
+			std::swap(bestQuantized[0], bestQuantized[1]);
+			std::swap(bestSharedBits[0], bestSharedBits[1]);
+			for (uint8_t& index : bestIndices)
+			{
+				index = 15 - index;
+			}
+		}
+
+		BlockBitWriter writer;
+		writer.Write(1 << 6, 7);
+		for (uint32_t channel = 0; channel < 4; channel++)
+		{
+			writer.Write(bestQuantized[0][channel], 7);
+			writer.Write(bestQuantized[1][channel], 7);
+		}
+		writer.Write(bestSharedBits[0], 1);
+		writer.Write(bestSharedBits[1], 1);
+		writer.Write(bestIndices[0], 3);
+		for (uint32_t texel = 1; texel < 16; texel++)
+		{
+			writer.Write(bestIndices[texel], 4);
+		}
+		writer.CopyTo(output);
+	}
+
+	void DecodeBC7Mode6(const uint8_t* input, uint8_t block[16][4])
+	{
+		BlockBitReader reader(input);
+		if (reader.Read(7) != (1 << 6))
+		{
+			// Only mode 6 is written by the encoder
+			memset(block, 0, 16 * 4);
+			return;
+		}
+
+		int32_t endpoints[2][4];
+		for (uint32_t channel = 0; channel < 4; channel++)
+		{
+			endpoints[0][channel] = reader.Read(7) << 1;
+			endpoints[1][channel] = reader.Read(7) << 1;
+		}
+
+		const uint32_t sharedBit0 = reader.Read(1);
+		const uint32_t sharedBit1 = reader.Read(1);
+		for (uint32_t channel = 0; channel < 4; channel++)
+		{
+			endpoints[0][channel] |= sharedBit0;
+			endpoints[1][channel] |= sharedBit1;
+		}
+
+		for (uint32_t texel = 0; texel < 16; texel++)
+		{
+			const uint32_t weight = BC7Weights[reader.Read(texel == 0 ? 3 : 4)];
+			for (uint32_t channel = 0; channel < 4; channel++)
+			{
+				block[texel][channel] = static_cast<uint8_t>(((64 - weight) * endpoints[0][channel] + weight * endpoints[1][channel] + 32) >> 6);
+			}
+		}
+	}
+
+	void DecodeBC1Color(const uint8_t* input, uint8_t block[16][4], bool alwaysFourColors)
+	{
+		uint16_t color0;
+		uint16_t color1;
+		uint32_t packedIndices;
+		memcpy(&color0, input, sizeof(uint16_t));
+		memcpy(&color1, input + 2, sizeof(uint16_t));
+		memcpy(&packedIndices, input + 4, sizeof(uint32_t));
+
+		int32_t palette[4][4];
+		UnpackRGB565(color0, palette[0]);
+		UnpackRGB565(color1, palette[1]);
+		palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+		for (uint32_t channel = 0; channel < 3; channel++)
+		{
+			if (color0 > color1 || alwaysFourColors)
+			{
+				palette[2][channel] = (2 * palette[0][channel] + palette[1][channel]) / 3;
+				palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel]) / 3;
+			}
+			else
+			{
+				palette[2][channel] = (palette[0][channel] + palette[1][channel]) / 2;
+				palette[3][channel] = 0;
+			}
+		}
+
+		if (color0 <= color1 && !alwaysFourColors)
+		{
+			palette[3][3] = 0;
+		}
+
+		for (uint32_t texel = 0; texel < 16; texel++)
+		{
+			const uint32_t entry = (packedIndices >> (texel * 2)) & 3;
+			for (uint32_t channel = 0; channel < 4; channel++)
+			{
+				block[texel][channel] = static_cast<uint8_t>(palette[entry][channel]);
+			}
+		}
+	}
+
+	void EncodeBlock(const uint8_t block[16][4], BlockFormat format, uint8_t* output)
+	{
+		switch (format)
+		{
+		case BlockFormat::BC1:
+		{
+			EncodeBC1Color(block, output);
+			break;
+		}
+		case BlockFormat::BC3:
+		{
+			uint8_t alpha[16];
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				alpha[texel] = block[texel][3];
+			}
+			EncodeBC4(alpha, output);
+			EncodeBC1Color(block, output + 8);
+			break;
+		}
+		case BlockFormat::BC5:
+		{
+			uint8_t channels[2][16];
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				channels[0][texel] = block[texel][0];
+				channels[1][texel] = block[texel][1];
+			}
+			EncodeBC4(channels[0], output);
+			EncodeBC4(channels[1], output + 8);
+			break;
+		}
+		case BlockFormat::BC7:
+		{
+			EncodeBC7Mode6(block, output);
+			break;
+		}
+		}
+	}
+
+	void DecodeBlock(const uint8_t* input, BlockFormat format, uint8_t block[16][4])
+	{
+		switch (format)
+		{
+		case BlockFormat::BC1:
+		{
+			DecodeBC1Color(input, block, false);
+			break;
+		}
+		case BlockFormat::BC3:
+		{
+			uint8_t alpha[16];
+			DecodeBC4(input, alpha);
+			DecodeBC1Color(input + 8, block, true);
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				block[texel][3] = alpha[texel];
+			}
+			break;
+		}
+		case BlockFormat::BC5:
+		{
+			uint8_t channels[2][16];
+			DecodeBC4(input, channels[0]);
+			DecodeBC4(input + 8, channels[1]);
+			for (uint32_t texel = 0; texel < 16; texel++)
+			{
+				block[texel][0] = channels[0][texel];
+				block[texel][1] = channels[1][texel];
+				block[texel][2] = 0;
+				block[texel][3] = 255;
+			}
+			break;
+		}
+		case BlockFormat::BC7:
+		{
+			DecodeBC7Mode6(input, block);
+			break;
+		}
+		}
+	}
+}
+
+uint32_t aZero::Asset::TextureProcessing::GetNumMipLevels(uint32_t width, uint32_t height)
+{
+	uint32_t numLevels = 1;
+	while (width > 1 || height > 1)
+	{
+		width = std::max(width / 2, 1u);
+		height = std::max(height / 2, 1u);
+		numLevels++;
+	}
+	return numLevels;
+}
+
+std::vector<aZero::Asset::TextureProcessing::MipLevel> aZero::Asset::TextureProcessing::GenerateMipChain(const uint8_t* texels, uint32_t width, uint32_t height, MipFilter filter, bool sRGB)
+{
+	std::vector<MipLevel> levels;
+	levels.reserve(GetNumMipLevels(width, height) - 1);
+
+	LinearImage current = DecodeImage(texels, width, height, sRGB);
+	while (current.Width > 1 || current.Height > 1)
+	{
+		LinearImage next(std::max(current.Width / 2, 1u), std::max(current.Height / 2, 1u));
+		if (filter == MipFilter::Kaiser)
+		{
+			DownsampleKaiser(current, next);
+		}
+		else
+		{
+			DownsampleBox(current, next);
+		}
+
+		levels.push_back(EncodeImage(next, sRGB));
+		current = std::move(next);
+	}
+
+	return levels;
+}
+
+uint32_t aZero::Asset::TextureProcessing::GetBlockSize(BlockFormat format)
+{
+	return format == BlockFormat::BC1 ? 8 : 16;
+}
+
+uint64_t aZero::Asset::TextureProcessing::GetCompressedSize(uint32_t width, uint32_t height, BlockFormat format)
+{
+	return static_cast<uint64_t>((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(format);
+}
+
+void aZero::Asset::TextureProcessing::CompressImage(const uint8_t* texels, uint32_t width, uint32_t height, BlockFormat format, uint8_t* output)
+{
+	const uint32_t numBlocksX = (width + 3) / 4;
+	const uint32_t numBlocksY = (height + 3) / 4;
+	const uint32_t blockSize = GetBlockSize(format);
+	Jobs::GetJobSystem().ParallelFor(numBlocksY, MinBlockRowsPerJob, [&](uint32_t begin, uint32_t end)
+		{
+			uint8_t block[16][4];
+			for (uint32_t blockY = begin; blockY < end; blockY++)
+			{
+				for (uint32_t blockX = 0; blockX < numBlocksX; blockX++)
+				{
+					FetchBlock(texels, width, height, blockX, blockY, block);
+					EncodeBlock(block, format, output + (static_cast<size_t>(blockY) * numBlocksX + blockX) * blockSize);
+				}
+			}
+		});
+}
+
+void aZero::Asset::TextureProcessing::DecompressImage(const uint8_t* blocks, uint32_t width, uint32_t height, BlockFormat format, uint8_t* texels)
+{
+	const uint32_t numBlocksX = (width + 3) / 4;
+	const uint32_t numBlocksY = (height + 3) / 4;
+	const uint32_t blockSize = GetBlockSize(format);
+	uint8_t block[16][4];
+	for (uint32_t blockY = 0; blockY < numBlocksY; blockY++)
+	{
+		for (uint32_t blockX = 0; blockX < numBlocksX; blockX++)
+		{
+			DecodeBlock(blocks + (static_cast<size_t>(blockY) * numBlocksX + blockX) * blockSize, format, block);
+			StoreBlock(block, width, height, blockX, blockY, texels);
+		}
+	}
+}
+
+double aZero::Asset::TextureProcessing::ComputePSNR(const uint8_t* reference, const uint8_t* texels, uint32_t width, uint32_t height, uint32_t numChannels)
+{
+	uint64_t squaredError = 0;
+	const size_t numTexels = static_cast<size_t>(width) * height;
+	for (size_t texel = 0; texel < numTexels; texel++)
+	{
+		for (uint32_t channel = 0; channel < numChannels; channel++)
+		{
+			const int32_t difference = static_cast<int32_t>(reference[texel * 4 + channel]) - texels[texel * 4 + channel];
+			squaredError += difference * difference;
+		}
+	}
+
+	if (squaredError == 0)
+	{
+		return std::numeric_limits<double>::infinity();
+	}
+
+	const double meanSquaredError = static_cast<double>(squaredError) / (static_cast<double>(numTexels) * numChannels);
+	return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+namespace aZero
+{
+	namespace Asset
+	{
+		/*
+		CPU side texture processing used when cooking textures.
+		All images are tightly packed RGBA8.
+		*/
+		namespace TextureProcessing
+		{
+			enum class MipFilter : uint32_t
+			{
+				// 2x2 average, fastest
+				Box,
+
+				// Separable Kaiser windowed sinc over 8x8 source texels, keeps more detail in the smaller mips
+				Kaiser
+			};
+
+			enum class BlockFormat : uint32_t
+			{
+				// RGB, 565 endpoints and 2-bit indices. Always opaque.
+				BC1,
+
+				// BC1 color with a separate BC4 alpha block
+				BC3,
+
+				// Two BC4 blocks for the red and green channels, ex. tangent space normal maps
+				BC5,
+
+				// RGBA with 7-bit endpoints plus shared bit and 4-bit indices. Only mode 6 is encoded.
+				BC7
+			};
+
+			struct MipLevel
+			{
+				uint32_t Width = 0;
+				uint32_t Height = 0;
+				std::vector<uint8_t> Texels;
+			};
+
+			/** Returns the number of mips in a full chain down to 1x1, including the top level
+			@param width
+			@param height
+			@return uint32_t
+			*/
+			uint32_t GetNumMipLevels(uint32_t width, uint32_t height);
+
+			/** Generates every mip below the input image, so the first returned level is half the input size.
+			* Filtering is done in linear space. If sRGB is set the color channels are decoded before and encoded after filtering, alpha is always linear.
+			@param texels
+			@param width
+			@param height
+			@param filter
+			@param sRGB
+			@return std::vector<MipLevel>
+			*/
+			std::vector<MipLevel> GenerateMipChain(const uint8_t* texels, uint32_t width, uint32_t height, MipFilter filter, bool sRGB);
+
+			/** Returns the number of bytes of one 4x4 block
+			@param format
+			@return uint32_t
+			*/
+			uint32_t GetBlockSize(BlockFormat format);
+
+			uint64_t GetCompressedSize(uint32_t width, uint32_t height, BlockFormat format);
+
+			/** Compresses the image into GetCompressedSize() bytes of blocks, rows of blocks are compressed in parallel on the job system.
+			* Blocks that extend past the image edge repeat the edge texels.
+			@param texels
+			@param width
+			@param height
+			@param format
+			@param output
+			@return void
+			*/
+			void CompressImage(const uint8_t* texels, uint32_t width, uint32_t height, BlockFormat format, uint8_t* output);
+
+			/** Decompresses blocks written by CompressImage(). Used to measure the compression quality.
+			@param blocks
+			@param width
+			@param height
+			@param format
+			@param texels
+			@return void
+			*/
+			void DecompressImage(const uint8_t* blocks, uint32_t width, uint32_t height, BlockFormat format, uint8_t* texels);
+
+			/** Returns the peak signal-to-noise ratio in dB over the first numChannels channels of every texel, infinity for identical images
+			@param reference
+			@param texels
+			@param width
+			@param height
+			@param numChannels
+			@return double
+			*/
+			double ComputePSNR(const uint8_t* reference, const uint8_t* texels, uint32_t width, uint32_t height, uint32_t numChannels);
+		}
+	}
+}
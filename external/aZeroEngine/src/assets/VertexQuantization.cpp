@@ -0,0 +1,223 @@
+#include "VertexQuantization.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+#include "misc/Profiler.hpp"
+
+namespace
+{
+	constexpr float SnormScale = 32767.f;
+
+	int16_t EncodeSnorm16(float value)
+	{
+		return static_cast<int16_t>(std::lround(std::clamp(value, -1.f, 1.f) * SnormScale));
+	}
+
+	float DecodeSnorm16(int16_t value)
+	{
+		return std::max(static_cast<float>(value) / SnormScale, -1.f);
+	}
+
+	uint32_t PackSnorm16x2(int16_t x, int16_t y)
+	{
+		return static_cast<uint32_t>(static_cast<uint16_t>(x)) | (static_cast<uint32_t>(static_cast<uint16_t>(y)) << 16);
+	}
+
+	// atan2 instead of acos since acos of a float dot product can't resolve angles below a few hundredths of a degree
+	float ComputeAngleDegrees(const DXM::Vector3& a, const DXM::Vector3& b)
+	{
+		return std::atan2(a.Cross(b).Length(), a.Dot(b)) * (180.f / DirectX::XM_PI);
+	}
+}
+
+uint16_t aZero::Asset::VertexQuantization::EncodeHalf(float value)
+{
+	const uint32_t bits = std::bit_cast<uint32_t>(value);
+	const uint32_t sign = (bits >> 16) & 0x8000;
+	const uint32_t exponentMantissa = bits & 0x7FFFFFFF;
+
+	// Rebias the exponent from 127 to 15 and round the mantissa to nearest
+	uint32_t half = (exponentMantissa - (112u << 23) + (1u << 12)) >> 13;
+
+	// Too small for a normal half flushes to zero, too large becomes infinity and NaN stays NaN
+	half = exponentMantissa < (113u << 23) ? 0 : half;
+	half = exponentMantissa >= (143u << 23) ? 0x7C00 : half;
+	half = exponentMantissa > (255u << 23) ? 0x7E00 : half;
+	return static_cast<uint16_t>(sign | half);
+}
+
+float aZero::Asset::VertexQuantization::DecodeHalf(uint16_t value)
+{
+	const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+	const uint32_t exponentMantissa = value & 0x7FFF;
+
+	if (exponentMantissa < (1u << 10))
+	{
+		// Denormals are never written by EncodeHalf() but are decoded like f16tof32 does
+		const float magnitude = std::ldexp(static_cast<float>(exponentMantissa), -24);
+		return sign ? -magnitude : magnitude;
+	}
+
+	// Rebias the exponent from 15 to 127, infinity and NaN need the exponent rebiased all the way to 255
+	uint32_t bits = (exponentMantissa + (112u << 10)) << 13;
+	bits += exponentMantissa >= (31u << 10) ? (112u << 23) : 0;
+	return std::bit_cast<float>(sign | bits);
+}
+
+uint32_t aZero::Asset::VertexQuantization::EncodeOctahedral(const DXM::Vector3& direction)
+{
+	const float sum = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+	if (sum == 0.f)
+	{
+		return 0;
+	}
+
+	float u = direction.x / sum;
+	float v = direction.y / sum;
+	if (direction.z < 0.f)
+	{
+		// Fold the lower hemisphere over the diagonals
+		const float foldedU = (1.f - std::abs(v)) * (u >= 0.f ? 1.f : -1.f);
+		const float foldedV = (1.f - std::abs(u)) * (v >= 0.f ? 1.f : -1.f);
+		u = foldedU;
+		v = foldedV;
+	}
+
+	const float scaledU = std::clamp(u, -1.f, 1.f) * SnormScale;
+	const float scaledV = std::clamp(v, -1.f, 1.f) * SnormScale;
+
+	uint32_t best = 0;
+	float bestDot = -2.f;
+	const DXM::Vector3 normalized = direction / direction.Length();
+	for (const float encodedU : { std::floor(scaledU), std::ceil(scaledU) })
+	{
+		for (const float encodedV : { std::floor(scaledV), std::ceil(scaledV) })
+		{
+			const uint32_t encoded = PackSnorm16x2(static_cast<int16_t>(encodedU), static_cast<int16_t>(encodedV));
+			const float dot = DecodeOctahedral(encoded).Dot(normalized);
+			if (dot > bestDot)
+			{
+				bestDot = dot;
+				best = encoded;
+			}
+		}
+	}
+
+	return best;
+}
+
+DXM::Vector3 aZero::Asset::VertexQuantization::DecodeOctahedral(uint32_t encoded)
+{
+	DXM::Vector3 direction;
+	direction.x = DecodeSnorm16(static_cast<int16_t>(encoded & 0xFFFF));
+	direction.y = DecodeSnorm16(static_cast<int16_t>(encoded >> 16));
+	direction.z = 1.f - std::abs(direction.x) - std::abs(direction.y);
+
+	const float fold = std::clamp(-direction.z, 0.f, 1.f);
+	direction.x += direction.x >= 0.f ? -fold : fold;
+	direction.y += direction.y >= 0.f ? -fold : fold;
+	direction.Normalize();
+	return direction;
+}
+
+aZero::Asset::QuantizedVertexPosition aZero::Asset::VertexQuantization::EncodePosition(const VertexPosition& position, const DirectX::BoundingSphere& bounds)
+{
+	const DXM::Vector3 offset = (position - DXM::Vector3(bounds.Center)) / bounds.Radius;
+	return { EncodeSnorm16(offset.x), EncodeSnorm16(offset.y), EncodeSnorm16(offset.z), 0 };
+}
+
+aZero::Asset::VertexPosition aZero::Asset::VertexQuantization::DecodePosition(const QuantizedVertexPosition& position, const DirectX::BoundingSphere& bounds)
+{
+	return DXM::Vector3(bounds.Center) + DXM::Vector3(DecodeSnorm16(position.X), DecodeSnorm16(position.Y), DecodeSnorm16(position.Z)) * bounds.Radius;
+}
+
+aZero::Asset::QuantizedVertexData aZero::Asset::VertexQuantization::EncodeVertexData(const GenericVertexData& vertexData)
+{
+	QuantizedVertexData output;
+	output.UV = static_cast<uint32_t>(EncodeHalf(vertexData.UV.x)) | (static_cast<uint32_t>(EncodeHalf(vertexData.UV.y)) << 16);
+	output.Normal = EncodeOctahedral(vertexData.Normal);
+	output.Tangent = EncodeOctahedral(vertexData.Tangent);
+	return output;
+}
+
+aZero::Asset::GenericVertexData aZero::Asset::VertexQuantization::DecodeVertexData(const QuantizedVertexData& vertexData)
+{
+	GenericVertexData output;
+	output.UV = DXM::Vector2(DecodeHalf(static_cast<uint16_t>(vertexData.UV & 0xFFFF)), DecodeHalf(static_cast<uint16_t>(vertexData.UV >> 16)));
+	output.Normal = DecodeOctahedral(vertexData.Normal);
+	output.Tangent = DecodeOctahedral(vertexData.Tangent);
+	return output;
+}
+
+aZero::Asset::VertexQuantization::QuantizationStats aZero::Asset::VertexQuantization::QuantizeVertices(MeshletMeshData& mesh)
+{
+	PROFILE_SCOPE("VertexQuantization::QuantizeVertices");
+	QuantizationStats stats;
+	if (mesh.VertexFormat == VertexFormat::Quantized)
+	{
+		return stats;
+	}
+
+	if (mesh.Positions.size() != mesh.GenericVertexData.size())
+	{
+		throw std::runtime_error("VertexQuantization::QuantizeVertices() => Mismatching position and vertex data counts");
+	}
+
+	// The positions are stored per axis, so the radius only has to cover the largest offset on any axis
+	const DXM::Vector3 center(mesh.Bounds.Center);
+	float extent = 0.f;
+	for (const VertexPosition& position : mesh.Positions)
+	{
+		const DXM::Vector3 offset = position - center;
+		extent = std::max({ extent, std::abs(offset.x), std::abs(offset.y), std::abs(offset.z) });
+	}
+	mesh.Bounds.Radius = std::max({ mesh.Bounds.Radius, extent, std::numeric_limits<float>::min() });
+
+	mesh.QuantizedPositions.resize(mesh.Positions.size());
+	mesh.QuantizedVertexData.resize(mesh.GenericVertexData.size());
+	for (size_t vertex = 0; vertex < mesh.Positions.size(); vertex++)
+	{
+		const VertexPosition& position = mesh.Positions[vertex];
+		const GenericVertexData& vertexData = mesh.GenericVertexData[vertex];
+		mesh.QuantizedPositions[vertex] = EncodePosition(position, mesh.Bounds);
+		mesh.QuantizedVertexData[vertex] = EncodeVertexData(vertexData);
+
+		const VertexPosition decodedPosition = DecodePosition(mesh.QuantizedPositions[vertex], mesh.Bounds);
+		const GenericVertexData decodedVertexData = DecodeVertexData(mesh.QuantizedVertexData[vertex]);
+		stats.MaxPositionError = std::max(stats.MaxPositionError, (decodedPosition - position).Length());
+		stats.MaxNormalError = std::max(stats.MaxNormalError, ComputeAngleDegrees(decodedVertexData.Normal, vertexData.Normal));
+		stats.MaxTangentError = std::max(stats.MaxTangentError, ComputeAngleDegrees(decodedVertexData.Tangent, vertexData.Tangent));
+		stats.MaxUVError = std::max({ stats.MaxUVError, std::abs(decodedVertexData.UV.x - vertexData.UV.x), std::abs(decodedVertexData.UV.y - vertexData.UV.y) });
+	}
+
+	stats.FloatBytes = mesh.Positions.size() * sizeof(VertexPosition) + mesh.GenericVertexData.size() * sizeof(GenericVertexData);
+	stats.QuantizedBytes = mesh.QuantizedPositions.size() * sizeof(QuantizedVertexPosition) + mesh.QuantizedVertexData.size() * sizeof(QuantizedVertexData);
+
+	mesh.Positions = std::vector<VertexPosition>();
+	mesh.GenericVertexData = std::vector<GenericVertexData>();
+	mesh.VertexFormat = VertexFormat::Quantized;
+	return stats;
+}
+
+void aZero::Asset::VertexQuantization::DecodeVertices(const MeshletMeshData& mesh, std::vector<VertexPosition>& positions, std::vector<GenericVertexData>& vertexData)
+{
+	if (mesh.VertexFormat == VertexFormat::Float)
+	{
+		positions = mesh.Positions;
+		vertexData = mesh.GenericVertexData;
+		return;
+	}
+
+	positions.resize(mesh.QuantizedPositions.size());
+	vertexData.resize(mesh.QuantizedVertexData.size());
+	for (size_t vertex = 0; vertex < positions.size(); vertex++)
+	{
+		positions[vertex] = DecodePosition(mesh.QuantizedPositions[vertex], mesh.Bounds);
+	}
+
+	for (size_t vertex = 0; vertex < vertexData.size(); vertex++)
+	{
+		vertexData[vertex] = DecodeVertexData(mesh.QuantizedVertexData[vertex]);
+	}
+}
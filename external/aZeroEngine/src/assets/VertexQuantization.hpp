@@ -0,0 +1,70 @@
+#pragma once
+#include "Mesh.hpp"
+
+namespace aZero
+{
+	namespace Asset
+	{
+		/*
+		Compact vertex streams for meshlet meshes, VertexFormat::Quantized.
+
+			Position:	3x snorm16 relative to the mesh bounding sphere, padded to 8 bytes (12 bytes as floats)
+			UV:			2x half float, keeps tiling UVs outside of [0, 1] (8 bytes as floats)
+			Normal:		Octahedral encoded, 2x snorm16 (12 bytes as floats)
+			Tangent:	Octahedral encoded, 2x snorm16 (12 bytes as floats)
+
+		The decode in MeshletCommon.hlsli has to stay bit-compatible with the functions below.
+		*/
+		namespace VertexQuantization
+		{
+			// Largest errors of the quantized streams compared to the float streams they were encoded from
+			struct QuantizationStats
+			{
+				// In mesh units
+				float MaxPositionError = 0.f;
+
+				// In degrees
+				float MaxNormalError = 0.f;
+				float MaxTangentError = 0.f;
+
+				float MaxUVError = 0.f;
+
+				// Vertex stream sizes before and after quantization
+				uint64_t FloatBytes = 0;
+				uint64_t QuantizedBytes = 0;
+			};
+
+			uint16_t EncodeHalf(float value);
+			float DecodeHalf(uint16_t value);
+
+			/** Encodes a direction to two snorm16 on the octahedron.
+			* The four nearest encodings are tried and the one that decodes closest to the direction is kept. A zero vector encodes to +Z.
+			@param direction Doesn't have to be normalized
+			@return uint32_t
+			*/
+			uint32_t EncodeOctahedral(const DXM::Vector3& direction);
+			DXM::Vector3 DecodeOctahedral(uint32_t encoded);
+
+			QuantizedVertexPosition EncodePosition(const VertexPosition& position, const DirectX::BoundingSphere& bounds);
+			VertexPosition DecodePosition(const QuantizedVertexPosition& position, const DirectX::BoundingSphere& bounds);
+
+			QuantizedVertexData EncodeVertexData(const GenericVertexData& vertexData);
+			GenericVertexData DecodeVertexData(const QuantizedVertexData& vertexData);
+
+			/** Replaces the float vertex streams of the mesh with quantized ones.
+			* The bounding sphere radius is grown if it doesn't contain every position on every axis. Does nothing if the mesh is already quantized.
+			@param mesh
+			@return QuantizationStats
+			*/
+			QuantizationStats QuantizeVertices(MeshletMeshData& mesh);
+
+			/** Decodes the quantized vertex streams of the mesh back to floats, ex. for CPU side processing
+			@param mesh
+			@param positions
+			@param vertexData
+			@return void
+			*/
+			void DecodeVertices(const MeshletMeshData& mesh, std::vector<VertexPosition>& positions, std::vector<GenericVertexData>& vertexData);
+		}
+	}
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <span>
 #include "Entity.hpp"
 #include "misc/SparseSet.hpp"
 
@@ -12,7 +13,6 @@ namespace aZero
 		{
 		private:
 			aZero::DS::SparseSet<EntityID, ComponentType> m_ComponentArray;
-			int m_AdditionalElementsWhenResize = 1;
 
 		public:
 			ComponentArray() = default;
@@ -24,9 +24,13 @@ namespace aZero
 
 			~ComponentArray() = default;
 
-			void Init(unsigned int StartNumElements = 0, int AdditionalElementsWhenResize = 1)
+			/** Clears the array and reserves the page table for StartNumElements IDs.
+			* Pages of the sparse array are allocated when a component is added in their ID range and released when their last component is removed.
+			@param StartNumElements
+			@return void
+			*/
+			void Init(unsigned int StartNumElements = 0)
 			{
-				m_AdditionalElementsWhenResize = AdditionalElementsWhenResize;
 				m_ComponentArray.Init(StartNumElements);
 			}
 
@@ -65,11 +69,7 @@ namespace aZero
 			*/
 			ComponentType* GetComponent(unsigned int ID)
 			{
-				if (!m_ComponentArray.Exists(ID))
-				{
-					return nullptr;
-				}
-				return &m_ComponentArray.Get(ID);
+				return m_ComponentArray.Find(ID);
 			}
 
 			/** Returns a pointer to a const component tied to the input ID
@@ -79,11 +79,24 @@ namespace aZero
 			*/
 			const ComponentType* GetComponent(unsigned int ID) const
 			{
-				if (!m_ComponentArray.Exists(ID))
-				{
-					return nullptr;
-				}
-				return &m_ComponentArray.Get(ID);
+				return m_ComponentArray.Find(ID);
+			}
+
+			/** Returns the number of entities that currently have a component of type ComponentType
+			@return size_t
+			*/
+			size_t GetNumComponents() const
+			{
+				return m_ComponentArray.Size();
+			}
+
+			/** Returns the IDs of the entities that have a component in dense order.
+			* The ID at index i owns the component at index i in the internal array.
+			@return std::span<const EntityID>
+			*/
+			std::span<const EntityID> GetEntityIDs() const
+			{
+				return m_ComponentArray.GetIDs();
 			}
 
 			/** Returns a reference to the internal sparse array containing all the components
@@ -111,24 +124,16 @@ namespace aZero
 			*/
 			void AddComponent(Entity& Ent, ComponentType&& Component)
 			{
-				if (Ent.GetID() != std::numeric_limits<uint32_t>::max())
+				if (Ent.GetID() != INVALID_ENTITY_ID)
 				{
-					if (Ent.GetID() >= m_ComponentArray.GetData().size())
-					{
-						m_ComponentArray.ExtendTo(m_AdditionalElementsWhenResize);
-					}
 					m_ComponentArray.Add(Ent.GetID(), std::forward<ComponentType>(Component));
 				}
 			}
 
 			void AddComponent(Entity& Ent, ComponentType& Component)
 			{
-				if (Ent.GetID() != std::numeric_limits<uint32_t>::max())
+				if (Ent.GetID() != INVALID_ENTITY_ID)
 				{
-					if (Ent.GetID() >= m_ComponentArray.GetData().size())
-					{
-						m_ComponentArray.ExtendTo(m_AdditionalElementsWhenResize);
-					}
 					m_ComponentArray.Add(Ent.GetID(), Component);
 				}
 			}
@@ -143,6 +148,22 @@ namespace aZero
 				m_ComponentArray.Remove(Ent.GetID());
 			}
 
+			/** Returns the number of bytes allocated by the sparse pages and the dense arrays
+			@return size_t
+			*/
+			size_t GetMemoryUsage() const
+			{
+				return m_ComponentArray.GetMemoryUsage();
+			}
+
+			/** Returns the number of bytes allocated by the sparse pages that map EntityIDs to components
+			@return size_t
+			*/
+			size_t GetSparseMemoryUsage() const
+			{
+				return m_ComponentArray.GetSparseMemoryUsage();
+			}
+
 			/** Returns whether or not the input Entity has a component of the specific type.
 			@param Ent
 			@return bool
@@ -1,6 +1,7 @@
 #pragma once
 #include <tuple>
 #include "ComponentArray.hpp"
+#include "View.hpp"
 
 namespace aZero
 {
@@ -59,6 +60,27 @@ namespace aZero
 				return std::get<ComponentArray<ComponentType>>(m_ComponentArrays);
 			}
 
+			/** Returns a aZero::ECS::View over all entities that have every one of the specified component types
+			@return aZero::ECS::View<ComponentTypes...>
+			*/
+			template<typename... ComponentTypes>
+			ECS::View<ComponentTypes...> View()
+			{
+				return ECS::View<ComponentTypes...>(GetComponentArray<ComponentTypes>()...);
+			}
+
+			/** Calls the input callable for each entity that has every one of the specified component types.
+			* The callable is invoked as callable(EntityID, ComponentTypes&...)
+			* NOTE: Adding or removing components of the specified types from within the callable isn't allowed
+			@param callable
+			@return void
+			*/
+			template<typename... ComponentTypes, typename Callable>
+			void Each(Callable&& callable)
+			{
+				this->View<ComponentTypes...>().Each(std::forward<Callable>(callable));
+			}
+
 			/** Adds a component for the input aZero::ECS::Entity with the ComponentType default constructor
 			* Sets the component bit
 			@param Ent
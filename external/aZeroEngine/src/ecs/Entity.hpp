@@ -1,5 +1,6 @@
 #pragma once
-#include <Windows.h>
+#include <cstdint>
+#include <limits>
 #include <tuple>
 #include <bitset>
 
@@ -10,8 +11,20 @@ namespace aZero
 		/** @brief Max number of components that the ECS supports */
 		constexpr int MAX_COMPONENT_COUNT = 32;
 
+		/** @brief Index of an Entity. Used as the key into the component arrays and the scene proxy */
 		typedef unsigned int EntityID;
 
+		/** @brief Packed 32-bit Entity handle. The low ENTITY_INDEX_BITS are the EntityID and the remaining bits the generation of the ID */
+		typedef uint32_t EntityHandle;
+
+		constexpr uint32_t ENTITY_INDEX_BITS = 24;
+		constexpr uint32_t ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+		constexpr uint32_t ENTITY_GENERATION_BITS = 32 - ENTITY_INDEX_BITS;
+		constexpr uint32_t ENTITY_MAX_GENERATION = (1u << ENTITY_GENERATION_BITS) - 1;
+
+		/** @brief EntityID of a default constructed or removed Entity. Never handed out by the EntityManager */
+		constexpr EntityID INVALID_ENTITY_ID = ENTITY_INDEX_MASK;
+
 		/** @brief The Entity of the ECS */
 		class Entity
 		{
@@ -24,7 +37,7 @@ namespace aZero
 			friend class ComponentArray;
 
 		private:
-			EntityID m_ID = std::numeric_limits<uint32_t>::max();
+			EntityHandle m_Handle = std::numeric_limits<uint32_t>::max();
 			std::bitset<MAX_COMPONENT_COUNT> m_ComponentMask;
 
 		private:
@@ -34,10 +47,21 @@ namespace aZero
 		public:
 			Entity() = default;
 
-			/** Returns the unique ID of the Entity
+			/** Returns the ID of the Entity.
+			* IDs are recycled when entities are removed, use aZero::ECS::EntityManager::IsValid() to detect stale entities.
 			@return EntityID
 			*/
-			EntityID GetID() const { return m_ID; }
+			EntityID GetID() const { return m_Handle & ENTITY_INDEX_MASK; }
+
+			/** Returns how many times the ID of the Entity had been recycled when the Entity was created
+			@return uint32_t
+			*/
+			uint32_t GetGeneration() const { return m_Handle >> ENTITY_INDEX_BITS; }
+
+			/** Returns the packed ID and generation of the Entity
+			@return EntityHandle
+			*/
+			EntityHandle GetHandle() const { return m_Handle; }
 
 			/** Returns the component bitmask which describes what components the Entity currently has
 			@return  std::bitset<MAX_COMPONENT_COUNT>&
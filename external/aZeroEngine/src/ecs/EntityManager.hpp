@@ -1,5 +1,7 @@
 #pragma once
 #include <queue>
+#include <vector>
+#include <stdexcept>
 #include "Entity.hpp"
 #include "misc/NonCopyable.hpp"
 
@@ -7,14 +9,23 @@ namespace aZero
 {
 	namespace ECS
 	{
-		/** @brief A class used to generate unique Entity objects
+		/** @brief A class used to generate unique Entity objects.
+		* Every ID has a generation that is increased when the ID is recycled, so an Entity that has been removed can be detected in O(1) with IsValid().
+		* An ID whose generation would wrap around is retired instead of recycled, so a stale Entity never aliases a newer one.
 		*/
 		class EntityManager : public NonCopyable
 		{
 		private:
+			static_assert(ENTITY_GENERATION_BITS <= 8, "Generations are stored as uint8_t");
+
 			unsigned int m_CurrentMax = 0;
 			std::queue<ECS::EntityID> m_FreeEntityIDs;
 
+			// Current generation per EntityID
+			std::vector<uint8_t> m_Generations;
+
+			uint32_t m_NumRetiredIDs = 0;
+
 		public:
 			EntityManager() = default;
 
@@ -23,21 +34,46 @@ namespace aZero
 			*/
 			Entity CreateEntity()
 			{
-				Entity NewEntity;
-
+				EntityID NewID;
 				if (!m_FreeEntityIDs.empty())
 				{
-					NewEntity.m_ID = m_FreeEntityIDs.front();
+					NewID = m_FreeEntityIDs.front();
 					m_FreeEntityIDs.pop();
 				}
 				else
 				{
-					NewEntity.m_ID = m_CurrentMax++;
+					if (m_CurrentMax == INVALID_ENTITY_ID)
+					{
+						throw std::runtime_error("EntityManager::CreateEntity() => Out of entity IDs");
+					}
+
+					NewID = m_CurrentMax++;
+					m_Generations.push_back(0);
 				}
 
+				Entity NewEntity;
+				NewEntity.m_Handle = (static_cast<EntityHandle>(m_Generations[NewID]) << ENTITY_INDEX_BITS) | NewID;
 				return NewEntity;
 			}
 
+			/** Returns whether or not the input Entity was created by this EntityManager and hasn't been removed
+			@param Ent
+			@return bool
+			*/
+			bool IsValid(const Entity& Ent) const
+			{
+				const EntityID ID = Ent.GetID();
+				return ID < m_Generations.size() && m_Generations[ID] == Ent.GetGeneration();
+			}
+
+			/** Returns the number of entities that currently exist
+			@return uint32_t
+			*/
+			uint32_t GetNumEntities() const
+			{
+				return m_CurrentMax - static_cast<uint32_t>(m_FreeEntityIDs.size()) - m_NumRetiredIDs;
+			}
+
 			/** Recycles the input Entity ID so that it can be reused.
 			* Invalidates the input Entity for future use.
 			@param Ent The Entity which should be recycled
@@ -45,11 +81,20 @@ namespace aZero
 			*/
 			void RemoveEntity(Entity& Ent)
 			{
-				if (Ent.m_ID == std::numeric_limits<uint32_t>::max())
+				if (!this->IsValid(Ent))
 					return;
 
-				m_FreeEntityIDs.push(Ent.m_ID);
-				Ent.m_ID = std::numeric_limits<uint32_t>::max();
+				const EntityID ID = Ent.GetID();
+				if (++m_Generations[ID] < ENTITY_MAX_GENERATION)
+				{
+					m_FreeEntityIDs.push(ID);
+				}
+				else
+				{
+					m_NumRetiredIDs++;
+				}
+
+				Ent.m_Handle = std::numeric_limits<uint32_t>::max();
 			}
 		};
 	}
@@ -0,0 +1,92 @@
+#pragma once
+#include <tuple>
+#include <limits>
+#include "ComponentArray.hpp"
+
+namespace aZero
+{
+	namespace ECS
+	{
+		/** @brief Joined iteration over all entities that have every one of the ComponentTypes.
+		* Iterates the dense array of the smallest aZero::ECS::ComponentArray and probes the others, so the cost scales with the rarest component instead of the number of entities.
+		* NOTE: Adding or removing components of the viewed types while iterating invalidates the iteration.
+		*/
+		template<typename... ComponentTypes>
+		class View
+		{
+			static_assert(sizeof...(ComponentTypes) > 0, "View requires atleast one component type");
+
+		private:
+			std::tuple<ComponentArray<ComponentTypes>*...> m_ComponentArrays;
+
+			template<typename ComponentType>
+			ComponentArray<ComponentType>& GetArray() const
+			{
+				return *std::get<ComponentArray<ComponentType>*>(m_ComponentArrays);
+			}
+
+			template<typename ComponentType, typename LeadType>
+			ComponentType* Probe(EntityID ID, size_t leadIndex) const
+			{
+				if constexpr (std::is_same_v<ComponentType, LeadType>)
+				{
+					// The lead array is iterated in dense order so no lookup is needed
+					return &this->GetArray<LeadType>().GetInternalArray()[leadIndex];
+				}
+				else
+				{
+					return this->GetArray<ComponentType>().GetComponent(ID);
+				}
+			}
+
+			template<typename LeadType, typename Callable>
+			void EachDrivenBy(Callable& callable) const
+			{
+				const std::span<const EntityID> IDs = this->GetArray<LeadType>().GetEntityIDs();
+				for (size_t leadIndex = 0; leadIndex < IDs.size(); leadIndex++)
+				{
+					const EntityID ID = IDs[leadIndex];
+					const std::tuple<ComponentTypes*...> components{ this->Probe<ComponentTypes, LeadType>(ID, leadIndex)... };
+					if ((std::get<ComponentTypes*>(components) && ...))
+					{
+						callable(ID, *std::get<ComponentTypes*>(components)...);
+					}
+				}
+			}
+
+		public:
+			View(ComponentArray<ComponentTypes>&... componentArrays)
+				:m_ComponentArrays(&componentArrays...) { }
+
+			/** Calls the input callable for each entity that has all of the ComponentTypes.
+			* The callable is invoked as callable(EntityID, ComponentTypes&...)
+			@param callable
+			@return void
+			*/
+			template<typename Callable>
+			void Each(Callable&& callable) const
+			{
+				// Pick the array with the fewest components to drive the iteration
+				size_t smallestSize = std::numeric_limits<size_t>::max();
+				size_t smallestIndex = 0;
+				size_t index = 0;
+				((this->GetArray<ComponentTypes>().GetNumComponents() < smallestSize
+					? (smallestSize = this->GetArray<ComponentTypes>().GetNumComponents(), smallestIndex = index++)
+					: index++), ...);
+
+				index = 0;
+				((index++ == smallestIndex ? (this->EachDrivenBy<ComponentTypes>(callable), true) : false) || ...);
+			}
+
+			/** Returns an upper bound of the number of entities that the view will visit
+			@return size_t
+			*/
+			size_t GetSizeHint() const
+			{
+				size_t smallestSize = std::numeric_limits<size_t>::max();
+				((smallestSize = std::min(smallestSize, this->GetArray<ComponentTypes>().GetNumComponents())), ...);
+				return smallestSize;
+			}
+		};
+	}
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include "misc/MathInclude.hpp"
+
 namespace aZero
 {
 	namespace ECS
@@ -1,5 +1,5 @@
 #pragma once
-#include "graphics_api/D3D12Include.hpp"
+#include "misc/MathInclude.hpp"
 
 namespace aZero
 {
@@ -18,7 +18,7 @@ namespace aZero
 			throw std::runtime_error("Engine() => Failed to create compiler");
 		}
 
-		m_Renderer = std::make_unique<Rendering::Renderer>(m_Device.Get(), bufferCount, *m_Compiler.Get());
+		m_Renderer = std::make_unique<Rendering::Renderer>(m_Device.Get(), bufferCount);
 		m_AudioEngine = std::make_unique<Audio::AudioEngine>();
 	}
 
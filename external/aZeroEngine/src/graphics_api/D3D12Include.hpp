@@ -4,7 +4,7 @@
 #include <wrl.h>
 #include <dxgi1_5.h>
 #include <d3dcompiler.h>
-#include <SimpleMath.h>
+#include "misc/MathInclude.hpp"
 #include <stdexcept>
 #include "misc/EngineDebugMacros.hpp"
 #include "graphics_api/DXCompilerInclude.hpp"
@@ -13,8 +13,6 @@
 #include <dxgidebug.h>
 #endif // DEBUG
 
-namespace DXM = DirectX::SimpleMath;
-
 // Dx12 api interfaces that might need an upgrade to a newer version at some point. So they are aliased to avoid having to replace all in the entire project whenever we wanna change the version.
 using ID3D12DeviceX = ID3D12Device9;
 using ID3D12FenceX = ID3D12Fence1;
@@ -16,16 +16,25 @@ namespace aZero
 			MeshletBuffer() = default;
 			MeshletBuffer(ID3D12DeviceX* device, ResourceRecycler& resourceRecycler, DescriptorHeap& heap, CommandList& cmdList, const Asset::MeshletMeshData& data)
 			{
+				// The shader picks the decode from the vertex format in GPUMesh
+				const bool quantized = data.VertexFormat == Asset::VertexFormat::Quantized;
+				const void* const positionData = quantized ? static_cast<const void*>(data.QuantizedPositions.data()) : data.Positions.data();
+				const size_t numPositions = quantized ? data.QuantizedPositions.size() : data.Positions.size();
+				const size_t positionStride = quantized ? sizeof(Asset::QuantizedVertexPosition) : sizeof(Asset::VertexPosition);
+				const void* const vertexData = quantized ? static_cast<const void*>(data.QuantizedVertexData.data()) : data.GenericVertexData.data();
+				const size_t numVertices = quantized ? data.QuantizedVertexData.size() : data.GenericVertexData.size();
+				const size_t vertexStride = quantized ? sizeof(Asset::QuantizedVertexData) : sizeof(Asset::GenericVertexData);
+
 				Buffer::Desc desc;
 				desc.AccessType = D3D12_HEAP_TYPE_DEFAULT;
 
-				desc.NumBytes = data.Positions.size() * sizeof(Asset::VertexPosition);
+				desc.NumBytes = numPositions * positionStride;
 				m_PositionBuffer = Buffer(device, desc, &resourceRecycler);
-				m_PositionDescriptor = ShaderResourceView(device, heap, m_PositionBuffer, data.Positions.size(), sizeof(Asset::VertexPosition));
+				m_PositionDescriptor = ShaderResourceView(device, heap, m_PositionBuffer, numPositions, positionStride);
 
-				desc.NumBytes = data.GenericVertexData.size() * sizeof(Asset::GenericVertexData);
+				desc.NumBytes = numVertices * vertexStride;
 				m_GenericVertexBuffer = Buffer(device, desc, &resourceRecycler);
-				m_GenericVertexDescriptor = ShaderResourceView(device, heap, m_GenericVertexBuffer, data.GenericVertexData.size(), sizeof(Asset::GenericVertexData));
+				m_GenericVertexDescriptor = ShaderResourceView(device, heap, m_GenericVertexBuffer, numVertices, vertexStride);
 
 				desc.NumBytes = data.Meshlets.size() * sizeof(Asset::Meshlet);
 				m_MeshletBuffer = Buffer(device, desc, &resourceRecycler);
@@ -42,8 +51,8 @@ namespace aZero
 				Buffer::Desc stagingDesc;
 				stagingDesc.AccessType = D3D12_HEAP_TYPE_UPLOAD;
 				stagingDesc.NumBytes = 
-					  data.Positions.size() * sizeof(Asset::VertexPosition)
-					+ data.GenericVertexData.size() * sizeof(Asset::GenericVertexData)
+					  numPositions * positionStride
+					+ numVertices * vertexStride
 					+ data.Meshlets.size() * sizeof(Asset::Meshlet)
 					+ data.MeshletIndices.size() * sizeof(Asset::VertexIndex)
 					+ data.MeshletPrimitives.size() * sizeof(data.MeshletPrimitives[0]);
@@ -51,13 +60,13 @@ namespace aZero
 				RenderAPI::Buffer stagingBuffer(device, stagingDesc, &resourceRecycler);
 
 				uint32_t offset = 0;
-				stagingBuffer.Write(data.Positions.data(), data.Positions.size() * sizeof(Asset::VertexPosition), offset);
-				cmdList->CopyBufferRegion(m_PositionBuffer.GetResource(), 0, stagingBuffer.GetResource(), offset, data.Positions.size() * sizeof(Asset::VertexPosition));
-				offset += data.Positions.size() * sizeof(Asset::VertexPosition);
+				stagingBuffer.Write(positionData, numPositions * positionStride, offset);
+				cmdList->CopyBufferRegion(m_PositionBuffer.GetResource(), 0, stagingBuffer.GetResource(), offset, numPositions * positionStride);
+				offset += numPositions * positionStride;
 
-				stagingBuffer.Write(data.GenericVertexData.data(), data.GenericVertexData.size() * sizeof(Asset::GenericVertexData), offset);
-				cmdList->CopyBufferRegion(m_GenericVertexBuffer.GetResource(), 0, stagingBuffer.GetResource(), offset, data.GenericVertexData.size() * sizeof(Asset::GenericVertexData));
-				offset += data.GenericVertexData.size() * sizeof(Asset::GenericVertexData);
+				stagingBuffer.Write(vertexData, numVertices * vertexStride, offset);
+				cmdList->CopyBufferRegion(m_GenericVertexBuffer.GetResource(), 0, stagingBuffer.GetResource(), offset, numVertices * vertexStride);
+				offset += numVertices * vertexStride;
 
 				stagingBuffer.Write(data.Meshlets.data(), data.Meshlets.size() * sizeof(Asset::Meshlet), offset);
 				cmdList->CopyBufferRegion(m_MeshletBuffer.GetResource(), 0, stagingBuffer.GetResource(), offset, data.Meshlets.size() * sizeof(Asset::Meshlet));
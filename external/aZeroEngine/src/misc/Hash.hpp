@@ -0,0 +1,89 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace aZero
+{
+	namespace Helper
+	{
+		constexpr uint64_t HashOffsetBasis = 14695981039346656037ull;
+
+		// xxHash64 primes
+		constexpr uint64_t HashPrime1 = 0x9E3779B185EBCA87ull;
+		constexpr uint64_t HashPrime2 = 0xC2B2AE3D27D4EB4Full;
+		constexpr uint64_t HashPrime3 = 0x165667B19E3779F9ull;
+		constexpr uint64_t HashPrime4 = 0x85EBCA77C2B2AE63ull;
+		constexpr uint64_t HashPrime5 = 0x27D4EB2F165667C5ull;
+
+		/** Hashes a block of memory with the single lane tail step of xxHash64.
+		* Consumes 8 bytes per step so hashing large source files stays cheap compared to re-importing them.
+		* Every word is multiplied and rotated on its own before it is folded in, so a change in any bit of a word reaches every bit of the hash.
+		* A plain (hash ^ word) * prime only carries changes upwards, so flipping the top bit of two words cancels out.
+		* NOTE: Not suitable for anything security related, only used to detect changed content.
+		@param data
+		@param numBytes
+		@param seed Previous hash to continue from
+		@return uint64_t
+		*/
+		inline uint64_t HashBytes(const void* data, size_t numBytes, uint64_t seed = HashOffsetBasis)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			uint64_t hash = seed + HashPrime5 + static_cast<uint64_t>(numBytes);
+
+			const size_t numWords = numBytes / sizeof(uint64_t);
+			for (size_t i = 0; i < numWords; i++)
+			{
+				uint64_t word;
+				memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+				hash ^= std::rotl(word * HashPrime2, 31) * HashPrime1;
+				hash = std::rotl(hash, 27) * HashPrime1 + HashPrime4;
+			}
+
+			for (size_t i = numWords * sizeof(uint64_t); i < numBytes; i++)
+			{
+				hash ^= bytes[i] * HashPrime5;
+				hash = std::rotl(hash, 11) * HashPrime1;
+			}
+
+			// Final avalanche so that small input changes spread over all bits
+			hash ^= hash >> 33;
+			hash *= HashPrime2;
+			hash ^= hash >> 29;
+			hash *= HashPrime3;
+			hash ^= hash >> 32;
+			return hash;
+		}
+
+		inline uint64_t HashString(std::string_view str, uint64_t seed = HashOffsetBasis)
+		{
+			return HashBytes(str.data(), str.size(), seed);
+		}
+
+		/** Formats the hash as 16 lowercase hex digits, ex. for cache file names
+		@param hash
+		@return std::string
+		*/
+		inline std::string HashToHexString(uint64_t hash)
+		{
+			static constexpr char hexDigits[] = "0123456789abcdef";
+			std::string hex(16, '0');
+			for (int32_t digit = 15; digit >= 0; digit--)
+			{
+				hex[digit] = hexDigits[hash & 0xF];
+				hash >>= 4;
+			}
+			return hex;
+		}
+
+		template<typename T>
+		uint64_t HashValue(const T& value, uint64_t seed = HashOffsetBasis)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "HashValue() requires a trivially copyable type");
+			return HashBytes(&value, sizeof(T), seed);
+		}
+	}
+}
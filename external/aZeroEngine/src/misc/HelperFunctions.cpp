@@ -1,4 +1,6 @@
 #include "HelperFunctions.hpp"
+#include <vector>
+#include <Windows.h>
 
 std::string aZero::Helper::GetProjectDirectory()
 {
@@ -1,6 +1,9 @@
 #pragma once
-#include "graphics_api/D3D12Include.hpp"
 #include <algorithm>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <unordered_map>
 
 namespace aZero
 {
@@ -0,0 +1,330 @@
+#include "JobSystem.hpp"
+#include "Profiler.hpp"
+#include "EngineDebugMacros.hpp"
+#include <utility>
+
+namespace
+{
+	// The job system and worker index of the current thread, index 0 for threads that aren't workers
+	thread_local aZero::Jobs::JobSystem* t_CurrentJobSystem = nullptr;
+	thread_local uint32_t t_CurrentWorkerIndex = 0;
+	thread_local uint32_t t_StealSeed = 0;
+
+	uint32_t NextStealVictim(uint32_t numWorkers)
+	{
+		// xorshift, seeded per thread on first use
+		if (t_StealSeed == 0)
+		{
+			t_StealSeed = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1u;
+		}
+		t_StealSeed ^= t_StealSeed << 13;
+		t_StealSeed ^= t_StealSeed >> 17;
+		t_StealSeed ^= t_StealSeed << 5;
+		return t_StealSeed % numWorkers;
+	}
+}
+
+namespace aZero
+{
+	namespace Jobs
+	{
+		JobSystem::JobSystem(uint32_t numWorkerThreads)
+		{
+			m_Workers.reserve(numWorkerThreads);
+			for (uint32_t workerIndex = 0; workerIndex < numWorkerThreads; workerIndex++)
+			{
+				m_Workers.emplace_back(std::make_unique<Worker>());
+			}
+
+			// Started after all deques exist since the workers steal from each other
+			for (uint32_t workerIndex = 0; workerIndex < numWorkerThreads; workerIndex++)
+			{
+				m_Workers[workerIndex]->Thread = std::thread(&JobSystem::WorkerMain, this, workerIndex + 1);
+			}
+		}
+
+		JobSystem::~JobSystem()
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_SleepLock);
+				m_Stop.store(true);
+			}
+			m_WakeCondition.notify_all();
+
+			for (std::unique_ptr<Worker>& worker : m_Workers)
+			{
+				worker->Thread.join();
+			}
+
+			// Jobs that nobody waited on are dropped
+			for (std::unique_ptr<Worker>& worker : m_Workers)
+			{
+				while (Job* job = worker->Deque.Steal())
+				{
+					delete job;
+				}
+			}
+
+			for (Job* job : m_SharedQueue)
+			{
+				delete job;
+			}
+		}
+
+		void JobSystem::WorkerMain(uint32_t workerIndex)
+		{
+			t_CurrentJobSystem = this;
+			t_CurrentWorkerIndex = workerIndex;
+			PROFILE_THREAD_NAME("Job worker " + std::to_string(workerIndex));
+
+			while (!m_Stop.load(std::memory_order_relaxed))
+			{
+				if (Job* job = this->FindJob())
+				{
+					this->Execute(job);
+					continue;
+				}
+
+				// Submit() only notifies if it sees a sleeping worker, and the sleeping worker checks m_NumQueued after announcing itself, so no wake-up is lost
+				std::unique_lock<std::mutex> lock(m_SleepLock);
+				m_NumSleeping.fetch_add(1);
+				m_WakeCondition.wait(lock, [this]() { return m_Stop.load() || m_NumQueued.load() > 0; });
+				m_NumSleeping.fetch_sub(1);
+			}
+		}
+
+		void JobSystem::Submit(Job* job)
+		{
+			// Counted before the push so that a thief never decrements m_NumQueued below zero
+			m_NumQueued.fetch_add(1);
+			if (t_CurrentJobSystem == this)
+			{
+				if (!m_Workers[t_CurrentWorkerIndex - 1]->Deque.Push(job))
+				{
+					m_NumQueued.fetch_sub(1);
+					this->Execute(job);
+					return;
+				}
+			}
+			else
+			{
+				std::unique_lock<std::mutex> lock(m_SharedLock);
+				m_SharedQueue.push_back(job);
+			}
+
+			if (m_NumSleeping.load() > 0)
+			{
+				{
+					std::unique_lock<std::mutex> lock(m_SleepLock);
+				}
+
+				// A waiter whose counter finishes at the same time might take the notification without executing the job
+				if (m_NumBlockedWaiters.load() > 0)
+				{
+					m_WakeCondition.notify_all();
+				}
+				else
+				{
+					m_WakeCondition.notify_one();
+				}
+			}
+		}
+
+		Job* JobSystem::FindJob()
+		{
+			if (m_NumQueued.load(std::memory_order_relaxed) == 0)
+			{
+				return nullptr;
+			}
+
+			Job* job = nullptr;
+			if (t_CurrentJobSystem == this)
+			{
+				job = m_Workers[t_CurrentWorkerIndex - 1]->Deque.Pop();
+			}
+
+			if (!job)
+			{
+				std::unique_lock<std::mutex> lock(m_SharedLock);
+				if (!m_SharedQueue.empty())
+				{
+					job = m_SharedQueue.front();
+					m_SharedQueue.pop_front();
+				}
+			}
+
+			if (!job && !m_Workers.empty())
+			{
+				// Start at a random victim so that thieves spread out over the workers
+				const uint32_t numWorkers = static_cast<uint32_t>(m_Workers.size());
+				const uint32_t firstVictim = NextStealVictim(numWorkers);
+				for (uint32_t offset = 0; offset < numWorkers && !job; offset++)
+				{
+					job = m_Workers[(firstVictim + offset) % numWorkers]->Deque.Steal();
+				}
+			}
+
+			if (job)
+			{
+				m_NumQueued.fetch_sub(1, std::memory_order_relaxed);
+			}
+			return job;
+		}
+
+		void JobSystem::Execute(Job* job)
+		{
+			if (job->Counter)
+			{
+				std::exception_ptr exception;
+				try
+				{
+					job->Function();
+				}
+				catch (...)
+				{
+					exception = std::current_exception();
+				}
+				this->FinishJob(*job->Counter, exception);
+			}
+			else
+			{
+				// Nothing waits on the job, so the exception is kept instead of unwinding into the worker loop and terminating
+				try
+				{
+					job->Function();
+				}
+				catch (...)
+				{
+					DEBUG_PRINT("Unhandled exception in a job without a counter");
+					std::unique_lock<std::mutex> lock(m_UnhandledLock);
+					if (!m_UnhandledException)
+					{
+						m_UnhandledException = std::current_exception();
+					}
+				}
+			}
+
+			delete job;
+		}
+
+		std::exception_ptr JobSystem::TakeUnhandledException()
+		{
+			std::unique_lock<std::mutex> lock(m_UnhandledLock);
+			return std::exchange(m_UnhandledException, nullptr);
+		}
+
+		void JobSystem::FinishJob(JobCounter& counter, std::exception_ptr exception)
+		{
+			counter.m_NumFinishing.fetch_add(1);
+			if (exception)
+			{
+				std::unique_lock<std::mutex> lock(counter.m_Lock);
+				if (!counter.m_Exception)
+				{
+					counter.m_Exception = exception;
+				}
+			}
+
+			// Sequentially consistent like the check in Wait(), so either the sleeping waiter sees the counter finished or this sees the waiter
+			if (counter.m_NumPending.fetch_sub(1) == 1)
+			{
+				std::vector<Job*> continuations;
+				{
+					std::unique_lock<std::mutex> lock(counter.m_Lock);
+					continuations.swap(counter.m_Continuations);
+				}
+
+				for (Job* continuation : continuations)
+				{
+					this->Submit(continuation);
+				}
+			}
+
+			// Last access to the counter
+			counter.m_NumFinishing.fetch_sub(1);
+
+			if (m_NumBlockedWaiters.load() > 0)
+			{
+				{
+					std::unique_lock<std::mutex> lock(m_SleepLock);
+				}
+				m_WakeCondition.notify_all();
+			}
+		}
+
+		void JobSystem::Run(std::function<void()>&& function, JobCounter* counter)
+		{
+			if (counter)
+			{
+				counter->m_NumPending.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			this->Submit(new Job{ std::move(function), counter });
+		}
+
+		void JobSystem::RunAfter(JobCounter& dependency, std::function<void()>&& function, JobCounter* counter)
+		{
+			if (counter)
+			{
+				counter->m_NumPending.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			Job* job = new Job{ std::move(function), counter };
+			{
+				// The job that brings the dependency to zero takes the continuations under the same lock
+				std::unique_lock<std::mutex> lock(dependency.m_Lock);
+				if (dependency.m_NumPending.load(std::memory_order_acquire) > 0)
+				{
+					dependency.m_Continuations.push_back(job);
+					return;
+				}
+			}
+
+			this->Submit(job);
+		}
+
+		void JobSystem::Wait(JobCounter& counter)
+		{
+			uint32_t numFailedSpins = 0;
+			while (!counter.IsDone())
+			{
+				if (Job* job = this->FindJob())
+				{
+					this->Execute(job);
+					numFailedSpins = 0;
+				}
+				else if (numFailedSpins < MaxWaitSpins)
+				{
+					numFailedSpins++;
+					std::this_thread::yield();
+				}
+				else
+				{
+					// Sleeps until the counter is done or a job is queued. Queued jobs wake it as well so a waiting worker still executes the jobs in its own deque.
+					std::unique_lock<std::mutex> lock(m_SleepLock);
+					m_NumBlockedWaiters.fetch_add(1);
+					m_NumSleeping.fetch_add(1);
+					m_WakeCondition.wait(lock, [this, &counter]() {
+						return (counter.m_NumPending.load() == 0 && counter.m_NumFinishing.load() == 0) || m_NumQueued.load() > 0;
+						});
+					m_NumSleeping.fetch_sub(1);
+					m_NumBlockedWaiters.fetch_sub(1);
+					numFailedSpins = 0;
+				}
+			}
+
+			if (counter.m_Exception)
+			{
+				std::exception_ptr exception = counter.m_Exception;
+				counter.m_Exception = nullptr;
+				std::rethrow_exception(exception);
+			}
+		}
+
+		JobSystem& GetJobSystem()
+		{
+			static JobSystem jobSystem(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+			return jobSystem;
+		}
+	}
+}
@@ -0,0 +1,193 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include "WorkStealingDeque.hpp"
+#include "NonCopyable.hpp"
+#include "NonMovable.hpp"
+
+namespace aZero
+{
+	namespace Jobs
+	{
+		class JobSystem;
+
+		struct Job;
+
+		/** @brief Counts the unfinished jobs that were run with it.
+		* Jobs can be scheduled to start once a counter reaches zero, which is how dependencies between jobs are expressed.
+		* The first exception thrown by a job of the counter is rethrown by JobSystem::Wait().
+		* NOTE: Don't reuse a counter while jobs are still scheduled to start after it.
+		*/
+		class JobCounter : public NonCopyable, public NonMovable
+		{
+			friend class JobSystem;
+		private:
+			std::atomic<uint32_t> m_NumPending = 0;
+
+			// Jobs that are still touching the counter after decrementing it, so waiters don't return while the counter is in use
+			std::atomic<uint32_t> m_NumFinishing = 0;
+
+			std::mutex m_Lock;
+			std::vector<Job*> m_Continuations;
+			std::exception_ptr m_Exception;
+
+		public:
+			JobCounter() = default;
+
+			bool IsDone() const { return m_NumPending.load(std::memory_order_acquire) == 0 && m_NumFinishing.load(std::memory_order_acquire) == 0; }
+			uint32_t GetNumPending() const { return m_NumPending.load(std::memory_order_acquire); }
+		};
+
+		struct Job
+		{
+			std::function<void()> Function;
+			JobCounter* Counter = nullptr;
+		};
+
+		/** @brief Work stealing job scheduler.
+		* Every worker thread owns a deque that it pushes and pops jobs at the bottom of, idle workers steal from the top of the other deques.
+		* Jobs submitted from threads outside the system go through a shared queue.
+		* Waiting on a counter executes other jobs until the counter reaches zero, so jobs can wait on the jobs they spawn without blocking a worker.
+		*/
+		class JobSystem : public NonCopyable, public NonMovable
+		{
+		public:
+			// Jobs submitted to a full deque are executed immediately by the submitting thread
+			static constexpr uint32_t DequeCapacity = 4096;
+
+			// Failed attempts to find a job before Wait() sleeps instead of yielding
+			static constexpr uint32_t MaxWaitSpins = 64;
+
+		private:
+			struct Worker
+			{
+				DS::WorkStealingDeque<Job> Deque = DS::WorkStealingDeque<Job>(DequeCapacity);
+				std::thread Thread;
+			};
+
+			std::vector<std::unique_ptr<Worker>> m_Workers;
+
+			std::mutex m_SharedLock;
+			std::deque<Job*> m_SharedQueue;
+
+			// Number of jobs in the deques and the shared queue, used to put idle workers to sleep
+			std::atomic<uint32_t> m_NumQueued = 0;
+			std::atomic<uint32_t> m_NumSleeping = 0;
+
+			// Threads sleeping in Wait(), FinishJob() only wakes the sleepers when there are any
+			std::atomic<uint32_t> m_NumBlockedWaiters = 0;
+			std::mutex m_SleepLock;
+			std::condition_variable m_WakeCondition;
+			std::atomic<bool> m_Stop = false;
+
+			// First exception thrown by a job that was run without a counter
+			std::mutex m_UnhandledLock;
+			std::exception_ptr m_UnhandledException;
+
+			void WorkerMain(uint32_t workerIndex);
+			void Submit(Job* job);
+			Job* FindJob();
+			void Execute(Job* job);
+			void FinishJob(JobCounter& counter, std::exception_ptr exception);
+
+		public:
+			/** @param numWorkerThreads Number of background threads. The threads that wait on counters help out as well. */
+			JobSystem(uint32_t numWorkerThreads);
+			~JobSystem();
+
+			/** Runs the function on any thread. The counter is incremented now and decremented when the function has returned.
+			* Exceptions of jobs without a counter can't be rethrown by Wait(), the first one is kept for TakeUnhandledException() instead.
+			@param function
+			@param counter
+			@return void
+			*/
+			void Run(std::function<void()>&& function, JobCounter* counter = nullptr);
+
+			/** Runs the function once the dependency has reached zero. The counter is incremented immediately.
+			@param dependency
+			@param function
+			@param counter
+			@return void
+			*/
+			void RunAfter(JobCounter& dependency, std::function<void()>&& function, JobCounter* counter = nullptr);
+
+			/** Executes queued jobs until the counter has reached zero. Rethrows the first exception of the counter's jobs.
+			* Sleeps while there is nothing to execute, so waiting on a long job doesn't occupy a core.
+			@param counter
+			@return void
+			*/
+			void Wait(JobCounter& counter);
+
+			/** Calls callable(begin, end) for batches covering [0, count) and returns once all batches are done.
+			* The calling thread runs the first batch. Batches hold at least minBatchSize indices.
+			@param count
+			@param minBatchSize
+			@param callable
+			@return void
+			*/
+			template<typename Callable>
+			void ParallelFor(uint32_t count, uint32_t minBatchSize, Callable&& callable)
+			{
+				if (count == 0)
+				{
+					return;
+				}
+
+				// A few batches per worker so that stealing can even out batches of different cost
+				const uint32_t targetNumBatches = this->GetNumWorkers() * 4;
+				const uint32_t batchSize = std::max(std::max(minBatchSize, 1u), (count + targetNumBatches - 1) / targetNumBatches);
+				if (batchSize >= count)
+				{
+					callable(0u, count);
+					return;
+				}
+
+				JobCounter counter;
+				for (uint32_t begin = batchSize; begin < count; begin += batchSize)
+				{
+					const uint32_t end = std::min(count, begin + batchSize);
+					this->Run([&callable, begin, end]() { callable(begin, end); }, &counter);
+				}
+
+				// The queued batches reference the callable, so they have to finish before an exception leaves this scope
+				std::exception_ptr exception;
+				try
+				{
+					callable(0u, batchSize);
+				}
+				catch (...)
+				{
+					exception = std::current_exception();
+				}
+
+				this->Wait(counter);
+				if (exception)
+				{
+					std::rethrow_exception(exception);
+				}
+			}
+
+			/** Returns the first exception thrown by a job without a counter since the last call, or nullptr if there was none
+			@return std::exception_ptr
+			*/
+			std::exception_ptr TakeUnhandledException();
+
+			/** Returns the number of threads that can execute jobs, the background workers plus the waiting thread
+			@return uint32_t
+			*/
+			uint32_t GetNumWorkers() const { return static_cast<uint32_t>(m_Workers.size()) + 1; }
+		};
+
+		/** Returns the engine wide job system. It is created on first use with one worker per hardware thread besides the calling thread.
+		@return JobSystem&
+		*/
+		JobSystem& GetJobSystem();
+	}
+}
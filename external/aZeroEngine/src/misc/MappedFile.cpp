@@ -0,0 +1,143 @@
+#include "MappedFile.hpp"
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+aZero::Helper::MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+aZero::Helper::MappedFile& aZero::Helper::MappedFile::operator=(MappedFile&& other) noexcept
+{
+	std::swap(m_Data, other.m_Data);
+	std::swap(m_Size, other.m_Size);
+#ifdef _WIN32
+	std::swap(m_FileHandle, other.m_FileHandle);
+	std::swap(m_MappingHandle, other.m_MappingHandle);
+#else
+	std::swap(m_FileDescriptor, other.m_FileDescriptor);
+#endif
+	return *this;
+}
+
+aZero::Helper::MappedFile::~MappedFile()
+{
+	this->Close();
+}
+
+#ifdef _WIN32
+bool aZero::Helper::MappedFile::Open(const std::string& path)
+{
+	this->Close();
+
+	const std::wstring pathW(path.begin(), path.end());
+	HANDLE file = CreateFileW(pathW.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	m_FileHandle = file;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		this->Close();
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		this->Close();
+		return false;
+	}
+	m_MappingHandle = mapping;
+
+	m_Data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!m_Data)
+	{
+		this->Close();
+		return false;
+	}
+
+	m_Size = static_cast<size_t>(fileSize.QuadPart);
+	return true;
+}
+
+void aZero::Helper::MappedFile::Close()
+{
+	if (m_Data)
+	{
+		UnmapViewOfFile(m_Data);
+		m_Data = nullptr;
+	}
+
+	if (m_MappingHandle)
+	{
+		CloseHandle(m_MappingHandle);
+		m_MappingHandle = nullptr;
+	}
+
+	if (m_FileHandle)
+	{
+		CloseHandle(m_FileHandle);
+		m_FileHandle = nullptr;
+	}
+
+	m_Size = 0;
+}
+#else
+bool aZero::Helper::MappedFile::Open(const std::string& path)
+{
+	this->Close();
+
+	m_FileDescriptor = open(path.c_str(), O_RDONLY);
+	if (m_FileDescriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStats;
+	if (fstat(m_FileDescriptor, &fileStats) != 0 || fileStats.st_size == 0)
+	{
+		this->Close();
+		return false;
+	}
+
+	void* data = mmap(nullptr, static_cast<size_t>(fileStats.st_size), PROT_READ, MAP_PRIVATE, m_FileDescriptor, 0);
+	if (data == MAP_FAILED)
+	{
+		this->Close();
+		return false;
+	}
+
+	m_Data = static_cast<const uint8_t*>(data);
+	m_Size = static_cast<size_t>(fileStats.st_size);
+	return true;
+}
+
+void aZero::Helper::MappedFile::Close()
+{
+	if (m_Data)
+	{
+		munmap(const_cast<uint8_t*>(m_Data), m_Size);
+		m_Data = nullptr;
+	}
+
+	if (m_FileDescriptor >= 0)
+	{
+		close(m_FileDescriptor);
+		m_FileDescriptor = -1;
+	}
+
+	m_Size = 0;
+}
+#endif
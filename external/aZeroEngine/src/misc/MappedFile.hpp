@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include "NonCopyable.hpp"
+
+namespace aZero
+{
+	namespace Helper
+	{
+		/** @brief Read-only memory mapping of a file on disk.
+		* The mapping stays valid until the object is closed or destroyed.
+		*/
+		class MappedFile : public NonCopyable
+		{
+		public:
+			MappedFile() = default;
+			MappedFile(const std::string& path)
+			{
+				this->Open(path);
+			}
+
+			MappedFile(MappedFile&& other) noexcept;
+			MappedFile& operator=(MappedFile&& other) noexcept;
+
+			~MappedFile();
+
+			/** Maps the file at the input path. Closes any previously mapped file.
+			* Returns false if the file doesn't exist, is empty or couldn't be mapped.
+			@param path
+			@return bool
+			*/
+			bool Open(const std::string& path);
+			void Close();
+
+			bool IsOpen() const { return m_Data != nullptr; }
+			const uint8_t* GetData() const { return m_Data; }
+			size_t GetSize() const { return m_Size; }
+
+		private:
+			const uint8_t* m_Data = nullptr;
+			size_t m_Size = 0;
+
+#ifdef _WIN32
+			void* m_FileHandle = nullptr;
+			void* m_MappingHandle = nullptr;
+#else
+			int m_FileDescriptor = -1;
+#endif
+		};
+	}
+}
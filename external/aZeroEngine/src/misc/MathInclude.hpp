@@ -0,0 +1,9 @@
+#pragma once
+#ifndef _WIN32
+// Windows types that SimpleMath refers to, provided by DirectX-Headers
+#include <wsl/winadapter.h>
+#endif
+#include <SimpleMath.h>
+
+// Math without the rest of D3D12, so the asset, ECS and culling code also builds outside of Windows
+namespace DXM = DirectX::SimpleMath;
@@ -0,0 +1,165 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <vector>
+#include <limits>
+#include <cstdint>
+
+namespace aZero
+{
+	namespace DS
+	{
+		/** @brief Maps integral IDs to uint32_t indices using fixed size pages that are allocated on first use.
+		* Lookups are a shift, a mask and two loads. Memory scales with the ID ranges that are in use instead of the largest ID.
+		* The default page covers 256 IDs (1 KB of indices), small enough that a rare component spread over many entities only touches a fraction of the pages.
+		*/
+		template<typename IDType, uint32_t PageSize = 256>
+		class PagedSparseIndex
+		{
+			static_assert(std::is_integral_v<IDType>, "PagedSparseIndex requires an integral ID type");
+			static_assert(PageSize > 0 && (PageSize & (PageSize - 1)) == 0, "PageSize has to be a power of two");
+
+		public:
+			static constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+		private:
+			using Page = std::array<uint32_t, PageSize>;
+			std::vector<std::unique_ptr<Page>> m_Pages;
+
+			// Number of mapped IDs per page so that empty pages can be released
+			std::vector<uint32_t> m_NumMappedPerPage;
+
+			static constexpr size_t GetPageIndex(IDType ID) { return static_cast<size_t>(ID) / PageSize; }
+			static constexpr size_t GetPageOffset(IDType ID) { return static_cast<size_t>(ID) & (PageSize - 1); }
+
+		public:
+			PagedSparseIndex() = default;
+
+			/** Returns the index mapped to the ID or InvalidIndex if there is none
+			@param ID
+			@return uint32_t
+			*/
+			uint32_t Get(IDType ID) const
+			{
+				const size_t pageIndex = GetPageIndex(ID);
+				if (pageIndex >= m_Pages.size() || !m_Pages[pageIndex])
+				{
+					return InvalidIndex;
+				}
+
+				return (*m_Pages[pageIndex])[GetPageOffset(ID)];
+			}
+
+			/** Maps the ID to the index. Allocates the page of the ID if it doesn't exist.
+			@param ID
+			@param index
+			@return void
+			*/
+			void Set(IDType ID, uint32_t index)
+			{
+				const size_t pageIndex = GetPageIndex(ID);
+				if (pageIndex >= m_Pages.size())
+				{
+					m_Pages.resize(pageIndex + 1);
+					m_NumMappedPerPage.resize(pageIndex + 1, 0);
+				}
+
+				if (!m_Pages[pageIndex])
+				{
+					m_Pages[pageIndex] = std::make_unique<Page>();
+					m_Pages[pageIndex]->fill(InvalidIndex);
+				}
+
+				uint32_t& slot = (*m_Pages[pageIndex])[GetPageOffset(ID)];
+				if (slot == InvalidIndex && index != InvalidIndex)
+				{
+					m_NumMappedPerPage[pageIndex]++;
+				}
+				else if (slot != InvalidIndex && index == InvalidIndex)
+				{
+					m_NumMappedPerPage[pageIndex]--;
+				}
+				slot = index;
+			}
+
+			/** Unmaps the ID.
+			* If releaseEmptyPage is true the page is freed once it no longer maps any ID, otherwise it is kept so re-adding IDs in the same range doesn't allocate.
+			@param ID
+			@param releaseEmptyPage
+			@return void
+			*/
+			void Reset(IDType ID, bool releaseEmptyPage = false)
+			{
+				const size_t pageIndex = GetPageIndex(ID);
+				if (pageIndex >= m_Pages.size() || !m_Pages[pageIndex])
+				{
+					return;
+				}
+
+				uint32_t& slot = (*m_Pages[pageIndex])[GetPageOffset(ID)];
+				if (slot == InvalidIndex)
+				{
+					return;
+				}
+
+				slot = InvalidIndex;
+				if (--m_NumMappedPerPage[pageIndex] == 0 && releaseEmptyPage)
+				{
+					m_Pages[pageIndex].reset();
+				}
+			}
+
+			bool Contains(IDType ID) const { return this->Get(ID) != InvalidIndex; }
+
+			/** Grows the page table so it covers numIDs IDs. Pages are still only allocated on first use.
+			@param numIDs
+			@return void
+			*/
+			void Reserve(size_t numIDs)
+			{
+				const size_t numPages = (numIDs + PageSize - 1) / PageSize;
+				if (numPages > m_Pages.size())
+				{
+					m_Pages.resize(numPages);
+					m_NumMappedPerPage.resize(numPages, 0);
+				}
+			}
+
+			/** Returns the number of IDs that the page table covers
+			@return size_t
+			*/
+			size_t GetNumCoveredIDs() const { return m_Pages.size() * PageSize; }
+
+			/** Releases all pages
+			@return void
+			*/
+			void Clear()
+			{
+				m_Pages.clear();
+				m_Pages.shrink_to_fit();
+				m_NumMappedPerPage.clear();
+				m_NumMappedPerPage.shrink_to_fit();
+			}
+
+			size_t GetNumAllocatedPages() const
+			{
+				size_t numPages = 0;
+				for (const std::unique_ptr<Page>& page : m_Pages)
+				{
+					numPages += page ? 1 : 0;
+				}
+				return numPages;
+			}
+
+			/** Returns the number of bytes allocated by the pages and the page table
+			@return size_t
+			*/
+			size_t GetMemoryUsage() const
+			{
+				return this->GetNumAllocatedPages() * sizeof(Page)
+					+ m_Pages.capacity() * sizeof(std::unique_ptr<Page>)
+					+ m_NumMappedPerPage.capacity() * sizeof(uint32_t);
+			}
+		};
+	}
+}
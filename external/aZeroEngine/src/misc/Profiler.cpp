@@ -0,0 +1,298 @@
+#include "Profiler.hpp"
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+	std::atomic<uint64_t> g_NextProfilerID = 1;
+
+	void AppendEscaped(std::string& output, const char* text)
+	{
+		for (const char* character = text; *character != '\0'; character++)
+		{
+			switch (*character)
+			{
+			case '"': output += "\\\""; break;
+			case '\\': output += "\\\\"; break;
+			case '\n': output += "\\n"; break;
+			case '\t': output += "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(*character) < 0x20)
+				{
+					char escaped[8];
+					std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(*character));
+					output += escaped;
+				}
+				else
+				{
+					output += *character;
+				}
+			}
+		}
+	}
+
+	// Chrome traces are in microseconds
+	void AppendMicroseconds(std::string& output, uint64_t nanoseconds)
+	{
+		char text[32];
+		std::snprintf(text, sizeof(text), "%.3f", static_cast<double>(nanoseconds) / 1000.0);
+		output += text;
+	}
+
+	void AppendCompleteEvent(std::string& output, const char* name, uint32_t threadIndex, uint64_t startNs, uint64_t endNs)
+	{
+		output += "{\"name\":\"";
+		AppendEscaped(output, name);
+		output += "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":" + std::to_string(threadIndex) + ",\"ts\":";
+		AppendMicroseconds(output, startNs);
+		output += ",\"dur\":";
+		AppendMicroseconds(output, endNs - startNs);
+		output += "},\n";
+	}
+
+	void AppendThreadName(std::string& output, uint32_t threadIndex, const std::string& name)
+	{
+		output += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(threadIndex) + ",\"args\":{\"name\":\"";
+		AppendEscaped(output, name.c_str());
+		output += "\"}},\n";
+	}
+}
+
+const char* aZero::Profiling::GetCounterName(Counter counter)
+{
+	switch (counter)
+	{
+	case Counter::StagedBytes: return "StagedBytes";
+	case Counter::CopyRegions: return "CopyRegions";
+	case Counter::ProxyUpdates: return "ProxyUpdates";
+	case Counter::Instances: return "Instances";
+	case Counter::VisibleInstances: return "VisibleInstances";
+	default: return "Unknown";
+	}
+}
+
+aZero::Profiling::Profiler::Profiler()
+	:m_ID(g_NextProfilerID++)
+{
+	m_FrameHistory.reserve(FrameHistorySize);
+}
+
+aZero::Profiling::Profiler::ThreadBuffer& aZero::Profiling::Profiler::GetThreadBuffer()
+{
+	// The ID keeps a thread from using the buffer of a destroyed profiler that a new one was created in place of
+	thread_local uint64_t cachedProfilerID = 0;
+	thread_local ThreadBuffer* cachedBuffer = nullptr;
+	if (cachedProfilerID == m_ID)
+	{
+		return *cachedBuffer;
+	}
+
+	const std::thread::id threadID = std::this_thread::get_id();
+	std::lock_guard<std::mutex> lock(m_ThreadsLock);
+
+	ThreadBuffer* buffer = nullptr;
+	for (const std::unique_ptr<ThreadBuffer>& thread : m_Threads)
+	{
+		if (thread->ThreadID == threadID)
+		{
+			buffer = thread.get();
+			break;
+		}
+	}
+
+	if (!buffer)
+	{
+		// Thread 0 is the frame track of the exported trace
+		buffer = m_Threads.emplace_back(std::make_unique<ThreadBuffer>()).get();
+		buffer->ThreadID = threadID;
+		buffer->ThreadIndex = static_cast<uint32_t>(m_Threads.size());
+		buffer->Name = "Thread " + std::to_string(buffer->ThreadIndex);
+	}
+
+	cachedProfilerID = m_ID;
+	cachedBuffer = buffer;
+	return *buffer;
+}
+
+void aZero::Profiling::Profiler::BeginCapture()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_ThreadsLock);
+		for (const std::unique_ptr<ThreadBuffer>& thread : m_Threads)
+		{
+			std::lock_guard<std::mutex> threadLock(thread->Lock);
+			thread->Events.clear();
+			thread->NumDropped = 0;
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_FrameLock);
+		m_CapturedFrames.clear();
+	}
+
+	m_IsCapturing.store(true, std::memory_order_relaxed);
+}
+
+void aZero::Profiling::Profiler::EndCapture()
+{
+	m_IsCapturing.store(false, std::memory_order_relaxed);
+}
+
+uint64_t aZero::Profiling::Profiler::BeginMarker()
+{
+	this->GetThreadBuffer().Depth++;
+	return this->GetTimeNs();
+}
+
+void aZero::Profiling::Profiler::EndMarker(const char* name, uint64_t startNs)
+{
+	const uint64_t endNs = this->GetTimeNs();
+	ThreadBuffer& buffer = this->GetThreadBuffer();
+	buffer.Depth--;
+
+	std::lock_guard<std::mutex> lock(buffer.Lock);
+	if (buffer.Events.size() < MaxEventsPerThread)
+	{
+		buffer.Events.push_back({ name, startNs, endNs, buffer.Depth });
+	}
+	else
+	{
+		buffer.NumDropped++;
+	}
+}
+
+void aZero::Profiling::Profiler::SetThreadName(const std::string& name)
+{
+	ThreadBuffer& buffer = this->GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(m_ThreadsLock);
+	buffer.Name = name;
+}
+
+void aZero::Profiling::Profiler::BeginFrame()
+{
+	std::lock_guard<std::mutex> lock(m_FrameLock);
+	m_FrameStartNs = this->GetTimeNs();
+}
+
+aZero::Profiling::FrameStats aZero::Profiling::Profiler::EndFrame()
+{
+	FrameStats stats;
+	stats.EndNs = this->GetTimeNs();
+	for (uint32_t counter = 0; counter < NumCounters; counter++)
+	{
+		stats.Counters[counter] = m_Counters[counter].exchange(0, std::memory_order_relaxed);
+	}
+
+	std::lock_guard<std::mutex> lock(m_FrameLock);
+	stats.FrameIndex = m_FrameIndex++;
+	stats.StartNs = m_FrameStartNs;
+
+	// The next frame starts here unless BeginFrame() is called
+	m_FrameStartNs = stats.EndNs;
+
+	if (m_FrameHistory.size() < FrameHistorySize)
+	{
+		m_FrameHistory.push_back(stats);
+	}
+	else
+	{
+		m_FrameHistory[m_FrameHistoryStart] = stats;
+		m_FrameHistoryStart = (m_FrameHistoryStart + 1) % FrameHistorySize;
+	}
+
+	if (this->IsCapturing())
+	{
+		m_CapturedFrames.push_back(stats);
+	}
+
+	return stats;
+}
+
+std::vector<aZero::Profiling::FrameStats> aZero::Profiling::Profiler::GetFrameHistory() const
+{
+	std::lock_guard<std::mutex> lock(m_FrameLock);
+	std::vector<FrameStats> history;
+	history.reserve(m_FrameHistory.size());
+	for (size_t frame = 0; frame < m_FrameHistory.size(); frame++)
+	{
+		history.push_back(m_FrameHistory[(m_FrameHistoryStart + frame) % m_FrameHistory.size()]);
+	}
+	return history;
+}
+
+std::vector<aZero::Profiling::ProfileEvent> aZero::Profiling::Profiler::GetThreadEvents()
+{
+	ThreadBuffer& buffer = this->GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(buffer.Lock);
+	return buffer.Events;
+}
+
+uint64_t aZero::Profiling::Profiler::GetNumDroppedEvents() const
+{
+	std::lock_guard<std::mutex> lock(m_ThreadsLock);
+	uint64_t numDropped = 0;
+	for (const std::unique_ptr<ThreadBuffer>& thread : m_Threads)
+	{
+		std::lock_guard<std::mutex> threadLock(thread->Lock);
+		numDropped += thread->NumDropped;
+	}
+	return numDropped;
+}
+
+bool aZero::Profiling::Profiler::ExportChromeTrace(const std::string& path) const
+{
+	std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	AppendThreadName(json, 0, "Frames");
+
+	{
+		std::lock_guard<std::mutex> lock(m_ThreadsLock);
+		for (const std::unique_ptr<ThreadBuffer>& thread : m_Threads)
+		{
+			AppendThreadName(json, thread->ThreadIndex, thread->Name);
+
+			std::lock_guard<std::mutex> threadLock(thread->Lock);
+			for (const ProfileEvent& event : thread->Events)
+			{
+				AppendCompleteEvent(json, event.Name, thread->ThreadIndex, event.StartNs, event.EndNs);
+			}
+		}
+	}
+
+	{
+		// Each counter is shown as a step that holds the value of the frame for its duration
+		std::lock_guard<std::mutex> lock(m_FrameLock);
+		for (const FrameStats& frame : m_CapturedFrames)
+		{
+			const std::string frameName = "Frame " + std::to_string(frame.FrameIndex);
+			AppendCompleteEvent(json, frameName.c_str(), 0, frame.StartNs, frame.EndNs);
+
+			for (uint32_t counter = 0; counter < NumCounters; counter++)
+			{
+				json += "{\"name\":\"";
+				json += GetCounterName(static_cast<Counter>(counter));
+				json += "\",\"ph\":\"C\",\"pid\":1,\"ts\":";
+				AppendMicroseconds(json, frame.StartNs);
+				json += ",\"args\":{\"value\":" + std::to_string(frame.Counters[counter]) + "}},\n";
+			}
+		}
+	}
+
+	// Every event above ends with a comma, so close with the process name
+	json += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"aZeroEngine\"}}\n]}\n";
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		return false;
+	}
+
+	file.write(json.data(), static_cast<std::streamsize>(json.size()));
+	return file.good();
+}
+
+aZero::Profiling::Profiler& aZero::Profiling::GetProfiler()
+{
+	static Profiler profiler;
+	return profiler;
+}
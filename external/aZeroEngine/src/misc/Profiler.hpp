@@ -0,0 +1,235 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "NonCopyable.hpp"
+#include "NonMovable.hpp"
+
+namespace aZero
+{
+	namespace Profiling
+	{
+		/** @brief Counters that are summed over a frame and reset by Profiler::EndFrame() */
+		enum class Counter : uint32_t
+		{
+			// Bytes packed into the staging buffer by LinearFrameAllocator
+			StagedBytes,
+
+			// Copies recorded by LinearFrameAllocator after merging the writes
+			CopyRegions,
+
+			// SceneProxy::Update*() calls
+			ProxyUpdates,
+
+			// Static mesh instances uploaded for the frame
+			Instances,
+
+			// Static mesh instances that passed SceneProxy::CullStaticMeshes(), summed over the calls
+			VisibleInstances,
+
+			NumCounters
+		};
+
+		constexpr uint32_t NumCounters = static_cast<uint32_t>(Counter::NumCounters);
+
+		const char* GetCounterName(Counter counter);
+
+		struct FrameStats
+		{
+			uint64_t FrameIndex = 0;
+
+			// Nanoseconds since the profiler was created
+			uint64_t StartNs = 0;
+			uint64_t EndNs = 0;
+
+			std::array<uint64_t, NumCounters> Counters{};
+
+			double GetMilliseconds() const { return static_cast<double>(EndNs - StartNs) / 1000000.0; }
+			uint64_t Get(Counter counter) const { return Counters[static_cast<uint32_t>(counter)]; }
+		};
+
+		struct ProfileEvent
+		{
+			// Not copied, has to outlive the profiler (ex. a string literal)
+			const char* Name = nullptr;
+			uint64_t StartNs = 0;
+			uint64_t EndNs = 0;
+
+			// Number of markers that were open on the thread when this one started
+			uint32_t Depth = 0;
+		};
+
+		/** @brief Scoped CPU timing markers and per-frame counters.
+		* Markers are recorded into a buffer per thread, so recording threads never wait on each other. A buffer is only locked against captures and exports.
+		* Markers are only kept while capturing. Counters and the frame stats history are always kept.
+		* Use the PROFILE_* macros at the bottom of the file, they compile out unless USE_PROFILER is set which is the case for debug builds.
+		*/
+		class Profiler : public NonCopyable, public NonMovable
+		{
+		public:
+			// Markers beyond this are dropped and counted, bounds the memory of long captures
+			static constexpr size_t MaxEventsPerThread = 1 << 20;
+
+			static constexpr size_t FrameHistorySize = 256;
+
+		private:
+			struct ThreadBuffer
+			{
+				std::thread::id ThreadID;
+				uint32_t ThreadIndex = 0;
+				std::string Name;
+
+				std::mutex Lock;
+				std::vector<ProfileEvent> Events;
+				uint64_t NumDropped = 0;
+
+				// Only touched by the owning thread
+				uint32_t Depth = 0;
+			};
+
+			// Tells the per-thread buffer caches of different profilers apart
+			const uint64_t m_ID;
+			const std::chrono::steady_clock::time_point m_Epoch = std::chrono::steady_clock::now();
+
+			std::atomic<bool> m_IsCapturing = false;
+
+			// Owned by the profiler so the markers of threads that have exited can still be exported
+			mutable std::mutex m_ThreadsLock;
+			std::vector<std::unique_ptr<ThreadBuffer>> m_Threads;
+
+			std::array<std::atomic<uint64_t>, NumCounters> m_Counters{};
+
+			mutable std::mutex m_FrameLock;
+			uint64_t m_FrameIndex = 0;
+			uint64_t m_FrameStartNs = 0;
+			std::vector<FrameStats> m_FrameHistory;
+			size_t m_FrameHistoryStart = 0;
+			std::vector<FrameStats> m_CapturedFrames;
+
+			ThreadBuffer& GetThreadBuffer();
+
+		public:
+			Profiler();
+
+			uint64_t GetTimeNs() const
+			{
+				return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_Epoch).count());
+			}
+
+			/** Clears the markers of the previous capture and starts recording new ones
+			@return void
+			*/
+			void BeginCapture();
+			void EndCapture();
+			bool IsCapturing() const { return m_IsCapturing.load(std::memory_order_relaxed); }
+
+			/** Opens a marker on the calling thread
+			@return uint64_t The start time to pass to EndMarker()
+			*/
+			uint64_t BeginMarker();
+
+			/** Closes the latest marker opened on the calling thread
+			@param name Has to outlive the profiler
+			@param startNs
+			@return void
+			*/
+			void EndMarker(const char* name, uint64_t startNs);
+
+			/** Names the calling thread in the exported trace
+			@param name
+			@return void
+			*/
+			void SetThreadName(const std::string& name);
+
+			void AddCounter(Counter counter, uint64_t value)
+			{
+				m_Counters[static_cast<uint32_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+			}
+
+			uint64_t GetCounter(Counter counter) const
+			{
+				return m_Counters[static_cast<uint32_t>(counter)].load(std::memory_order_relaxed);
+			}
+
+			void BeginFrame();
+
+			/** Moves the counters of the frame into the frame stats history and resets them
+			@return FrameStats
+			*/
+			FrameStats EndFrame();
+
+			/** Returns the stats of the latest finished frames, oldest first
+			@return std::vector<FrameStats>
+			*/
+			std::vector<FrameStats> GetFrameHistory() const;
+
+			/** Returns the markers of the calling thread that are recorded so far in the capture
+			@return std::vector<ProfileEvent>
+			*/
+			std::vector<ProfileEvent> GetThreadEvents();
+
+			uint64_t GetNumDroppedEvents() const;
+
+			/** Writes the markers and the counters of the frames of the capture as Chrome trace JSON, viewable in chrome://tracing or Perfetto
+			@param path
+			@return bool False if the file couldn't be written
+			*/
+			bool ExportChromeTrace(const std::string& path) const;
+		};
+
+		Profiler& GetProfiler();
+
+		/** @brief Times its own lifetime on the calling thread if the profiler is capturing */
+		class ScopedMarker : public NonCopyable, public NonMovable
+		{
+		private:
+			const char* m_Name;
+			uint64_t m_StartNs = 0;
+			bool m_IsRecording = false;
+
+		public:
+			ScopedMarker(const char* name)
+				:m_Name(name)
+			{
+				Profiler& profiler = GetProfiler();
+				if (profiler.IsCapturing())
+				{
+					m_IsRecording = true;
+					m_StartNs = profiler.BeginMarker();
+				}
+			}
+
+			~ScopedMarker()
+			{
+				if (m_IsRecording)
+				{
+					GetProfiler().EndMarker(m_Name, m_StartNs);
+				}
+			}
+		};
+	}
+}
+
+#define PROFILE_CONCAT_INNER(A, B) A##B
+#define PROFILE_CONCAT(A, B) PROFILE_CONCAT_INNER(A, B)
+
+#if USE_PROFILER
+// Name has to outlive the profiler, ex. a string literal
+#define PROFILE_SCOPE(Name) const aZero::Profiling::ScopedMarker PROFILE_CONCAT(profileMarker, __LINE__)(Name)
+#define PROFILE_COUNTER(CounterName, Value) aZero::Profiling::GetProfiler().AddCounter(aZero::Profiling::Counter::CounterName, static_cast<uint64_t>(Value))
+#define PROFILE_THREAD_NAME(Name) aZero::Profiling::GetProfiler().SetThreadName(Name)
+#define PROFILE_BEGIN_FRAME() aZero::Profiling::GetProfiler().BeginFrame()
+#define PROFILE_END_FRAME() aZero::Profiling::GetProfiler().EndFrame()
+#else
+#define PROFILE_SCOPE(Name) do { } while(0)
+#define PROFILE_COUNTER(CounterName, Value) do { } while(0)
+#define PROFILE_THREAD_NAME(Name) do { } while(0)
+#define PROFILE_BEGIN_FRAME() do { } while(0)
+#define PROFILE_END_FRAME() do { } while(0)
+#endif
@@ -3,4 +3,6 @@
 #define SHADER_CACHED_RELATIVE_PATH std::string("shaderCache/")
 #define MESH_ASSET_RELATIVE_PATH std::string("assets/meshes/")
 #define TEXTURE_ASSET_RELATIVE_PATH std::string("assets/textures/")
-#define AUDIO_ASSET_RELATIVE_PATH std::string("assets/audio/")
\ No newline at end of file
+#define AUDIO_ASSET_RELATIVE_PATH std::string("assets/audio/")
+#define MESH_CACHED_RELATIVE_PATH std::string("meshCache/")
+#define TEXTURE_CACHED_RELATIVE_PATH std::string("textureCache/")
\ No newline at end of file
@@ -1,114 +1,134 @@
 #pragma once
-#include <unordered_map>
 #include <span>
+#include "PagedSparseIndex.hpp"
 
 namespace aZero
 {
 	namespace DataStructures
 	{
+		/** @brief Dense array of elements that are addressed by sparse IDs.
+		* The elements are always tightly packed in [0, Size()) so GetData() can be uploaded as is.
+		* ID => slot goes through a paged sparse index and slot => ID is a dense array, so adding, updating and removing never hashes.
+		* Once the capacity has been reached no operation allocates, except when an ID lands in a page that hasn't been used before.
+		* NOTE: Removing swaps the last element into the removed slot, so the order of the elements isn't stable.
+		*/
 		template<typename IDType, typename Type>
 		class SparseMappedVector
 		{
 		private:
-			std::unordered_map<IDType, uint32_t> m_ID_To_Index;
-			std::unordered_map<uint32_t, IDType> m_Index_To_ID;
+			DS::PagedSparseIndex<IDType> m_ID_To_Index;
+			std::vector<IDType> m_Index_To_ID;
 			std::vector<Type> m_Data;
-			uint32_t m_CurrentLastIndex = 0;
 
-		public:
-			SparseMappedVector() = default;
-
-			void AddOrUpdate(IDType ID, Type&& Primitive)
+			template<typename PrimitiveType>
+			void AddOrUpdateInternal(IDType ID, PrimitiveType&& Primitive)
 			{
-				if (auto Index = m_ID_To_Index.find(ID); Index != m_ID_To_Index.end())
+				const uint32_t Index = m_ID_To_Index.Get(ID);
+				if (Index != DS::PagedSparseIndex<IDType>::InvalidIndex)
 				{
-					m_Data.at(Index->second) = Primitive;
+					m_Data[Index] = std::forward<PrimitiveType>(Primitive);
 				}
 				else
 				{
-					m_ID_To_Index[ID] = m_CurrentLastIndex;
-					m_Index_To_ID[m_CurrentLastIndex] = ID;
-
-					if (m_Data.size() > m_CurrentLastIndex)
-					{
-						m_Data.at(m_CurrentLastIndex) = Primitive;
-					}
-					else
-					{
-						m_Data.emplace_back(Primitive);
-					}
-					m_CurrentLastIndex++;
+					m_ID_To_Index.Set(ID, static_cast<uint32_t>(m_Data.size()));
+					m_Data.emplace_back(std::forward<PrimitiveType>(Primitive));
+					m_Index_To_ID.emplace_back(ID);
 				}
 			}
 
+		public:
+			SparseMappedVector() = default;
+
+			void AddOrUpdate(IDType ID, Type&& Primitive)
+			{
+				this->AddOrUpdateInternal(ID, std::move(Primitive));
+			}
+
 			void AddOrUpdate(IDType ID, const Type& Primitive)
 			{
-				if (auto Index = m_ID_To_Index.find(ID); Index != m_ID_To_Index.end())
-				{
-					m_Data.at(Index->second) = Primitive;
-				}
-				else
-				{
-					m_ID_To_Index[ID] = m_CurrentLastIndex;
-					m_Index_To_ID[m_CurrentLastIndex] = ID;
-
-					if (m_Data.size() > m_CurrentLastIndex)
-					{
-						m_Data.at(m_CurrentLastIndex) = Primitive;
-					}
-					else
-					{
-						m_Data.emplace_back(Primitive);
-					}
-					m_CurrentLastIndex++;
-				}
+				this->AddOrUpdateInternal(ID, Primitive);
 			}
 
 			void Remove(IDType ID)
 			{
-				if (auto Index = m_ID_To_Index.find(ID); Index != m_ID_To_Index.end())
+				const uint32_t RemovedIndex = m_ID_To_Index.Get(ID);
+				if (RemovedIndex == DS::PagedSparseIndex<IDType>::InvalidIndex)
 				{
-					if (Index->second != m_CurrentLastIndex)
-					{
-						// Copy last element index data to removed index data
-						const uint32_t LastElementIndex = m_CurrentLastIndex - 1;
-						m_Data[Index->second] = std::move(m_Data.at(LastElementIndex));
-
-						m_Data.at(LastElementIndex) = Type(); // Reset
-
-						// Remap entity=>index map so moved entityid points to removed index
-						const IDType LastID = m_Index_To_ID.at(LastElementIndex);
-						m_ID_To_Index.at(LastID) = Index->second;
-
-						// Remap so that index=>entity map so removed index points to last entity
-						m_Index_To_ID.at(Index->second) = LastID;
+					return;
+				}
 
-						// Remove old entity id from entity=>index map
-						m_ID_To_Index.erase(ID);
+				const uint32_t LastIndex = static_cast<uint32_t>(m_Data.size() - 1);
+				if (RemovedIndex != LastIndex)
+				{
+					// Move the last element into the hole and remap its ID
+					const IDType LastID = m_Index_To_ID[LastIndex];
+					m_Data[RemovedIndex] = std::move(m_Data[LastIndex]);
+					m_Index_To_ID[RemovedIndex] = LastID;
+					m_ID_To_Index.Set(LastID, RemovedIndex);
+				}
 
-						// Remove last index from index=>entity
-						m_Index_To_ID.erase(LastElementIndex);
-					}
-					else
-					{
-						m_Data.at(Index->second) = Type(); // Reset
-					}
+				m_Data.pop_back();
+				m_Index_To_ID.pop_back();
+				m_ID_To_Index.Reset(ID);
+			}
 
-					m_CurrentLastIndex--;
-				}
+			/** Reserves space in the dense arrays so that adding up to numElements doesn't allocate
+			@param numElements
+			@return void
+			*/
+			void Reserve(uint32_t numElements)
+			{
+				m_Data.reserve(numElements);
+				m_Index_To_ID.reserve(numElements);
 			}
 
 			void ShrinkToFit()
 			{
-				if (m_CurrentLastIndex)
+				m_Data.shrink_to_fit();
+				m_Index_To_ID.shrink_to_fit();
+			}
+
+			void Clear()
+			{
+				for (const IDType ID : m_Index_To_ID)
 				{
-					m_Data.resize(m_CurrentLastIndex);
+					m_ID_To_Index.Reset(ID);
 				}
+				m_Data.clear();
+				m_Index_To_ID.clear();
 			}
 
+			const Type* Find(IDType ID) const
+			{
+				const uint32_t Index = m_ID_To_Index.Get(ID);
+				return Index != DS::PagedSparseIndex<IDType>::InvalidIndex ? &m_Data[Index] : nullptr;
+			}
+
+			/** Returns the index of the ID's element in GetData(), or InvalidIndex if the ID has no element.
+			* The index changes when other elements are removed.
+			@param ID
+			@return uint32_t
+			*/
+			uint32_t GetIndex(IDType ID) const { return m_ID_To_Index.Get(ID); }
+
+			/** Returns the tightly packed elements. The element at index i belongs to GetIDs()[i].
+			@return const std::vector<Type>&
+			*/
 			const std::vector<Type>& GetData() const { return m_Data; }
 
-			bool Contains(const IDType& ID) const { return m_ID_To_Index.contains(ID); }
+			std::span<const IDType> GetIDs() const { return m_Index_To_ID; }
+
+			uint32_t Size() const { return static_cast<uint32_t>(m_Data.size()); }
+
+			bool Contains(const IDType& ID) const { return m_ID_To_Index.Contains(ID); }
+
+			/** Returns the number of bytes allocated by the dense arrays and the sparse index
+			@return size_t
+			*/
+			size_t GetMemoryUsage() const
+			{
+				return m_Data.capacity() * sizeof(Type) + m_Index_To_ID.capacity() * sizeof(IDType) + m_ID_To_Index.GetMemoryUsage();
+			}
 		};
 	}
-}
\ No newline at end of file
+}
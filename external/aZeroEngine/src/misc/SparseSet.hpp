@@ -1,6 +1,8 @@
 #pragma once
 #include <vector>
 #include <optional>
+#include <span>
+#include "PagedSparseIndex.hpp"
 
 namespace aZero
 {
@@ -15,6 +17,7 @@ namespace aZero
 		/// <summary>
 		/// A sparse set. 
 		/// Maps IDs to elements in a dense array.
+		/// The ID to element mapping is paged, pages are allocated when an ID in their range is added and released once they no longer map any ID.
 		/// </summary>
 		/// <typeparam name="ElementType">Type of the elements</typeparam>
 		/// <typeparam name="IDType">Type of the IDs</typeparam>
@@ -23,16 +26,10 @@ namespace aZero
 		{
 		private:
 
-			/// <summary>
-			/// The last value of IDType is used for checking if the index is valid or not.
-			/// This reduces the cost of "exist" checks by moving it into the resize and removal sections.
-			/// </summary>
-			static constexpr IDType m_EmptyIndex{ std::numeric_limits<IDType>::max() };
-
 			/// <summary>
 			/// Maps IDs to the element indices in the dense array.
 			/// </summary>
-			std::vector<IDType> m_ID_To_Element;
+			PagedSparseIndex<IDType> m_ID_To_Element;
 
 			/// <summary>
 			/// Maps the element indices in the dense array to the IDs.
@@ -67,7 +64,8 @@ namespace aZero
 
 			void Init(IDType NumElements)
 			{
-				m_ID_To_Element.resize(NumElements, m_EmptyIndex);
+				m_ID_To_Element.Clear();
+				m_ID_To_Element.Reserve(NumElements);
 				m_Element_To_ID.resize(0);
 				m_Elements.resize(0);
 				m_CurrentLast = 0;
@@ -93,7 +91,7 @@ namespace aZero
 						m_Elements.push_back(Element);
 						m_Element_To_ID.push_back(ID);
 					}
-					m_ID_To_Element.at(ID) = m_CurrentLast;
+					m_ID_To_Element.Set(ID, m_CurrentLast);
 					m_CurrentLast++;
 				}
 			}
@@ -118,7 +116,7 @@ namespace aZero
 						m_Elements.push_back(std::move(Element));
 						m_Element_To_ID.push_back(ID);
 					}
-					m_ID_To_Element.at(ID) = m_CurrentLast;
+					m_ID_To_Element.Set(ID, m_CurrentLast);
 					m_CurrentLast++;
 				}
 			}
@@ -132,15 +130,15 @@ namespace aZero
 				if (this->Exists(ID))
 				{
 					const IDType LastIndex = m_CurrentLast - 1;
-					const IDType RemovedElementIndex = m_ID_To_Element.at(ID);
+					const IDType RemovedElementIndex = m_ID_To_Element.Get(ID);
 					if (RemovedElementIndex != LastIndex)
 					{
 						m_Elements.at(RemovedElementIndex) = std::move(m_Elements.at(LastIndex));
 						const IDType LastElementID = m_Element_To_ID.at(LastIndex);
-						m_ID_To_Element.at(LastElementID) = RemovedElementIndex;
+						m_ID_To_Element.Set(LastElementID, RemovedElementIndex);
 						m_Element_To_ID.at(RemovedElementIndex) = LastElementID;
 					}
-					m_ID_To_Element.at(ID) = m_EmptyIndex;
+					m_ID_To_Element.Reset(ID, true);
 					m_CurrentLast--;
 				}
 			}
@@ -154,7 +152,7 @@ namespace aZero
 			/// <returns></returns>
 			ElementType& Get(IDType ID)
 			{
-				const IDType elementIndex = m_ID_To_Element.at(ID);
+				const uint32_t elementIndex = m_ID_To_Element.Get(ID);
 				return m_Elements.at(elementIndex);
 			}
 
@@ -167,7 +165,7 @@ namespace aZero
 			/// <returns></returns>
 			const ElementType& Get(IDType ID) const
 			{
-				const IDType elementIndex = m_ID_To_Element.at(ID);
+				const uint32_t elementIndex = m_ID_To_Element.Get(ID);
 				return m_Elements.at(elementIndex);
 			}
 
@@ -182,7 +180,7 @@ namespace aZero
 			{
 				if (this->Exists(ID))
 				{
-					return std::optional<std::reference_wrapper<ElementType>>{std::ref(m_Elements.at(m_ID_To_Element.at(ID)))};
+					return std::optional<std::reference_wrapper<ElementType>>{std::ref(m_Elements.at(m_ID_To_Element.Get(ID)))};
 				}
 				else
 				{
@@ -201,7 +199,7 @@ namespace aZero
 			{
 				if (this->Exists(ID))
 				{
-					return std::optional<std::reference_wrapper<const ElementType>>{std::ref(m_Elements.at(m_ID_To_Element.at(ID)))};
+					return std::optional<std::reference_wrapper<const ElementType>>{std::ref(m_Elements.at(m_ID_To_Element.Get(ID)))};
 				}
 				else
 				{
@@ -209,6 +207,46 @@ namespace aZero
 				}
 			}
 
+			/// <summary>
+			/// Fetches a pointer to the entry with a single lookup.
+			/// Returns nullptr if the ID doesn't have an entry.
+			/// NOTE: Pointer might become invalid after certain operations on the SparseSet.
+			/// </summary>
+			/// <param name="ID">ID to get the entry for</param>
+			/// <returns></returns>
+			ElementType* Find(IDType ID)
+			{
+				const uint32_t elementIndex = m_ID_To_Element.Get(ID);
+				return elementIndex != PagedSparseIndex<IDType>::InvalidIndex ? &m_Elements[elementIndex] : nullptr;
+			}
+
+			/// <summary>
+			/// Fetches a const pointer to the entry with a single lookup.
+			/// Returns nullptr if the ID doesn't have an entry.
+			/// NOTE: Pointer might become invalid after certain operations on the SparseSet.
+			/// </summary>
+			/// <param name="ID">ID to get the entry for</param>
+			/// <returns></returns>
+			const ElementType* Find(IDType ID) const
+			{
+				const uint32_t elementIndex = m_ID_To_Element.Get(ID);
+				return elementIndex != PagedSparseIndex<IDType>::InvalidIndex ? &m_Elements[elementIndex] : nullptr;
+			}
+
+			/// <summary>
+			/// Returns the IDs of the live entries in dense order.
+			/// The ID at index i owns the element at index i in the dense array.
+			/// </summary>
+			/// <returns></returns>
+			std::span<const IDType> GetIDs() const { return std::span<const IDType>(m_Element_To_ID.data(), m_CurrentLast); }
+
+			/// <summary>
+			/// Returns the number of live entries.
+			/// NOTE: The dense array returned by GetData() can be larger since removed slots are reused instead of freed.
+			/// </summary>
+			/// <returns></returns>
+			IDType Size() const { return m_CurrentLast; }
+
 			/// <summary>
 			/// Returns a reference to the contiguous array of elements.
 			/// </summary>
@@ -228,11 +266,20 @@ namespace aZero
 			/// <returns></returns>
 			bool Exists(IDType ID) const
 			{
-				if (ID >= m_ID_To_Element.size())
-					return false;
+				return m_ID_To_Element.Contains(ID);
+			}
 
-				const IDType elementIndex = m_ID_To_Element.at(ID);
-				return elementIndex != m_EmptyIndex;
+			/// <summary>
+			/// Removes all entries while keeping the allocated memory, including the pages.
+			/// Only touches the sparse slots of the live entries, so the cost scales with Size() instead of the largest ID.
+			/// </summary>
+			void Clear()
+			{
+				for (IDType index = 0; index < m_CurrentLast; index++)
+				{
+					m_ID_To_Element.Reset(m_Element_To_ID[index]);
+				}
+				m_CurrentLast = 0;
 			}
 
 			/// <summary>
@@ -247,25 +294,22 @@ namespace aZero
 			}
 
 			/// <summary>
-			/// Resizes the SparseSet so it supports the input number of entries.
-			/// Nothing is done if the input number of entries is less or equal than the current max.
+			/// Grows the page table so it covers the input number of IDs.
+			/// Pages are still allocated on demand, and any ID can be added without calling this first.
 			/// </summary>
 			/// <param name="NumElements">Number of entries to support</param>
 			void ExtendTo(IDType NumEntries)
 			{
-				if (NumEntries > m_ID_To_Element.size())
-				{
-					m_ID_To_Element.resize(NumEntries, m_EmptyIndex);
-				}
+				m_ID_To_Element.Reserve(NumEntries);
 			}
 
 			/// <summary>
-			/// Returns how many entries the SparseSet supports.
+			/// Returns how many IDs the page table currently covers.
 			/// </summary>
 			/// <returns></returns>
 			IDType NumSupportedElements() const
 			{
-				return m_ID_To_Element.size();
+				return static_cast<IDType>(m_ID_To_Element.GetNumCoveredIDs());
 			}
 
 			/// <summary>
@@ -278,7 +322,25 @@ namespace aZero
 				return m_Elements.capacity();
 			}
 
-			IDType GetElementIndex(IDType ID) const { return m_ID_To_Element.at(ID); }
+			/// <summary>
+			/// Returns the number of bytes allocated by the sparse pages and the dense arrays.
+			/// </summary>
+			/// <returns></returns>
+			size_t GetMemoryUsage() const
+			{
+				return m_ID_To_Element.GetMemoryUsage() + m_Element_To_ID.capacity() * sizeof(IDType) + m_Elements.capacity() * sizeof(ElementType);
+			}
+
+			/// <summary>
+			/// Returns the number of bytes allocated by the sparse pages and the page table.
+			/// </summary>
+			/// <returns></returns>
+			size_t GetSparseMemoryUsage() const
+			{
+				return m_ID_To_Element.GetMemoryUsage();
+			}
+
+			IDType GetElementIndex(IDType ID) const { return m_ID_To_Element.Get(ID); }
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+namespace aZero
+{
+	namespace DS
+	{
+		/** @brief Fixed capacity Chase-Lev deque of pointers.
+		* The owning thread pushes and pops at the bottom without locks, other threads steal from the top.
+		* Only the last remaining element needs a compare-exchange between the owner and the thieves.
+		*/
+		template<typename Type>
+		class WorkStealingDeque
+		{
+		private:
+			std::unique_ptr<std::atomic<Type*>[]> m_Buffer;
+			int64_t m_Mask = 0;
+
+			// On separate cache lines since the owner writes m_Bottom and thieves write m_Top
+			alignas(64) std::atomic<int64_t> m_Top = 0;
+			alignas(64) std::atomic<int64_t> m_Bottom = 0;
+
+		public:
+			/** @param capacity Rounded up to a power of two */
+			WorkStealingDeque(uint32_t capacity)
+			{
+				uint32_t powerOfTwo = 1;
+				while (powerOfTwo < capacity)
+				{
+					powerOfTwo <<= 1;
+				}
+
+				m_Buffer = std::make_unique<std::atomic<Type*>[]>(powerOfTwo);
+				m_Mask = static_cast<int64_t>(powerOfTwo) - 1;
+			}
+
+			/** Pushes an element at the bottom. Only called by the owning thread.
+			@param element
+			@return bool False if the deque is full
+			*/
+			bool Push(Type* element)
+			{
+				const int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+				const int64_t top = m_Top.load(std::memory_order_acquire);
+				if (bottom - top > m_Mask)
+				{
+					return false;
+				}
+
+				m_Buffer[bottom & m_Mask].store(element, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_release);
+				m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+				return true;
+			}
+
+			/** Pops the most recently pushed element. Only called by the owning thread.
+			@return Type* nullptr if the deque is empty
+			*/
+			Type* Pop()
+			{
+				const int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+				m_Bottom.store(bottom, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				int64_t top = m_Top.load(std::memory_order_relaxed);
+
+				if (top > bottom)
+				{
+					m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+					return nullptr;
+				}
+
+				Type* element = m_Buffer[bottom & m_Mask].load(std::memory_order_relaxed);
+				if (top == bottom)
+				{
+					// Last element, race the thieves for it
+					if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					{
+						element = nullptr;
+					}
+					m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+				}
+				return element;
+			}
+
+			/** Steals the oldest element. Can be called by any thread.
+			@return Type* nullptr if the deque is empty or another thread won the race
+			*/
+			Type* Steal()
+			{
+				int64_t top = m_Top.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				const int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+				if (top >= bottom)
+				{
+					return nullptr;
+				}
+
+				Type* element = m_Buffer[top & m_Mask].load(std::memory_order_relaxed);
+				if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				{
+					return nullptr;
+				}
+				return element;
+			}
+
+			bool IsEmpty() const
+			{
+				return m_Bottom.load(std::memory_order_relaxed) <= m_Top.load(std::memory_order_relaxed);
+			}
+		};
+	}
+}
@@ -21,10 +21,7 @@ bool aZero::Pipeline::ComputeShaderPass::CreatePipelineState(ID3D12DeviceX* devi
 	} stream = {};
 
 	stream.RootSignature = rootSignature.Get();
-	stream.CS = {
-	reinterpret_cast<BYTE*>(computeShader.m_CompiledShader->GetBufferPointer()),
-	computeShader.m_CompiledShader->GetBufferSize()
-	};
+	stream.CS = computeShader.GetBytecode();
 
 	D3D12_PIPELINE_STATE_STREAM_DESC streamDesc = {};
 	streamDesc.pPipelineStateSubobjectStream = &stream;
@@ -34,16 +34,10 @@ bool aZero::Pipeline::MeshShaderPass::CreatePipelineState(ID3D12DeviceX* device,
 	if (amplificationShader.has_value())
 	{
 		Pipeline::AmplificationShader& as = *amplificationShader.value();
-		stream.AS = {
-		reinterpret_cast<BYTE*>(as.m_CompiledShader->GetBufferPointer()),
-		as.m_CompiledShader->GetBufferSize()
-		};
+		stream.AS = as.GetBytecode();
 	}
 
-	stream.MS = {
-		reinterpret_cast<BYTE*>(meshShader.m_CompiledShader->GetBufferPointer()),
-		meshShader.m_CompiledShader->GetBufferSize()
-	};
+	stream.MS = meshShader.GetBytecode();
 
 	stream.SampleDesc = { 1, 0 };
 
@@ -64,10 +58,7 @@ bool aZero::Pipeline::MeshShaderPass::CreatePipelineState(ID3D12DeviceX* device,
 		stream.DepthStencil = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
 
 		Pipeline::PixelShader& ps = *pixelShader.value();
-		stream.PS = {
-		reinterpret_cast<BYTE*>(ps.m_CompiledShader->GetBufferPointer()),
-		ps.m_CompiledShader->GetBufferSize()
-		};
+		stream.PS = ps.GetBytecode();
 
 		if (ps.NumRenderTargets() != description.m_RenderTargets.size())
 		{
@@ -71,10 +71,7 @@ bool aZero::Pipeline::VertexShaderPass::CreatePipelineState(ID3D12DeviceX* devic
 			}
 		}
 
-		pipelineStateDesc.PS = {
-		reinterpret_cast<BYTE*>(pixelShaderRef.m_CompiledShader->GetBufferPointer()),
-		pixelShaderRef.m_CompiledShader->GetBufferSize()
-		};
+		pipelineStateDesc.PS = pixelShaderRef.GetBytecode();
 	}
 
 	// TODO: wrong usage of the depth?
@@ -90,10 +87,7 @@ bool aZero::Pipeline::VertexShaderPass::CreatePipelineState(ID3D12DeviceX* devic
 		pipelineStateDesc.DSVFormat = description.m_DepthStencil.m_Format;
 	}
 
-	pipelineStateDesc.VS = {
-		reinterpret_cast<BYTE*>(vertexShader.m_CompiledShader->GetBufferPointer()),
-		vertexShader.m_CompiledShader->GetBufferSize()
-	};
+	pipelineStateDesc.VS = vertexShader.GetBytecode();
 
 	const HRESULT res = device->CreateGraphicsPipelineState(&pipelineStateDesc, IID_PPV_ARGS(&pipelineState));
 	if (FAILED(res))
@@ -22,7 +22,6 @@ namespace aZero
 			ComputeShader(ComputeShader&& other) noexcept;
 			ComputeShader& operator=(ComputeShader&& other) noexcept;
 
-			bool CompileFromFile(IDxcCompilerX& compiler, const std::string& path) override;
 			[[nodiscard]] ThreadGroup GetThreadGroups() const { return m_ThreadGroupCount; }
 
 		private:
@@ -31,9 +30,11 @@ namespace aZero
 
 			ThreadGroup m_ThreadGroupCount;
 
-			bool ValidateShaderTypeFromFilepath(const std::string& path) override;
+			bool ValidateShaderTypeFromFilepath(const std::string& path) const override;
+			const char* GetTargetProfile() const override { return m_TargetSM; }
+			D3D12_SHADER_VISIBILITY GetShaderVisibility() const override { return D3D12_SHADER_VISIBILITY::D3D12_SHADER_VISIBILITY_ALL; }
 
-			bool Reflect(Microsoft::WRL::ComPtr<IDxcResult>& compilationResult, Microsoft::WRL::ComPtr<IDxcUtils>& utils);
+			bool ApplyReflection(const ShaderReflection& reflection) override;
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,257 @@
+#include "DxcShaderCompiler.hpp"
+#include "misc/HelperFunctions.hpp"
+#include <filesystem>
+#include <fstream>
+
+aZero::Pipeline::DxcShaderCompiler::DxcShaderCompiler()
+{
+	m_Identifier = "dxc";
+
+	Microsoft::WRL::ComPtr<IDxcVersionInfo> versionInfo;
+	if (SUCCEEDED(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(versionInfo.GetAddressOf()))))
+	{
+		UINT32 major = 0;
+		UINT32 minor = 0;
+		versionInfo->GetVersion(&major, &minor);
+		m_Identifier += "-" + std::to_string(major) + "." + std::to_string(minor);
+	}
+
+	// The debug build adds debug info and disables optimizations
+#if USE_DEBUG
+	m_Identifier += "-debug";
+#else
+	m_Identifier += "-release";
+#endif
+}
+
+bool aZero::Pipeline::DxcShaderCompiler::Compile(const ShaderCompileRequest& request, CompiledShader& output)
+{
+	Microsoft::WRL::ComPtr<IDxcCompilerX> compiler;
+	if (FAILED(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(compiler.GetAddressOf()))))
+	{
+		DEBUG_PRINT("Failed to create a DXC compiler instance");
+		return false;
+	}
+
+	return DxcShaderCompiler::CompileWith(*compiler.Get(), request, output);
+}
+
+bool aZero::Pipeline::DxcShaderCompiler::CompileWith(IDxcCompilerX& compiler, const ShaderCompileRequest& request, CompiledShader& output)
+{
+	std::vector<LPCWSTR> compilationArgs;
+
+	const std::wstring filePathWStr(request.Path.begin(), request.Path.end());
+#if USE_DEBUG
+	std::wstring shaderName(filePathWStr);
+	const size_t lastSlash = shaderName.find_last_of('/');
+	if (lastSlash != std::wstring::npos)
+	{
+		shaderName = shaderName.substr(lastSlash + 1, shaderName.length() - lastSlash);
+	}
+
+	const size_t lastDot = shaderName.find_last_of(L".");
+	const std::wstring pdbName(shaderName.substr(0, lastDot) + L".pdb");
+
+	compilationArgs.push_back(shaderName.c_str());
+	compilationArgs.push_back(DXC_ARG_DEBUG);
+	compilationArgs.push_back(L"-Fd");
+	compilationArgs.push_back(pdbName.c_str());
+	compilationArgs.push_back(L"-Od");
+#else
+	compilationArgs.push_back(L"-O0");
+#endif
+
+	compilationArgs.push_back(L"-Qstrip_debug");
+
+	const std::wstring wStrEntryPoint(request.EntryPoint.begin(), request.EntryPoint.end());
+	compilationArgs.push_back(L"-E");
+	compilationArgs.push_back(wStrEntryPoint.c_str());
+
+	const std::wstring wStrTargetSM(request.TargetProfile.begin(), request.TargetProfile.end());
+	compilationArgs.push_back(L"-T");
+	compilationArgs.push_back(wStrTargetSM.c_str());
+
+	// Kept alive until the compilation is done since the argument list points into them
+	std::vector<std::wstring> argumentStorage;
+	argumentStorage.reserve(request.IncludeDirectories.size() + request.Arguments.size());
+	for (const std::string& includeDirectory : request.IncludeDirectories)
+	{
+		compilationArgs.push_back(L"-I");
+		compilationArgs.push_back(argumentStorage.emplace_back(includeDirectory.begin(), includeDirectory.end()).c_str());
+	}
+
+	for (const std::string& argument : request.Arguments)
+	{
+		compilationArgs.push_back(argumentStorage.emplace_back(argument.begin(), argument.end()).c_str());
+	}
+
+	Microsoft::WRL::ComPtr<IDxcUtils> utils;
+	DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&utils));
+
+	Microsoft::WRL::ComPtr<IDxcBlobEncoding> blob = nullptr;
+	const HRESULT fileLoadRes = utils->LoadFile(filePathWStr.c_str(), nullptr, &blob);
+	if (FAILED(fileLoadRes))
+	{
+		DEBUG_PRINT("Couldn't load shader at path: " + request.Path);
+		return false;
+	}
+
+	DxcBuffer source;
+	source.Ptr = blob->GetBufferPointer();
+	source.Size = blob->GetBufferSize();
+	source.Encoding = DXC_CP_ACP;
+
+	Microsoft::WRL::ComPtr<IDxcIncludeHandler> includeHandler;
+	utils->CreateDefaultIncludeHandler(&includeHandler);
+
+	Microsoft::WRL::ComPtr<IDxcResult> compilationResult;
+	compiler.Compile(&source, compilationArgs.data(), compilationArgs.size(), includeHandler.Get(), IID_PPV_ARGS(&compilationResult));
+
+	HRESULT compilationStatus;
+	compilationResult->GetStatus(&compilationStatus);
+	if (FAILED(compilationStatus))
+	{
+		Microsoft::WRL::ComPtr<IDxcBlobUtf8> errors{};
+		compilationResult->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&errors), nullptr);
+		if (errors && errors->GetStringLength() > 0)
+		{
+			const LPCSTR errorMsg = errors->GetStringPointer();
+			DEBUG_PRINT(errorMsg);
+		}
+
+		return false;
+	}
+
+	Microsoft::WRL::ComPtr<IDxcBlob> shaderBinary = nullptr;
+	const HRESULT shaderBinaryOutputRes = compilationResult->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&shaderBinary), nullptr);
+	if (FAILED(shaderBinaryOutputRes))
+	{
+		DEBUG_PRINT("Failed to get shader binary blob");
+		return false;
+	}
+
+#if USE_DEBUG
+	Microsoft::WRL::ComPtr<IDxcBlob> debugData;
+	Microsoft::WRL::ComPtr<IDxcBlobUtf16> debugDataPath;
+	const HRESULT pdbRes = compilationResult->GetOutput(DXC_OUT_PDB, IID_PPV_ARGS(debugData.GetAddressOf()), debugDataPath.GetAddressOf());
+	if (FAILED(pdbRes))
+	{
+		DEBUG_PRINT("Failed to get pdb data");
+		return false;
+	}
+
+	const std::string projectPath = Helper::GetDebugProjectDirectory();
+	const std::wstring shaderPath(debugDataPath->GetStringPointer());
+	std::string outputPath(projectPath + "/shaderDebugOutput/" + std::string(shaderPath.begin(), shaderPath.end()));
+	std::filesystem::path dir = std::filesystem::path(outputPath).parent_path();
+	std::filesystem::create_directories(dir);
+
+	std::fstream file(outputPath, std::ios::out | std::ios::trunc | std::ios::binary);
+	if (file.is_open())
+	{
+		file.write((char*)debugData->GetBufferPointer(), debugData->GetBufferSize());
+		file.close();
+	}
+#endif
+
+	CompiledShader compiled;
+	if (!DxcShaderCompiler::Reflect(*compilationResult.Get(), *utils.Get(), compiled.Reflection))
+	{
+		return false;
+	}
+
+	const uint8_t* bytecode = static_cast<const uint8_t*>(shaderBinary->GetBufferPointer());
+	compiled.Bytecode.assign(bytecode, bytecode + shaderBinary->GetBufferSize());
+	output = std::move(compiled);
+	return true;
+}
+
+bool aZero::Pipeline::DxcShaderCompiler::Reflect(IDxcResult& compilationResult, IDxcUtils& utils, ShaderReflection& reflection)
+{
+	Microsoft::WRL::ComPtr<IDxcBlob> reflectionData = nullptr;
+	const HRESULT reflectionDataOutputRes = compilationResult.GetOutput(DXC_OUT_REFLECTION, IID_PPV_ARGS(reflectionData.GetAddressOf()), nullptr);
+
+	if (FAILED(reflectionDataOutputRes))
+	{
+		throw std::invalid_argument("DxcShaderCompiler::Reflect() => Failed to get shader reflection data");
+	}
+
+	DxcBuffer reflectionBuffer;
+	reflectionBuffer.Ptr = reflectionData->GetBufferPointer();
+	reflectionBuffer.Size = reflectionData->GetBufferSize();
+	reflectionBuffer.Encoding = 0;
+
+	Microsoft::WRL::ComPtr<ID3D12ShaderReflection> shaderReflection;
+	utils.CreateReflection(&reflectionBuffer, IID_PPV_ARGS(shaderReflection.GetAddressOf()));
+
+	D3D12_SHADER_DESC shaderDesc{};
+	shaderReflection->GetDesc(&shaderDesc);
+
+	reflection.Resources.reserve(shaderDesc.BoundResources);
+	for (uint32_t ResourceIndex = 0; ResourceIndex < shaderDesc.BoundResources; ResourceIndex++)
+	{
+		D3D12_SHADER_INPUT_BIND_DESC ShaderInputBindDesc{};
+		shaderReflection->GetResourceBindingDesc(ResourceIndex, &ShaderInputBindDesc);
+
+		ShaderReflection::Resource resource;
+		resource.Name = ShaderInputBindDesc.Name;
+		resource.ShaderRegister = ShaderInputBindDesc.BindPoint;
+		resource.RegisterSpace = ShaderInputBindDesc.Space;
+
+		switch (ShaderInputBindDesc.Type)
+		{
+		case D3D_SIT_CBUFFER:
+		{
+			ID3D12ShaderReflectionConstantBuffer* shaderReflectionConstantBuffer = shaderReflection->GetConstantBufferByIndex(ResourceIndex);
+			D3D12_SHADER_BUFFER_DESC ConstantBufferDesc{};
+			shaderReflectionConstantBuffer->GetDesc(&ConstantBufferDesc);
+
+			uint32_t Num32Bit = 0;
+			for (int i = 0; i < ConstantBufferDesc.Variables; i++)
+			{
+				ID3D12ShaderReflectionVariable* variable = shaderReflectionConstantBuffer->GetVariableByIndex(i);
+				D3D12_SHADER_VARIABLE_DESC Desc;
+				variable->GetDesc(&Desc);
+				Num32Bit += Desc.Size / sizeof(uint32_t);
+			}
+
+			resource.ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+			resource.Num32BitConstants = Num32Bit;
+			break;
+		}
+		case D3D_SIT_STRUCTURED:
+		{
+			resource.ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+			break;
+		}
+		case D3D_SIT_UAV_RWSTRUCTURED:
+		{
+			resource.ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV;
+			break;
+		}
+		default:
+		{
+			return false;
+		}
+		}
+
+		reflection.Resources.push_back(std::move(resource));
+	}
+
+	for (uint32_t ParamIndex = 0; ParamIndex < shaderDesc.InputParameters; ParamIndex++)
+	{
+		D3D12_SIGNATURE_PARAMETER_DESC SignatureParameterDesc{};
+		shaderReflection->GetInputParameterDesc(ParamIndex, &SignatureParameterDesc);
+		reflection.InputParameters.push_back({ SignatureParameterDesc.SemanticName, SignatureParameterDesc.SemanticIndex, SignatureParameterDesc.Mask });
+	}
+
+	for (uint32_t ParamIndex = 0; ParamIndex < shaderDesc.OutputParameters; ParamIndex++)
+	{
+		D3D12_SIGNATURE_PARAMETER_DESC SignatureParameterDesc{};
+		shaderReflection->GetOutputParameterDesc(ParamIndex, &SignatureParameterDesc);
+		reflection.OutputParameters.push_back({ SignatureParameterDesc.SemanticName, SignatureParameterDesc.SemanticIndex, SignatureParameterDesc.Mask });
+	}
+
+	shaderReflection->GetThreadGroupSize(&reflection.ThreadGroupSize[0], &reflection.ThreadGroupSize[1], &reflection.ThreadGroupSize[2]);
+	return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "ShaderCompiler.hpp"
+#include "graphics_api/D3D12Include.hpp"
+
+namespace aZero
+{
+	namespace Pipeline
+	{
+		/** @brief Compiles shaders with DXC and reflects them with the DXC reflection interface.
+		* Every Compile() call creates its own compiler instance so that cache misses can be compiled on several threads.
+		*/
+		class DxcShaderCompiler : public ShaderCompilerBase
+		{
+		public:
+			DxcShaderCompiler();
+
+			std::string GetIdentifier() const override { return m_Identifier; }
+			bool Compile(const ShaderCompileRequest& request, CompiledShader& output) override;
+
+			/** Compiles and reflects the shader with the input compiler instance.
+			@param compiler
+			@param request
+			@param output
+			@return bool
+			*/
+			static bool CompileWith(IDxcCompilerX& compiler, const ShaderCompileRequest& request, CompiledShader& output);
+
+		private:
+			std::string m_Identifier;
+
+			static bool Reflect(IDxcResult& compilationResult, IDxcUtils& utils, ShaderReflection& reflection);
+		};
+	}
+}
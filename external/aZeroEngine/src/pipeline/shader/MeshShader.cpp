@@ -17,42 +17,13 @@ aZero::Pipeline::MeshShader& aZero::Pipeline::MeshShader::operator=(MeshShader&&
 	return *this;
 }
 
-bool aZero::Pipeline::MeshShader::ValidateShaderTypeFromFilepath(const std::string& path)
+bool aZero::Pipeline::MeshShader::ValidateShaderTypeFromFilepath(const std::string& path) const
 {
 	return path.ends_with(m_ShaderExtension);
 }
 
-bool aZero::Pipeline::MeshShader::Reflect(Microsoft::WRL::ComPtr<IDxcResult>& compilationResult, Microsoft::WRL::ComPtr<IDxcUtils>& utils)
+bool aZero::Pipeline::MeshShader::ApplyReflection(const ShaderReflection& reflection)
 {
-	Microsoft::WRL::ComPtr<ID3D12ShaderReflection> reflection;
-	if (!Shader::ReflectImpl(compilationResult, utils, D3D12_SHADER_VISIBILITY::D3D12_SHADER_VISIBILITY_MESH, reflection))
-	{
-		return false;
-	}
-
-	reflection->GetThreadGroupSize(&m_ThreadGroupCount.x, &m_ThreadGroupCount.y, &m_ThreadGroupCount.z);
-	return true;
-}
-
-bool aZero::Pipeline::MeshShader::CompileFromFile(IDxcCompilerX& compiler, const std::string& path)
-{
-	if (!this->ValidateShaderTypeFromFilepath(path))//
-	{
-		DEBUG_PRINT("Shader path (" + path + ") isn't valid (path doesn't end with '.ms.hlsl' etc...");
-		return false;
-	}
-
-	Microsoft::WRL::ComPtr<IDxcResult> compilationResult;
-	Microsoft::WRL::ComPtr<IDxcUtils> utils;
-	if (!Shader::CompileImpl(compiler, path, m_TargetSM, compilationResult, utils))
-	{
-		return false;
-	}
-
-	if (!this->Reflect(compilationResult, utils))
-	{
-		return false;
-	}
-
+	m_ThreadGroupCount = { reflection.ThreadGroupSize[0], reflection.ThreadGroupSize[1], reflection.ThreadGroupSize[2] };
 	return true;
 }
\ No newline at end of file
@@ -23,7 +23,6 @@ namespace aZero
 			MeshShader(MeshShader&& other) noexcept;
 			MeshShader& operator=(MeshShader&& other) noexcept;
 
-			bool CompileFromFile(IDxcCompilerX& compiler, const std::string& path) override;
 			[[nodiscard]] ThreadGroup GetThreadGroups() const { return m_ThreadGroupCount; }
 
 		private:
@@ -32,8 +31,10 @@ namespace aZero
 			
 			ThreadGroup m_ThreadGroupCount;
 
-			bool ValidateShaderTypeFromFilepath(const std::string& path) override;
-			bool Reflect(Microsoft::WRL::ComPtr<IDxcResult>& compilationResult, Microsoft::WRL::ComPtr<IDxcUtils>& utils);
+			bool ValidateShaderTypeFromFilepath(const std::string& path) const override;
+			const char* GetTargetProfile() const override { return m_TargetSM; }
+			D3D12_SHADER_VISIBILITY GetShaderVisibility() const override { return D3D12_SHADER_VISIBILITY::D3D12_SHADER_VISIBILITY_MESH; }
+			bool ApplyReflection(const ShaderReflection& reflection) override;
 
 		
 		};
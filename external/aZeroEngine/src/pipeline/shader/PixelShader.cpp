@@ -17,7 +17,7 @@ aZero::Pipeline::PixelShader& aZero::Pipeline::PixelShader::operator=(PixelShade
 	return *this;
 }
 
-bool aZero::Pipeline::PixelShader::ValidateShaderTypeFromFilepath(const std::string& path)
+bool aZero::Pipeline::PixelShader::ValidateShaderTypeFromFilepath(const std::string& path) const
 {
 	return path.ends_with(m_ShaderExtension);
 }
@@ -48,23 +48,13 @@ aZero::Pipeline::PixelShader::NUM_RTV_CHANNELS aZero::Pipeline::PixelShader::Ref
 	return NUM_RTV_CHANNELS::R;
 }
 
-bool aZero::Pipeline::PixelShader::Reflect(Microsoft::WRL::ComPtr<IDxcResult>& compilationResult, Microsoft::WRL::ComPtr<IDxcUtils>& utils)
+bool aZero::Pipeline::PixelShader::ApplyReflection(const ShaderReflection& reflection)
 {
-	Microsoft::WRL::ComPtr<ID3D12ShaderReflection> reflection;
-	if (!Shader::ReflectImpl(compilationResult, utils, D3D12_SHADER_VISIBILITY::D3D12_SHADER_VISIBILITY_PIXEL, reflection))
+	m_RenderTargetMasks.clear();
+	m_RenderTargetMasks.reserve(reflection.OutputParameters.size());
+	for (const ShaderReflection::SignatureParameter& SignatureParameter : reflection.OutputParameters)
 	{
-		return false;
-	}
-
-	D3D12_SHADER_DESC shaderDesc{};
-	reflection->GetDesc(&shaderDesc);
-
-	m_RenderTargetMasks.reserve(shaderDesc.OutputParameters);
-	for (uint32_t ParamIndex = 0; ParamIndex < shaderDesc.OutputParameters; ParamIndex++)
-	{
-		D3D12_SIGNATURE_PARAMETER_DESC SignatureParameterDesc{};
-		reflection->GetOutputParameterDesc(ParamIndex, &SignatureParameterDesc);
-		m_RenderTargetMasks.emplace_back(this->ReflectionMaskToNumComponents(SignatureParameterDesc.Mask));
+		m_RenderTargetMasks.emplace_back(this->ReflectionMaskToNumComponents(static_cast<BYTE>(SignatureParameter.Mask)));
 	}
 
 	return true;
@@ -122,29 +112,6 @@ bool aZero::Pipeline::PixelShader::ValidateFormatWithMask(DXGI_FORMAT format, NU
 	return false;
 }
 
-bool aZero::Pipeline::PixelShader::CompileFromFile(IDxcCompilerX& compiler, const std::string& path)
-{
-	if (!this->ValidateShaderTypeFromFilepath(path))
-	{
-		DEBUG_PRINT("Shader path (" + path + ") isn't valid (path doesn't end with '.ps.hlsl' etc...");
-		return false;
-	}
-
-	Microsoft::WRL::ComPtr<IDxcResult> compilationResult;
-	Microsoft::WRL::ComPtr<IDxcUtils> utils;
-	if (!Shader::CompileImpl(compiler, path, m_TargetSM, compilationResult, utils))
-	{
-		return false;
-	}
-
-	if (!this->Reflect(compilationResult, utils))
-	{
-		return false;
-	}
-
-	return true;
-}
-
 bool aZero::Pipeline::PixelShader::ValidateRenderTargetDXGIs(std::span<DXGI_FORMAT> formats)
 {
 	if (formats.size() != m_RenderTargetMasks.size())
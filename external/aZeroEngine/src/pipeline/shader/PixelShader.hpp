@@ -20,7 +20,6 @@ namespace aZero
 			PixelShader(PixelShader&& other) noexcept;
 			PixelShader& operator=(PixelShader&& other) noexcept;
 
-			bool CompileFromFile(IDxcCompilerX& compiler, const std::string& path) override;
 			uint32_t NumRenderTargets() const { return m_RenderTargetMasks.size(); }
 			bool ValidateRenderTargetDXGIs(std::span<DXGI_FORMAT> formats);
 
@@ -36,11 +35,13 @@ namespace aZero
 			static constexpr const char* m_TargetSM = "ps_6_6";
 			static constexpr const char* m_ShaderExtension = ".ps.hlsl";
 
-			bool ValidateShaderTypeFromFilepath(const std::string& path) override;
+			bool ValidateShaderTypeFromFilepath(const std::string& path) const override;
+			const char* GetTargetProfile() const override { return m_TargetSM; }
+			D3D12_SHADER_VISIBILITY GetShaderVisibility() const override { return D3D12_SHADER_VISIBILITY::D3D12_SHADER_VISIBILITY_PIXEL; }
 
 			NUM_RTV_CHANNELS ReflectionMaskToNumComponents(BYTE channelMask);
 
-			bool Reflect(Microsoft::WRL::ComPtr<IDxcResult>& compilationResult, Microsoft::WRL::ComPtr<IDxcUtils>& utils);
+			bool ApplyReflection(const ShaderReflection& reflection) override;
 
 			bool ValidateFormatWithMask(DXGI_FORMAT format, NUM_RTV_CHANNELS numRtvComponents);
 
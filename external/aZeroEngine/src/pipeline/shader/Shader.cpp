@@ -1,6 +1,6 @@
 #include "Shader.hpp"
-#include "misc/HelperFunctions.hpp"
-#include <filesystem>
+#include "ShaderCache.hpp"
+#include "DxcShaderCompiler.hpp"
 
 aZero::Pipeline::Shader::Shader(Shader&& other) noexcept
 {
@@ -15,221 +15,92 @@ aZero::Pipeline::Shader& aZero::Pipeline::Shader::operator=(Shader&& other) noex
 	return *this;
 }
 
-bool aZero::Pipeline::Shader::CompileImpl(IDxcCompilerX& compiler, const std::string& path, const std::string& targetSM, Microsoft::WRL::ComPtr<IDxcResult>& compilationResult, Microsoft::WRL::ComPtr<IDxcUtils>& utils)
+aZero::Pipeline::ShaderCompileRequest aZero::Pipeline::Shader::GetCompileRequest(const std::string& path) const
 {
-	std::vector<LPCWSTR> compilationArgs;
-
-	const std::wstring filePathWStr(path.begin(), path.end());
-#if USE_DEBUG
-	std::wstring shaderName(filePathWStr);
-	const size_t lastSlash = shaderName.find_last_of('/');
-	if (lastSlash != std::wstring::npos)
-	{
-		shaderName = shaderName.substr(lastSlash + 1, shaderName.length() - lastSlash);
-	}
-
-	const size_t lastDot = shaderName.find_last_of(L".");
-	const std::wstring pdbName(shaderName.substr(0, lastDot) + L".pdb");
-
-	compilationArgs.push_back(shaderName.c_str());
-	compilationArgs.push_back(DXC_ARG_DEBUG);
-	compilationArgs.push_back(L"-Fd");
-	compilationArgs.push_back(pdbName.c_str());
-	compilationArgs.push_back(L"-Od");
-#else
-	compilationArgs.push_back(L"-O0");
-#endif
-
-	compilationArgs.push_back(L"-Qstrip_debug");
-
-	compilationArgs.push_back(L"-E");
-	compilationArgs.push_back(L"main");
-	compilationArgs.push_back(L"-T");
-
-	const std::wstring wStrTargetSM(targetSM.begin(), targetSM.end());
-	compilationArgs.push_back(wStrTargetSM.c_str());
-
-	DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&utils));
+	ShaderCompileRequest request;
+	request.Path = path;
+	request.TargetProfile = this->GetTargetProfile();
+	request.IncludeDirectories.push_back(std::string(PROJECT_DIRECTORY) + SHADER_SOURCE_RELATIVE_PATH);
+	return request;
+}
 
-	Microsoft::WRL::ComPtr<IDxcBlobEncoding> blob = nullptr;
-	const HRESULT fileLoadRes = utils->LoadFile(filePathWStr.c_str(), nullptr, &blob);
-	if (FAILED(fileLoadRes))
+bool aZero::Pipeline::Shader::CompileFromFile(IDxcCompilerX& compiler, const std::string& path)
+{
+	if (!this->ValidateShaderTypeFromFilepath(path))
 	{
-		DEBUG_PRINT("Couldn't load shader at path: " + path);
+		DEBUG_PRINT("Shader path (" + path + ") isn't valid for a " + this->GetTargetProfile() + " shader (path doesn't end with '.cs.hlsl' etc...)");
 		return false;
 	}
 
-	DxcBuffer source;
-	source.Ptr = blob->GetBufferPointer();
-	source.Size = blob->GetBufferSize();
-	source.Encoding = DXC_CP_ACP;
-
-	Microsoft::WRL::ComPtr<IDxcIncludeHandler> includeHandler;
-	utils->CreateDefaultIncludeHandler(&includeHandler);
-
-	// Adds "-I" is used to declare include directories
-	const std::string projectDir(PROJECT_DIRECTORY);
-	const std::wstring projectDirW(projectDir.begin(), projectDir.end());
-	const std::wstring shaderPathDir = L"-I " + projectDirW + L"shaderSource/";
-	compilationArgs.push_back(shaderPathDir.c_str());
-
-	compiler.Compile(&source, compilationArgs.data(), compilationArgs.size(), includeHandler.Get(), IID_PPV_ARGS(&compilationResult));
-
-	HRESULT compilationStatus;
-	compilationResult->GetStatus(&compilationStatus);
-	if (FAILED(compilationStatus))
+	CompiledShader compiled;
+	if (!DxcShaderCompiler::CompileWith(compiler, this->GetCompileRequest(path), compiled))
 	{
-		Microsoft::WRL::ComPtr<IDxcBlobUtf8> errors{};
-		compilationResult->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&errors), nullptr);
-		if (errors && errors->GetStringLength() > 0)
-		{
-			const LPCSTR errorMsg = errors->GetStringPointer();
-			DEBUG_PRINT(errorMsg);
-		}
-
 		return false;
 	}
 
-	Microsoft::WRL::ComPtr<IDxcBlob> shaderBinary = nullptr;
-	const HRESULT shaderBinaryOutputRes = compilationResult->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&shaderBinary), nullptr);
-	if (FAILED(shaderBinaryOutputRes))
-	{
-		DEBUG_PRINT("Failed to get shader binary blob");
-		return false;
-	}
+	return this->ApplyCompiledShader(compiled);
+}
 
-#if USE_DEBUG
-	Microsoft::WRL::ComPtr<IDxcBlob> debugData;
-	Microsoft::WRL::ComPtr<IDxcBlobUtf16> debugDataPath;
-	const HRESULT pdbRes = compilationResult->GetOutput(DXC_OUT_PDB, IID_PPV_ARGS(debugData.GetAddressOf()), debugDataPath.GetAddressOf());
-	if (FAILED(pdbRes))
+bool aZero::Pipeline::Shader::CompileFromCache(ShaderCache& cache, const std::string& path)
+{
+	if (!this->ValidateShaderTypeFromFilepath(path))
 	{
-		DEBUG_PRINT("Failed to get pdb data");
+		DEBUG_PRINT("Shader path (" + path + ") isn't valid for a " + this->GetTargetProfile() + " shader (path doesn't end with '.cs.hlsl' etc...)");
 		return false;
 	}
 
-	const std::string projectPath = Helper::GetDebugProjectDirectory();
-	const std::wstring shaderPath(debugDataPath->GetStringPointer());
-	std::string outputPath(projectPath + "/shaderDebugOutput/" + std::string(shaderPath.begin(), shaderPath.end()));
-	std::filesystem::path dir = std::filesystem::path(outputPath).parent_path();
-	std::filesystem::create_directories(dir);
-
-	std::fstream file(outputPath, std::ios::out | std::ios::trunc | std::ios::binary);
-	if (file.is_open())
+	const std::shared_ptr<const CompiledShader> compiled = cache.Get(this->GetCompileRequest(path));
+	if (!compiled)
 	{
-		file.write((char*)debugData->GetBufferPointer(), debugData->GetBufferSize());
-		file.close();
+		return false;
 	}
-#endif
 
-	this->m_CompiledShader = shaderBinary;
-	return true;
+	return this->ApplyCompiledShader(*compiled);
 }
 
-bool aZero::Pipeline::Shader::ReflectImpl(Microsoft::WRL::ComPtr<IDxcResult>& compilationResult, Microsoft::WRL::ComPtr<IDxcUtils>& utils, D3D12_SHADER_VISIBILITY shaderVisibility, Microsoft::WRL::ComPtr<ID3D12ShaderReflection>& reflection)
+bool aZero::Pipeline::Shader::ApplyCompiledShader(const CompiledShader& compiled)
 {
-	Microsoft::WRL::ComPtr<IDxcBlob> reflectionData = nullptr;
-	const HRESULT reflectionDataOutputRes = compilationResult->GetOutput(DXC_OUT_REFLECTION, IID_PPV_ARGS(reflectionData.GetAddressOf()), nullptr);
-
-	if (FAILED(reflectionDataOutputRes))
+	// Stage specific data first so that the bindings stay untouched if it's rejected
+	if (!this->ApplyReflection(compiled.Reflection))
 	{
-		throw std::invalid_argument("Shader::GenerateReflectionData() => Failed to get shader reflection data");
+		return false;
 	}
 
-	DxcBuffer reflectionBuffer;
-	reflectionBuffer.Ptr = reflectionData->GetBufferPointer();
-	reflectionBuffer.Size = reflectionData->GetBufferSize();
-	reflectionBuffer.Encoding = 0;
-
-	Microsoft::WRL::ComPtr<ID3D12ShaderReflection> shaderReflection;
-	utils->CreateReflection(&reflectionBuffer, IID_PPV_ARGS(shaderReflection.GetAddressOf()));
-
-	D3D12_SHADER_DESC shaderDesc{};
-	shaderReflection->GetDesc(&shaderDesc);
-
 	// NOTE: shaderVisibility being ALL or specific shader might cause problems if they reference the same binding
+	const D3D12_SHADER_VISIBILITY shaderVisibility = this->GetShaderVisibility();
 
 	m_RootParameters.resize(0);
-	for (uint32_t ResourceIndex = 0; ResourceIndex < shaderDesc.BoundResources; ResourceIndex++)
+	m_ResourceNameToInformation.clear();
+	for (const ShaderReflection::Resource& resource : compiled.Reflection.Resources)
 	{
-		D3D12_SHADER_INPUT_BIND_DESC ShaderInputBindDesc{};
-		shaderReflection->GetResourceBindingDesc(ResourceIndex, &ShaderInputBindDesc);
-
-		const std::string ParamName(ShaderInputBindDesc.Name);
 		const uint32_t RootParameterIndex = m_RootParameters.size();
-		ShaderResourceInfo& Info = m_ResourceNameToInformation[ParamName];
+		ShaderResourceInfo& Info = m_ResourceNameToInformation[resource.Name];
 		Info.m_RootIndex = RootParameterIndex;
+		Info.m_ResourceType = static_cast<D3D12_ROOT_PARAMETER_TYPE>(resource.ParameterType);
+		Info.m_Num32BitConstants = resource.Num32BitConstants;
 
-		switch (ShaderInputBindDesc.Type)
-		{
-		case D3D_SIT_CBUFFER:
+		D3D12_ROOT_PARAMETER RootParameter{};
+		RootParameter.ParameterType = Info.m_ResourceType;
+		RootParameter.ShaderVisibility = shaderVisibility;
+		if (Info.m_ResourceType == D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS)
 		{
-			ID3D12ShaderReflectionConstantBuffer* shaderReflectionConstantBuffer = shaderReflection->GetConstantBufferByIndex(ResourceIndex);
-			D3D12_SHADER_BUFFER_DESC ConstantBufferDesc{};
-			shaderReflectionConstantBuffer->GetDesc(&ConstantBufferDesc);
-
-			uint32_t Num32Bit = 0;
-			for (int i = 0; i < ConstantBufferDesc.Variables; i++)
-			{
-				ID3D12ShaderReflectionVariable* variable = shaderReflectionConstantBuffer->GetVariableByIndex(i);
-				D3D12_SHADER_VARIABLE_DESC Desc;
-				variable->GetDesc(&Desc);
-				Num32Bit += Desc.Size / sizeof(uint32_t);
-			}
-
-			const D3D12_ROOT_PARAMETER RootParameter
-			{
-				.ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS,
-				.Constants{
-					.ShaderRegister = ShaderInputBindDesc.BindPoint,
-					.RegisterSpace = ShaderInputBindDesc.Space,
-					.Num32BitValues = Num32Bit
-				},
-				.ShaderVisibility = shaderVisibility
-			};
-			Info.m_Num32BitConstants = Num32Bit;
-			Info.m_ResourceType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
-			m_RootParameters.push_back(RootParameter);
-
-			break;
-		}
-		case D3D_SIT_STRUCTURED:
-		{
-			const D3D12_ROOT_PARAMETER RootParameter
-			{
-				.ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV,
-				.Descriptor{
-					.ShaderRegister = ShaderInputBindDesc.BindPoint,
-					.RegisterSpace = ShaderInputBindDesc.Space
-				},
-				.ShaderVisibility = shaderVisibility
+			RootParameter.Constants = {
+				.ShaderRegister = resource.ShaderRegister,
+				.RegisterSpace = resource.RegisterSpace,
+				.Num32BitValues = resource.Num32BitConstants
 			};
-			Info.m_ResourceType = D3D12_ROOT_PARAMETER_TYPE_SRV;
-			m_RootParameters.push_back(RootParameter);
-			break;
 		}
-		case D3D_SIT_UAV_RWSTRUCTURED:
+		else
 		{
-			const D3D12_ROOT_PARAMETER RootParameter
-			{
-				.ParameterType = D3D12_ROOT_PARAMETER_TYPE_UAV,
-				.Descriptor{
-					.ShaderRegister = ShaderInputBindDesc.BindPoint,
-					.RegisterSpace = ShaderInputBindDesc.Space
-				},
-				.ShaderVisibility = shaderVisibility
+			RootParameter.Descriptor = {
+				.ShaderRegister = resource.ShaderRegister,
+				.RegisterSpace = resource.RegisterSpace
 			};
-			Info.m_ResourceType = D3D12_ROOT_PARAMETER_TYPE_UAV;
-			m_RootParameters.push_back(RootParameter);
-			break;
-		}
-		default:
-		{
-			return false;
-		}
 		}
+
+		m_RootParameters.push_back(RootParameter);
 	}
 
-	reflection = shaderReflection;
+	m_CompiledShader = compiled.Bytecode;
 	return true;
 }
@@ -7,12 +7,14 @@
 #include "graphics_api/D3D12Include.hpp"
 #include "misc/RelativePathMacros.hpp"
 #include "misc/NonCopyable.hpp"
+#include "ShaderCompiler.hpp"
 
-// todo Make all shaders not get changed if compilation fails (similar to how passes are implemented when compiling them)
 namespace aZero
 {
 	namespace Pipeline
 	{
+		class ShaderCache;
+
 		class Shader : public NonCopyable
 		{
 			friend class ShaderPassBase;
@@ -34,19 +36,48 @@ namespace aZero
 
 			virtual ~Shader() {}
 
-			virtual bool CompileFromFile(IDxcCompilerX& compiler, const std::string& path) = 0;
+			/** Compiles and reflects the shader at the path. The shader is left unchanged if the compilation fails.
+			@param compiler
+			@param path
+			@return bool
+			*/
+			bool CompileFromFile(IDxcCompilerX& compiler, const std::string& path);
+
+			/** Same as CompileFromFile() but goes through the cache, so a hit skips both the compilation and the reflection.
+			@param cache
+			@param path
+			@return bool
+			*/
+			bool CompileFromCache(ShaderCache& cache, const std::string& path);
+
+			/** Returns the request that CompileFromFile() and CompileFromCache() compile the shader at the path with.
+			* Can be used to compile several shaders up front with ShaderCache::Get().
+			@param path
+			@return ShaderCompileRequest
+			*/
+			ShaderCompileRequest GetCompileRequest(const std::string& path) const;
+
+			D3D12_SHADER_BYTECODE GetBytecode() const { return { m_CompiledShader.data(), m_CompiledShader.size() }; }
 			const std::unordered_map<std::string, ShaderResourceInfo>& GetResourceBindings() const { return m_ResourceNameToInformation; }
 			const std::vector<D3D12_ROOT_PARAMETER>& GetRootParameters() const { return m_RootParameters; }
 
 		private:
-			Microsoft::WRL::ComPtr<IDxcBlob> m_CompiledShader;
+			std::vector<uint8_t> m_CompiledShader;
 			std::unordered_map<std::string, ShaderResourceInfo> m_ResourceNameToInformation;
 			std::vector<D3D12_ROOT_PARAMETER> m_RootParameters;
 
+			bool ApplyCompiledShader(const CompiledShader& compiled);
+
 		protected:
-			bool CompileImpl(IDxcCompilerX& compiler, const std::string& path, const std::string& targetSM, Microsoft::WRL::ComPtr<IDxcResult>& compilationResult, Microsoft::WRL::ComPtr<IDxcUtils>& utils);
-			bool ReflectImpl(Microsoft::WRL::ComPtr<IDxcResult>& compilationResult, Microsoft::WRL::ComPtr<IDxcUtils>& utils, D3D12_SHADER_VISIBILITY shaderVisibility, Microsoft::WRL::ComPtr<ID3D12ShaderReflection>& reflection);
-			virtual bool ValidateShaderTypeFromFilepath(const std::string& path) = 0;
+			virtual bool ValidateShaderTypeFromFilepath(const std::string& path) const = 0;
+			virtual const char* GetTargetProfile() const = 0;
+			virtual D3D12_SHADER_VISIBILITY GetShaderVisibility() const = 0;
+
+			/** Reads the stage specific reflection results, ex. thread group size or input layout.
+			@param reflection
+			@return bool
+			*/
+			virtual bool ApplyReflection(const ShaderReflection& reflection) { return true; }
 		};
 	}
 }
\ No newline at end of file
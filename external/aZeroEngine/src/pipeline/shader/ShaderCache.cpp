@@ -0,0 +1,507 @@
+#include "ShaderCache.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+#include "misc/Hash.hpp"
+#include "misc/MappedFile.hpp"
+#include "misc/JobSystem.hpp"
+#include "misc/EngineDebugMacros.hpp"
+
+namespace
+{
+	// Smallest serialized records, an empty name is still prefixed by its length
+	constexpr uint64_t MinResourceSize = sizeof(uint32_t) * 5;
+	constexpr uint64_t MinSignatureParameterSize = sizeof(uint32_t) * 3;
+
+	struct IncludeDirective
+	{
+		std::string Name;
+		bool Quoted;
+	};
+
+	// Length prefixed so that neighbouring fields can't be shifted into each other without changing the hash
+	uint64_t HashField(std::string_view field, uint64_t seed)
+	{
+		return aZero::Helper::HashString(field, aZero::Helper::HashValue(field.size(), seed));
+	}
+
+	bool ReadFile(const std::filesystem::path& path, std::string& out)
+	{
+		std::ifstream stream(path, std::ios::in | std::ios::binary);
+		if (!stream.is_open())
+		{
+			return false;
+		}
+
+		std::ostringstream contents;
+		contents << stream.rdbuf();
+		out = contents.str();
+		return true;
+	}
+
+	// Finds the #include directives of the source. Commented out directives might be picked up as well, which only makes the key stricter.
+	void CollectIncludes(const std::string& source, std::vector<IncludeDirective>& includes)
+	{
+		size_t lineStart = 0;
+		while (lineStart < source.size())
+		{
+			size_t lineEnd = source.find('\n', lineStart);
+			if (lineEnd == std::string::npos)
+			{
+				lineEnd = source.size();
+			}
+
+			size_t position = source.find_first_not_of(" \t", lineStart);
+			if (position < lineEnd && source[position] == '#')
+			{
+				position = source.find_first_not_of(" \t", position + 1);
+				if (position < lineEnd && source.compare(position, 7, "include") == 0)
+				{
+					position = source.find_first_not_of(" \t", position + 7);
+					if (position < lineEnd && (source[position] == '"' || source[position] == '<'))
+					{
+						const bool quoted = source[position] == '"';
+						const size_t nameEnd = source.find(quoted ? '"' : '>', position + 1);
+						if (nameEnd < lineEnd)
+						{
+							includes.push_back({ source.substr(position + 1, nameEnd - position - 1), quoted });
+						}
+					}
+				}
+			}
+
+			lineStart = lineEnd + 1;
+		}
+	}
+
+	std::optional<std::filesystem::path> ResolveInclude(const IncludeDirective& include, const std::filesystem::path& includingDirectory, const std::vector<std::string>& includeDirectories)
+	{
+		std::error_code error;
+		if (include.Quoted)
+		{
+			const std::filesystem::path candidate = includingDirectory / include.Name;
+			if (std::filesystem::is_regular_file(candidate, error))
+			{
+				return candidate;
+			}
+		}
+
+		for (const std::string& includeDirectory : includeDirectories)
+		{
+			const std::filesystem::path candidate = std::filesystem::path(includeDirectory) / include.Name;
+			if (std::filesystem::is_regular_file(candidate, error))
+			{
+				return candidate;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	std::string GetNormalizedPath(const std::filesystem::path& path)
+	{
+		std::error_code error;
+		const std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+		return error ? path.lexically_normal().generic_string() : canonical.generic_string();
+	}
+
+	class EntryReader
+	{
+	public:
+		EntryReader(const uint8_t* data, size_t size)
+			:m_Data(data), m_Size(size) { }
+
+		template<typename T>
+		bool Read(T& out)
+		{
+			if (m_Offset + sizeof(T) > m_Size)
+			{
+				return false;
+			}
+
+			memcpy(&out, m_Data + m_Offset, sizeof(T));
+			m_Offset += sizeof(T);
+			return true;
+		}
+
+		bool Read(std::string& out)
+		{
+			uint32_t length;
+			if (!this->Read(length) || m_Offset + length > m_Size)
+			{
+				return false;
+			}
+
+			out.assign(reinterpret_cast<const char*>(m_Data + m_Offset), length);
+			m_Offset += length;
+			return true;
+		}
+
+		bool Read(std::vector<uint8_t>& out, uint32_t numBytes)
+		{
+			if (m_Offset + numBytes > m_Size)
+			{
+				return false;
+			}
+
+			out.assign(m_Data + m_Offset, m_Data + m_Offset + numBytes);
+			m_Offset += numBytes;
+			return true;
+		}
+
+		bool Read(aZero::Pipeline::ShaderReflection::SignatureParameter& out)
+		{
+			return this->Read(out.SemanticName) && this->Read(out.SemanticIndex) && this->Read(out.Mask);
+		}
+
+		uint64_t GetRemaining() const { return m_Offset < m_Size ? m_Size - m_Offset : 0; }
+
+	private:
+		const uint8_t* m_Data;
+		size_t m_Size;
+		uint64_t m_Offset = 0;
+	};
+
+	class EntryWriter
+	{
+	public:
+		void Write(const void* data, size_t numBytes)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			m_Data.insert(m_Data.end(), bytes, bytes + numBytes);
+		}
+
+		void Write(uint32_t value)
+		{
+			this->Write(&value, sizeof(value));
+		}
+
+		void Write(const std::string& str)
+		{
+			this->Write(static_cast<uint32_t>(str.size()));
+			this->Write(str.data(), str.size());
+		}
+
+		void Write(const aZero::Pipeline::ShaderReflection::SignatureParameter& parameter)
+		{
+			this->Write(parameter.SemanticName);
+			this->Write(parameter.SemanticIndex);
+			this->Write(parameter.Mask);
+		}
+
+		std::vector<uint8_t>& GetData() { return m_Data; }
+
+	private:
+		std::vector<uint8_t> m_Data;
+	};
+}
+
+aZero::Pipeline::ShaderCache::ShaderCache(ShaderCompilerBase& compiler, const std::string& cacheDirectory)
+	:m_Compiler(compiler), m_CacheDirectory(cacheDirectory)
+{
+
+}
+
+uint64_t aZero::Pipeline::ShaderCache::ComputeKey(const ShaderCompileRequest& request) const
+{
+	uint64_t hash = HashField(m_Compiler.GetIdentifier(), Helper::HashValue(Version));
+	hash = HashField(request.TargetProfile, hash);
+	hash = HashField(request.EntryPoint, hash);
+
+	hash = Helper::HashValue(request.Arguments.size(), hash);
+	for (const std::string& argument : request.Arguments)
+	{
+		hash = HashField(argument, hash);
+	}
+
+	hash = Helper::HashValue(request.IncludeDirectories.size(), hash);
+	for (const std::string& includeDirectory : request.IncludeDirectories)
+	{
+		hash = HashField(includeDirectory, hash);
+	}
+
+	// Walks the include graph breadth first so the files are always hashed in the same order. Every file is only hashed once.
+	std::vector<std::filesystem::path> files{ std::filesystem::path(request.Path) };
+	std::unordered_set<std::string> visitedFiles{ GetNormalizedPath(files.front()) };
+	std::vector<IncludeDirective> includes;
+	std::string source;
+	for (size_t fileIndex = 0; fileIndex < files.size(); fileIndex++)
+	{
+		if (!ReadFile(files[fileIndex], source))
+		{
+			hash = HashField("<unreadable>", hash);
+			continue;
+		}
+
+		hash = HashField(source, hash);
+
+		includes.clear();
+		CollectIncludes(source, includes);
+		for (const IncludeDirective& include : includes)
+		{
+			hash = HashField(include.Name, hash);
+
+			// Unresolved includes are part of the key so that adding the missing file changes it
+			const std::optional<std::filesystem::path> includePath = ResolveInclude(include, files[fileIndex].parent_path(), request.IncludeDirectories);
+			if (!includePath.has_value())
+			{
+				hash = HashField("<unresolved>", hash);
+				continue;
+			}
+
+			if (visitedFiles.insert(GetNormalizedPath(includePath.value())).second)
+			{
+				files.push_back(includePath.value());
+			}
+		}
+	}
+
+	return hash;
+}
+
+std::shared_ptr<const aZero::Pipeline::CompiledShader> aZero::Pipeline::ShaderCache::Get(const ShaderCompileRequest& request)
+{
+	return this->GetOrCompile(request, this->ComputeKey(request));
+}
+
+std::vector<std::shared_ptr<const aZero::Pipeline::CompiledShader>> aZero::Pipeline::ShaderCache::Get(std::span<const ShaderCompileRequest> requests)
+{
+	std::vector<uint64_t> keys(requests.size());
+	Jobs::GetJobSystem().ParallelFor(static_cast<uint32_t>(requests.size()), 1,
+		[this, &requests, &keys](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t requestIndex = begin; requestIndex < end; requestIndex++)
+			{
+				keys[requestIndex] = this->ComputeKey(requests[requestIndex]);
+			}
+		});
+
+	// Requests with the same key are only looked up and compiled once
+	std::unordered_map<uint64_t, uint32_t> keyToUniqueIndex;
+	std::vector<uint32_t> uniqueRequests;
+	for (uint32_t requestIndex = 0; requestIndex < requests.size(); requestIndex++)
+	{
+		if (keyToUniqueIndex.emplace(keys[requestIndex], static_cast<uint32_t>(uniqueRequests.size())).second)
+		{
+			uniqueRequests.push_back(requestIndex);
+		}
+	}
+
+	std::vector<std::shared_ptr<const CompiledShader>> uniqueResults(uniqueRequests.size());
+	Jobs::GetJobSystem().ParallelFor(static_cast<uint32_t>(uniqueRequests.size()), 1,
+		[this, &requests, &keys, &uniqueRequests, &uniqueResults](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t uniqueIndex = begin; uniqueIndex < end; uniqueIndex++)
+			{
+				const uint32_t requestIndex = uniqueRequests[uniqueIndex];
+				uniqueResults[uniqueIndex] = this->GetOrCompile(requests[requestIndex], keys[requestIndex]);
+			}
+		});
+
+	std::vector<std::shared_ptr<const CompiledShader>> results(requests.size());
+	for (uint32_t requestIndex = 0; requestIndex < requests.size(); requestIndex++)
+	{
+		results[requestIndex] = uniqueResults[keyToUniqueIndex.at(keys[requestIndex])];
+	}
+
+	return results;
+}
+
+std::shared_ptr<const aZero::Pipeline::CompiledShader> aZero::Pipeline::ShaderCache::GetOrCompile(const ShaderCompileRequest& request, uint64_t key)
+{
+	{
+		std::unique_lock<std::mutex> lock(m_Lock);
+		auto entry = m_Entries.find(key);
+		if (entry != m_Entries.end())
+		{
+			m_NumMemoryHits.fetch_add(1);
+			return entry->second;
+		}
+	}
+
+	std::shared_ptr<const CompiledShader> compiled;
+	if (std::optional<CompiledShader> loaded = this->Load(key))
+	{
+		m_NumDiskHits.fetch_add(1);
+		compiled = std::make_shared<const CompiledShader>(std::move(loaded.value()));
+	}
+	else
+	{
+		CompiledShader output;
+		m_NumCompilations.fetch_add(1);
+		if (!m_Compiler.Compile(request, output))
+		{
+			// Failures aren't cached, fixing the source changes the key anyway
+			return nullptr;
+		}
+
+		this->Save(key, output);
+		compiled = std::make_shared<const CompiledShader>(std::move(output));
+	}
+
+	// Another thread might have resolved the same key in the meantime, both results are equivalent
+	std::unique_lock<std::mutex> lock(m_Lock);
+	return m_Entries.emplace(key, std::move(compiled)).first->second;
+}
+
+void aZero::Pipeline::ShaderCache::ClearMemory()
+{
+	std::unique_lock<std::mutex> lock(m_Lock);
+	m_Entries.clear();
+}
+
+std::string aZero::Pipeline::ShaderCache::GetEntryPath(uint64_t key) const
+{
+	static constexpr char hexDigits[] = "0123456789abcdef";
+	std::string name(16, '0');
+	for (int32_t digit = 15; digit >= 0; digit--)
+	{
+		name[digit] = hexDigits[key & 0xF];
+		key >>= 4;
+	}
+
+	return (std::filesystem::path(m_CacheDirectory) / (name + ".azshader")).string();
+}
+
+std::optional<aZero::Pipeline::CompiledShader> aZero::Pipeline::ShaderCache::Load(uint64_t key) const
+{
+	Helper::MappedFile file;
+	if (!file.Open(this->GetEntryPath(key)))
+	{
+		return std::nullopt;
+	}
+
+	EntryReader reader(file.GetData(), file.GetSize());
+
+	FileHeader header;
+	if (!reader.Read(header)
+		|| header.Magic != Magic
+		|| header.Version != Version
+		|| header.Key != key
+		|| header.FileSize != file.GetSize())
+	{
+		return std::nullopt;
+	}
+
+	CompiledShader compiled;
+	if (!reader.Read(compiled.Bytecode, header.NumBytecodeBytes))
+	{
+		return std::nullopt;
+	}
+
+	// The counts come from disk, so they are bounded by the remaining bytes before anything is allocated from them
+	const uint64_t minReflectionSize = header.NumResources * MinResourceSize
+		+ (static_cast<uint64_t>(header.NumInputParameters) + header.NumOutputParameters) * MinSignatureParameterSize;
+	if (minReflectionSize > reader.GetRemaining())
+	{
+		return std::nullopt;
+	}
+
+	compiled.Reflection.Resources.resize(header.NumResources);
+	for (ShaderReflection::Resource& resource : compiled.Reflection.Resources)
+	{
+		if (!reader.Read(resource.Name)
+			|| !reader.Read(resource.ParameterType)
+			|| !reader.Read(resource.ShaderRegister)
+			|| !reader.Read(resource.RegisterSpace)
+			|| !reader.Read(resource.Num32BitConstants))
+		{
+			return std::nullopt;
+		}
+	}
+
+	compiled.Reflection.InputParameters.resize(header.NumInputParameters);
+	for (ShaderReflection::SignatureParameter& parameter : compiled.Reflection.InputParameters)
+	{
+		if (!reader.Read(parameter))
+		{
+			return std::nullopt;
+		}
+	}
+
+	compiled.Reflection.OutputParameters.resize(header.NumOutputParameters);
+	for (ShaderReflection::SignatureParameter& parameter : compiled.Reflection.OutputParameters)
+	{
+		if (!reader.Read(parameter))
+		{
+			return std::nullopt;
+		}
+	}
+
+	memcpy(compiled.Reflection.ThreadGroupSize, header.ThreadGroupSize, sizeof(header.ThreadGroupSize));
+	return compiled;
+}
+
+bool aZero::Pipeline::ShaderCache::Save(uint64_t key, const CompiledShader& compiled) const
+{
+	const std::filesystem::path path(this->GetEntryPath(key));
+	std::error_code error;
+	std::filesystem::create_directories(path.parent_path(), error);
+
+	FileHeader header{};
+	header.Magic = Magic;
+	header.Version = Version;
+	header.Key = key;
+	header.NumBytecodeBytes = static_cast<uint32_t>(compiled.Bytecode.size());
+	header.NumResources = static_cast<uint32_t>(compiled.Reflection.Resources.size());
+	header.NumInputParameters = static_cast<uint32_t>(compiled.Reflection.InputParameters.size());
+	header.NumOutputParameters = static_cast<uint32_t>(compiled.Reflection.OutputParameters.size());
+	memcpy(header.ThreadGroupSize, compiled.Reflection.ThreadGroupSize, sizeof(header.ThreadGroupSize));
+
+	EntryWriter writer;
+	writer.Write(&header, sizeof(header));
+	writer.Write(compiled.Bytecode.data(), compiled.Bytecode.size());
+	for (const ShaderReflection::Resource& resource : compiled.Reflection.Resources)
+	{
+		writer.Write(resource.Name);
+		writer.Write(resource.ParameterType);
+		writer.Write(resource.ShaderRegister);
+		writer.Write(resource.RegisterSpace);
+		writer.Write(resource.Num32BitConstants);
+	}
+
+	for (const ShaderReflection::SignatureParameter& parameter : compiled.Reflection.InputParameters)
+	{
+		writer.Write(parameter);
+	}
+
+	for (const ShaderReflection::SignatureParameter& parameter : compiled.Reflection.OutputParameters)
+	{
+		writer.Write(parameter);
+	}
+
+	// Patch the final size into the header so truncated files are rejected on load
+	std::vector<uint8_t>& data = writer.GetData();
+	header.FileSize = data.size();
+	memcpy(data.data(), &header, sizeof(header));
+
+	// Unique per thread since two caches could write the same entry at once
+	const std::filesystem::path tempPath = path.string() + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+	{
+		std::ofstream stream(tempPath, std::ios::out | std::ios::trunc | std::ios::binary);
+		if (!stream.is_open())
+		{
+			DEBUG_PRINT("Failed to open shader cache entry for writing: " + tempPath.string());
+			return false;
+		}
+
+		stream.write(reinterpret_cast<const char*>(data.data()), data.size());
+		if (!stream.good())
+		{
+			DEBUG_PRINT("Failed to write shader cache entry: " + tempPath.string());
+			return false;
+		}
+	}
+
+	std::filesystem::rename(tempPath, path, error);
+	if (error)
+	{
+		DEBUG_PRINT("Failed to move shader cache entry into place: " + path.string());
+		std::filesystem::remove(tempPath, error);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include "ShaderCompiler.hpp"
+#include "misc/NonCopyable.hpp"
+#include "misc/NonMovable.hpp"
+
+namespace aZero
+{
+	namespace Pipeline
+	{
+		/** @brief Persistent cache of compiled shaders and their reflection results.
+		* Entries are keyed by a hash of the source file, every transitively included file, the target profile, entry point, arguments and the compiler identifier.
+		* Changing any of those produces a new key, so stale entries are never returned and simply stay unused on disk.
+		* Hits are served from memory first and then from the cache directory, misses are compiled with the compiler and written back.
+
+		Entry file layout:
+			FileHeader
+			Bytecode
+			For each resource: name length, name, type, register, space, number of 32-bit constants
+			For each input and output parameter: name length, name, semantic index, mask
+		*/
+		class ShaderCache : public NonCopyable, public NonMovable
+		{
+		public:
+			static constexpr uint32_t Magic = 0x53485A61; // "aZHS"
+
+			// NOTE: Bump whenever the entry layout or ShaderReflection changes
+			static constexpr uint32_t Version = 1;
+
+			struct FileHeader
+			{
+				uint32_t Magic;
+				uint32_t Version;
+				uint64_t Key;
+				uint64_t FileSize;
+				uint32_t NumBytecodeBytes;
+				uint32_t NumResources;
+				uint32_t NumInputParameters;
+				uint32_t NumOutputParameters;
+				uint32_t ThreadGroupSize[3];
+				uint32_t Padding;
+			};
+
+			/**
+			@param compiler Used for cache misses, has to outlive the cache
+			@param cacheDirectory Directory that the entries are stored in, created on the first write
+			*/
+			ShaderCache(ShaderCompilerBase& compiler, const std::string& cacheDirectory);
+
+			/** Computes the cache key of the request by hashing the source and every file it includes, directly or through other includes.
+			* Quoted includes are resolved relative to the including file first and then through the request's include directories.
+			@param request
+			@return uint64_t
+			*/
+			uint64_t ComputeKey(const ShaderCompileRequest& request) const;
+
+			/** Returns the compiled shader for the request, compiling it if it isn't cached.
+			@param request
+			@return std::shared_ptr<const CompiledShader> nullptr if the compilation failed
+			*/
+			std::shared_ptr<const CompiledShader> Get(const ShaderCompileRequest& request);
+
+			/** Returns the compiled shaders for the requests. The misses are compiled in parallel on the job system.
+			@param requests
+			@return std::vector<std::shared_ptr<const CompiledShader>> Same order as the requests, nullptr for failed compilations
+			*/
+			std::vector<std::shared_ptr<const CompiledShader>> Get(std::span<const ShaderCompileRequest> requests);
+
+			/** Drops the entries held in memory, the next lookups are served from disk.
+			@return void
+			*/
+			void ClearMemory();
+
+			std::string GetEntryPath(uint64_t key) const;
+
+			uint32_t GetNumMemoryHits() const { return m_NumMemoryHits.load(); }
+			uint32_t GetNumDiskHits() const { return m_NumDiskHits.load(); }
+			uint32_t GetNumCompilations() const { return m_NumCompilations.load(); }
+
+		private:
+			ShaderCompilerBase& m_Compiler;
+			std::string m_CacheDirectory;
+
+			std::mutex m_Lock;
+			std::unordered_map<uint64_t, std::shared_ptr<const CompiledShader>> m_Entries;
+
+			std::atomic<uint32_t> m_NumMemoryHits = 0;
+			std::atomic<uint32_t> m_NumDiskHits = 0;
+			std::atomic<uint32_t> m_NumCompilations = 0;
+
+			std::shared_ptr<const CompiledShader> GetOrCompile(const ShaderCompileRequest& request, uint64_t key);
+			std::optional<CompiledShader> Load(uint64_t key) const;
+			bool Save(uint64_t key, const CompiledShader& compiled) const;
+		};
+	}
+}
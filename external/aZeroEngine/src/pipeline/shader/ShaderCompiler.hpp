@@ -0,0 +1,75 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace aZero
+{
+	namespace Pipeline
+	{
+		struct ShaderCompileRequest
+		{
+			std::string Path;
+			std::string TargetProfile;
+			std::string EntryPoint = "main";
+			std::vector<std::string> IncludeDirectories;
+
+			// Passed to the compiler after the arguments it always adds, ex. defines
+			std::vector<std::string> Arguments;
+		};
+
+		/** @brief Reflection results of a compiled shader in a form that can be cached on disk.
+		* Resources are in root parameter order.
+		*/
+		struct ShaderReflection
+		{
+			struct Resource
+			{
+				std::string Name;
+				uint32_t ParameterType = 0; // D3D12_ROOT_PARAMETER_TYPE
+				uint32_t ShaderRegister = 0;
+				uint32_t RegisterSpace = 0;
+				uint32_t Num32BitConstants = 0;
+			};
+
+			struct SignatureParameter
+			{
+				std::string SemanticName;
+				uint32_t SemanticIndex = 0;
+				uint32_t Mask = 0;
+			};
+
+			std::vector<Resource> Resources;
+			std::vector<SignatureParameter> InputParameters;
+			std::vector<SignatureParameter> OutputParameters;
+			uint32_t ThreadGroupSize[3] = { 0, 0, 0 };
+		};
+
+		struct CompiledShader
+		{
+			std::vector<uint8_t> Bytecode;
+			ShaderReflection Reflection;
+		};
+
+		/** @brief Compiles and reflects shaders for the ShaderCache.
+		* Implementations have to support Compile() being called from several threads at once since cache misses are compiled in parallel.
+		*/
+		class ShaderCompilerBase
+		{
+		public:
+			virtual ~ShaderCompilerBase() = default;
+
+			/** Identifies the compiler version and the settings it adds to every compilation. It is part of the cache key so changing it invalidates the cache.
+			@return std::string
+			*/
+			virtual std::string GetIdentifier() const = 0;
+
+			/** Compiles the shader described by the request and reflects its bindings.
+			@param request
+			@param output
+			@return bool False if the compilation or reflection failed
+			*/
+			virtual bool Compile(const ShaderCompileRequest& request, CompiledShader& output) = 0;
+		};
+	}
+}
@@ -18,7 +18,7 @@ aZero::Pipeline::VertexShader& aZero::Pipeline::VertexShader::operator=(VertexSh
 	return *this;
 }
 
-bool aZero::Pipeline::VertexShader::ValidateShaderTypeFromFilepath(const std::string& path)
+bool aZero::Pipeline::VertexShader::ValidateShaderTypeFromFilepath(const std::string& path) const
 {
 	return path.ends_with(m_ShaderExtension);
 }
@@ -50,30 +50,23 @@ DXGI_FORMAT aZero::Pipeline::VertexShader::ReflectionMaskToDXGIFormat(BYTE Mask)
 	return Format;
 }
 
-bool aZero::Pipeline::VertexShader::Reflect(Microsoft::WRL::ComPtr<IDxcResult>& compilationResult, Microsoft::WRL::ComPtr<IDxcUtils>& utils)
+bool aZero::Pipeline::VertexShader::ApplyReflection(const ShaderReflection& reflection)
 {
-	Microsoft::WRL::ComPtr<ID3D12ShaderReflection> reflection;
-	if (!Shader::ReflectImpl(compilationResult, utils, D3D12_SHADER_VISIBILITY::D3D12_SHADER_VISIBILITY_VERTEX, reflection))
-	{
-		return false;
-	}
+	m_InputElementDescs.clear();
+	m_InputElementSemanticNames.clear();
 
-	D3D12_SHADER_DESC shaderDesc{};
-	reflection->GetDesc(&shaderDesc);
-	m_InputElementDescs.reserve(shaderDesc.InputParameters);
-	m_InputElementSemanticNames.reserve(shaderDesc.InputParameters);
-	for (uint32_t ParamIndex = 0; ParamIndex < shaderDesc.InputParameters; ParamIndex++)
+	// Reserved up front since the descs point into the semantic names
+	m_InputElementDescs.reserve(reflection.InputParameters.size());
+	m_InputElementSemanticNames.reserve(reflection.InputParameters.size());
+	for (const ShaderReflection::SignatureParameter& SignatureParameter : reflection.InputParameters)
 	{
-		D3D12_SIGNATURE_PARAMETER_DESC SignatureParameterDesc{};
-		reflection->GetInputParameterDesc(ParamIndex, &SignatureParameterDesc);
-
-		m_InputElementSemanticNames.emplace_back(SignatureParameterDesc.SemanticName);
+		m_InputElementSemanticNames.emplace_back(SignatureParameter.SemanticName);
 
 		m_InputElementDescs.emplace_back(
 			D3D12_INPUT_ELEMENT_DESC{
 				.SemanticName = m_InputElementSemanticNames.back().c_str(),
-				.SemanticIndex = SignatureParameterDesc.SemanticIndex,
-				.Format = this->ReflectionMaskToDXGIFormat(SignatureParameterDesc.Mask),
+				.SemanticIndex = SignatureParameter.SemanticIndex,
+				.Format = this->ReflectionMaskToDXGIFormat(static_cast<BYTE>(SignatureParameter.Mask)),
 				.InputSlot = 0u,
 				.AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT,
 				.InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, // No way to get this via dxcompiler :(
@@ -82,28 +75,5 @@ bool aZero::Pipeline::VertexShader::Reflect(Microsoft::WRL::ComPtr<IDxcResult>&
 			);
 	}
 
-	return true;
-}
-
-bool aZero::Pipeline::VertexShader::CompileFromFile(IDxcCompilerX& compiler, const std::string& path)
-{
-	if (!this->ValidateShaderTypeFromFilepath(path))//
-	{
-		DEBUG_PRINT("Shader path (" + path + ") isn't valid (path doesn't end with '.vs.hlsl' etc...");
-		return false;
-	}
-
-	Microsoft::WRL::ComPtr<IDxcResult> compilationResult;
-	Microsoft::WRL::ComPtr<IDxcUtils> utils;
-	if (!Shader::CompileImpl(compiler, path, m_TargetSM, compilationResult, utils))
-	{
-		return false;
-	}
-
-	if (!this->Reflect(compilationResult, utils))
-	{
-		return false;
-	}
-
 	return true;
 }
\ No newline at end of file
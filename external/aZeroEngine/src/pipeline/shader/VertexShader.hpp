@@ -17,9 +17,11 @@ namespace aZero
 			static constexpr const char* m_TargetSM = "vs_6_6";
 			static constexpr const char* m_ShaderExtension = ".vs.hlsl";
 
-			bool ValidateShaderTypeFromFilepath(const std::string& path) override;
+			bool ValidateShaderTypeFromFilepath(const std::string& path) const override;
+			const char* GetTargetProfile() const override { return m_TargetSM; }
+			D3D12_SHADER_VISIBILITY GetShaderVisibility() const override { return D3D12_SHADER_VISIBILITY::D3D12_SHADER_VISIBILITY_VERTEX; }
 			DXGI_FORMAT ReflectionMaskToDXGIFormat(BYTE Mask);
-			bool Reflect(Microsoft::WRL::ComPtr<IDxcResult>& compilationResult, Microsoft::WRL::ComPtr<IDxcUtils>& utils);
+			bool ApplyReflection(const ShaderReflection& reflection) override;
 
 		public:
 			VertexShader() = default;
@@ -27,7 +29,6 @@ namespace aZero
 			VertexShader(VertexShader&& other) noexcept;
 			VertexShader& operator=(VertexShader&& other) noexcept;
 
-			bool CompileFromFile(IDxcCompilerX& compiler, const std::string& path) override;
 		};
 	}
 }
\ No newline at end of file
@@ -33,6 +33,12 @@ namespace aZero
 
 			RenderAPI::Buffer m_CameraBuffer;
 			RenderAPI::ShaderResourceView m_CameraDescriptor;
+
+			// Indices of the static meshes that passed each camera's CPU culling, camera i owns the region starting at i * MaxVisibleInstancesPerCamera
+			static constexpr uint32_t MaxCameras = 100;
+			static constexpr uint32_t MaxVisibleInstancesPerCamera = 1000;
+			RenderAPI::Buffer m_VisibleInstanceBuffer;
+			RenderAPI::ShaderResourceView m_VisibleInstanceDescriptor;
 			//
 
 			// Commandlist stuff
@@ -87,7 +93,8 @@ namespace aZero
 			// TODO: Support dynamic resizing, or atleast easy resizing
 			void Init(ID3D12DeviceX* device, RenderAPI::DescriptorHeap& resourceHeap, RenderAPI::ResourceRecycler& recycler)
 			{
-				const uint32_t frameBufferSize = 1000000;
+				// Initial staging capacity, the allocator grows if a frame uploads more
+				const uint64_t frameBufferSize = 1024 * 1024;
 				m_FrameAllocator = LinearFrameAllocator(device, frameBufferSize, recycler);
 
 				RenderAPI::Buffer::Desc primitiveBufferDesc(0, D3D12_HEAP_TYPE_UPLOAD);
@@ -101,9 +108,12 @@ namespace aZero
 				primitiveBufferDesc.NumBytes = sizeof(Scene::RenderData::DirectionalLight) * 100;
 				m_DirectionalLightBuffer = RenderAPI::Buffer(device, primitiveBufferDesc, &recycler);
 
-				primitiveBufferDesc.NumBytes = sizeof(Scene::RenderData::Camera::GPUVersion) * 100;
+				primitiveBufferDesc.NumBytes = sizeof(Scene::RenderData::Camera::GPUVersion) * MaxCameras;
 				m_CameraBuffer = RenderAPI::Buffer(device, primitiveBufferDesc, &recycler);
 
+				primitiveBufferDesc.NumBytes = sizeof(uint32_t) * MaxVisibleInstancesPerCamera * MaxCameras;
+				m_VisibleInstanceBuffer = RenderAPI::Buffer(device, primitiveBufferDesc, &recycler);
+
 				m_DirectCmdList = RenderAPI::CommandList(device, D3D12_COMMAND_LIST_TYPE_DIRECT);
 				m_CopyCmdList = RenderAPI::CommandList(device, D3D12_COMMAND_LIST_TYPE_COPY);
 				m_ComputeCmdList = RenderAPI::CommandList(device, D3D12_COMMAND_LIST_TYPE_COMPUTE);
@@ -114,7 +124,9 @@ namespace aZero
 				m_SpotLightDescriptor = RenderAPI::ShaderResourceView(device, resourceHeap, m_SpotLightBuffer, 1000, sizeof(Scene::RenderData::SpotLight), 0);
 				m_DirectionalLightDescriptor = RenderAPI::ShaderResourceView(device, resourceHeap, m_DirectionalLightBuffer, 100, sizeof(Scene::RenderData::DirectionalLight), 0);
 
-				m_CameraDescriptor = RenderAPI::ShaderResourceView(device, resourceHeap, m_CameraBuffer, 100, sizeof(Scene::RenderData::Camera::GPUVersion), 0);
+				m_CameraDescriptor = RenderAPI::ShaderResourceView(device, resourceHeap, m_CameraBuffer, MaxCameras, sizeof(Scene::RenderData::Camera::GPUVersion), 0);
+
+				m_VisibleInstanceDescriptor = RenderAPI::ShaderResourceView(device, resourceHeap, m_VisibleInstanceBuffer, MaxVisibleInstancesPerCamera * MaxCameras, sizeof(uint32_t), 0);
 
 #ifdef USE_DEBUG
 				m_StaticMeshBuffer.GetResource()->SetName(L"m_StaticMeshBuffer");
@@ -124,6 +136,8 @@ namespace aZero
 				m_DirectionalLightBuffer.GetResource()->SetName(L"m_DirectionalLightBuffer");
 
 				m_CameraBuffer.GetResource()->SetName(L"m_CameraBuffer");
+
+				m_VisibleInstanceBuffer.GetResource()->SetName(L"m_VisibleInstanceBuffer");
 #endif
 			};
 
@@ -1,58 +1,73 @@
 #pragma once
 #include "graphics_api/resource/buffer/Buffer.hpp"
 #include "graphics_api/command_recording/CommandList.hpp"
+#include "StagingCopyBatcher.hpp"
+#include "misc/EngineDebugMacros.hpp"
+#include "misc/Profiler.hpp"
 
 namespace aZero
 {
 	namespace Rendering
 	{
-		class LinearFrameAllocator : public NonCopyable
+		/** @brief Per-frame staging allocator that queues buffer writes and records them as merged copies.
+		* Writes are kept on the CPU until recorded, at which point StagingCopyBatcher merges them per destination and packs them into the upload buffer.
+		* The upload buffer grows when a frame needs more than its capacity. The replaced buffer is handed to the ResourceRecycler so copies recorded earlier in the frame stay valid.
+		*/
+		class LinearFrameAllocator : public NonCopyable, private CopyRecorder<RenderAPI::Buffer*>
 		{
-		public:
-			struct Allocation
-			{
-				RenderAPI::Buffer* DstResource = nullptr;
-				uint32_t DstBufferOffset;
-				uint32_t SrcBufferOffset;
-				uint32_t NumBytes;
-			};
-
 		private:
+			ID3D12DeviceX* m_Device = nullptr;
+			RenderAPI::ResourceRecycler* m_Recycler = nullptr;
+
 			RenderAPI::Buffer m_StagingBuffer;
-			uint32_t m_CurrentAllocOffset = 0;
+			uint64_t m_StagingBufferSize = 0;
+			uint64_t m_CurrentAllocOffset = 0;
 
-			// TODO: Implement a more sophisticated approach without raw-pointers (both as hash and in the Allocation struct)?
-			std::unordered_map<RenderAPI::Buffer*, std::vector<Allocation>> m_Allocations;
+			StagingCopyBatcher<RenderAPI::Buffer*> m_Batcher;
 
-			uint32_t GetNextAllocOffset(uint32_t NumBytes)
+			// Valid while RecordAllocations() runs
+			RenderAPI::CommandList* m_RecordingCmdList = nullptr;
+			uint64_t m_RecordingStagingOffset = 0;
+
+			void CreateStagingBuffer(uint64_t numBytes)
 			{
-				const uint32_t AllocOffset = m_CurrentAllocOffset;
-				m_CurrentAllocOffset += NumBytes;
-				return AllocOffset;
+				RenderAPI::Buffer::Desc desc(numBytes, D3D12_HEAP_TYPE_UPLOAD);
+				m_StagingBuffer = RenderAPI::Buffer(m_Device, desc, m_Recycler);
+				m_StagingBufferSize = numBytes;
+				m_CurrentAllocOffset = 0;
 			}
 
-			void Write(const void* const Data, uint32_t Offset, uint32_t NumBytes)
+			uint8_t* AllocateStaging(uint64_t numBytes) override
 			{
-				m_StagingBuffer.Write(Data, NumBytes, Offset);
-			}
+				uint64_t allocOffset = (m_CurrentAllocOffset + StagingCopyBatcher<RenderAPI::Buffer*>::StagingAlignment - 1) & ~(StagingCopyBatcher<RenderAPI::Buffer*>::StagingAlignment - 1);
+				if (allocOffset + numBytes > m_StagingBufferSize)
+				{
+					const uint64_t newSize = std::max(m_StagingBufferSize * 2, numBytes);
+					DEBUG_PRINT("LinearFrameAllocator: Growing staging buffer from " + std::to_string(m_StagingBufferSize) + " to " + std::to_string(newSize) + " bytes");
+					this->CreateStagingBuffer(newSize);
+					allocOffset = 0;
+				}
 
-		public:
-			LinearFrameAllocator() = default;
+				m_RecordingStagingOffset = allocOffset;
+				m_CurrentAllocOffset = allocOffset + numBytes;
+				return static_cast<uint8_t*>(m_StagingBuffer.GetCPUAccessibleMemory()) + allocOffset;
+			}
 
-			LinearFrameAllocator(ID3D12DeviceX* device, uint32_t numBytes, RenderAPI::ResourceRecycler& recycler)
+			void RecordCopy(RenderAPI::Buffer* dst, uint64_t dstOffset, uint64_t stagingOffset, uint64_t numBytes) override
 			{
-				RenderAPI::Buffer::Desc desc(numBytes, D3D12_HEAP_TYPE_UPLOAD);
-				m_StagingBuffer = RenderAPI::Buffer(device, desc, &recycler);
+				(*m_RecordingCmdList)->CopyBufferRegion(dst->GetResource(), dstOffset, m_StagingBuffer.GetResource(), m_RecordingStagingOffset + stagingOffset, numBytes);
 			}
 
-			bool CanAllocate(uint32_t NumBytes)
+		public:
+			LinearFrameAllocator() = default;
+
+			LinearFrameAllocator(ID3D12DeviceX* device, uint64_t numBytes, RenderAPI::ResourceRecycler& recycler)
+				:m_Device(device), m_Recycler(&recycler)
 			{
-				const uint32_t OffsetAfterAlloc = m_CurrentAllocOffset + NumBytes;
-				const uint32_t MemorySize = static_cast<uint32_t>(m_StagingBuffer.GetResource()->GetDesc().Width);
-				return OffsetAfterAlloc <= MemorySize;
+				this->CreateStagingBuffer(numBytes);
 			}
 
-			void AddAllocation(const void* const Data, RenderAPI::Buffer* DstResource, uint32_t DstOffset, uint32_t NumBytes)
+			void AddAllocation(const void* const Data, RenderAPI::Buffer* DstResource, uint64_t DstOffset, uint64_t NumBytes)
 			{
 				const UINT64 DstResourceSize = DstResource->GetResource()->GetDesc().Width;
 				if (DstResourceSize < (DstOffset + NumBytes))
@@ -60,56 +75,34 @@ namespace aZero
 					throw std::invalid_argument("LinearFrameAllocator::AddAllocation() => OOR write to DstResource");
 				}
 
-				const uint32_t OffsetAfterAlloc = m_CurrentAllocOffset + NumBytes;
-				const uint32_t MemorySizeBytes = static_cast<uint32_t>(m_StagingBuffer.GetResource()->GetDesc().Width);
-				if (OffsetAfterAlloc > MemorySizeBytes)
-				{
-					throw; // TODO: Handle
-				}
-
-				const uint32_t SrcAllocOffset = this->GetNextAllocOffset(NumBytes);
-				this->Write(Data, SrcAllocOffset, NumBytes);
-
-				Allocation Alloc;
-				Alloc.DstBufferOffset = DstOffset;
-				Alloc.DstResource = DstResource;
-				Alloc.NumBytes = NumBytes;
-				Alloc.SrcBufferOffset = SrcAllocOffset;
-
-				m_Allocations[DstResource].push_back(Alloc);
+				m_Batcher.Add(Data, DstResource, DstOffset, NumBytes);
 			}
 
 			void ClearQueuedAllocations()
 			{
-				m_Allocations.clear();
+				m_Batcher.ClearQueued();
 			}
 
+			// NOTE: Only call once the GPU has finished the copies of the frame that last used the allocator
 			void Reset()
 			{
-				this->ClearQueuedAllocations();
+				m_Batcher.Reset();
 				m_CurrentAllocOffset = 0;
 			}
 
-			void RecordAllocations(RenderAPI::CommandList& cmdList)
+			StagingCopyBatcher<RenderAPI::Buffer*>::RecordStats RecordAllocations(RenderAPI::CommandList& cmdList)
 			{
-				int OuterCounter = 0;
-				for (const auto& [Resource, Allocations] : m_Allocations)
-				{
-					int InnerCounter = 0;
-					for (const Allocation& Alloc : Allocations)
-					{
-						if (OuterCounter == 3 && InnerCounter == 1)
-						{
-							//continue;
-						}
-						cmdList->CopyBufferRegion(Alloc.DstResource->GetResource(), Alloc.DstBufferOffset, m_StagingBuffer.GetResource(), Alloc.SrcBufferOffset, Alloc.NumBytes);
-						InnerCounter++;
-					}
-
-					OuterCounter++;
-				}
-				m_Allocations.clear();
+				PROFILE_SCOPE("LinearFrameAllocator::RecordAllocations");
+				m_RecordingCmdList = &cmdList;
+				const auto stats = m_Batcher.Record(*this);
+				m_RecordingCmdList = nullptr;
+
+				PROFILE_COUNTER(StagedBytes, stats.NumBytesCopied);
+				PROFILE_COUNTER(CopyRegions, stats.NumCopies);
+				return stats;
 			}
+
+			uint64_t GetStagingBufferSize() const { return m_StagingBufferSize; }
 		};
 	}
-}
\ No newline at end of file
+}
@@ -1,12 +1,14 @@
 #include "Renderer.hpp"
 #include "scene/Scene.hpp"
+#include "misc/Profiler.hpp"
+#include "misc/JobSystem.hpp"
 
 namespace aZero
 {
 	namespace Rendering
 	{
-		Renderer::Renderer(ID3D12DeviceX* device, uint32_t bufferCount, IDxcCompilerX& compiler)
-			:m_Compiler(compiler), m_diDevice(device), m_BufferCount(bufferCount)
+		Renderer::Renderer(ID3D12DeviceX* device, uint32_t bufferCount)
+			:m_ShaderCache(m_ShaderCompiler, PROJECT_DIRECTORY + SHADER_CACHED_RELATIVE_PATH), m_diDevice(device), m_BufferCount(bufferCount)
 		{
 			D3D12_FEATURE_DATA_D3D12_OPTIONS7 featureData = {};
 			device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS7, &featureData, sizeof(featureData));
@@ -43,9 +45,23 @@ namespace aZero
 
 		void Renderer::InitPipeline()
 		{
-			this->InitMeshObjectCullPipeline();
-			this->InitMeshletCullPipeline();
-			this->InitMeshletDrawPipeline();
+			// Compiles the shaders that aren't cached yet in parallel, the pipelines below then get them from the cache's memory
+			const std::string shaderDirectory = PROJECT_DIRECTORY + SHADER_SOURCE_RELATIVE_PATH;
+			const std::string meshObjectCullingPath = shaderDirectory + "MeshObjectCulling.cs.hlsl";
+			const std::string meshletCullingPath = shaderDirectory + "MeshletCulling.cs.hlsl";
+			const std::string meshletDrawMSPath = shaderDirectory + "MeshletDraw.ms.hlsl";
+			const std::string meshletDrawPSPath = shaderDirectory + "MeshletDraw.ps.hlsl";
+			const std::array<Pipeline::ShaderCompileRequest, 4> shaderRequests = {
+				m_MeshObjectCullingCS.GetCompileRequest(meshObjectCullingPath),
+				m_MeshletCullingCS.GetCompileRequest(meshletCullingPath),
+				m_MeshletDrawMS.GetCompileRequest(meshletDrawMSPath),
+				m_MeshletDrawPS.GetCompileRequest(meshletDrawPSPath)
+			};
+			m_ShaderCache.Get(shaderRequests);
+
+			this->InitMeshObjectCullPipeline(meshObjectCullingPath);
+			this->InitMeshletCullPipeline(meshletCullingPath);
+			this->InitMeshletDrawPipeline(meshletDrawMSPath, meshletDrawPSPath);
 
 			// TODO: One for each pass above
 			Rendering::MeshShaderPass::Description msPassDesc;
@@ -56,16 +72,16 @@ namespace aZero
 			m_RenderPasses.push_back(new Rendering::MeshShaderPass(std::move(msPassDesc)));
 		}
 
-		void Renderer::InitMeshObjectCullPipeline()
+		void Renderer::InitMeshObjectCullPipeline(const std::string& csPath)
 		{
-			m_MeshObjectCullingCS.CompileFromFile(m_Compiler, PROJECT_DIRECTORY + std::string("shaderSource/MeshObjectCulling.cs.hlsl"));
+			m_MeshObjectCullingCS.CompileFromCache(m_ShaderCache, csPath);
 			Pipeline::ComputeShaderPass::Description icDesc;
 			m_MeshObjectCullingPass.Compile(m_diDevice, icDesc, m_MeshObjectCullingCS);
 		}
 
-		void Renderer::InitMeshletCullPipeline()
+		void Renderer::InitMeshletCullPipeline(const std::string& csPath)
 		{
-			m_MeshletCullingCS.CompileFromFile(m_Compiler, PROJECT_DIRECTORY + std::string("shaderSource/MeshletCulling.cs.hlsl"));
+			m_MeshletCullingCS.CompileFromCache(m_ShaderCache, csPath);
 			Pipeline::ComputeShaderPass::Description icDesc;
 			m_MeshletCullingPass.Compile(m_diDevice, icDesc, m_MeshletCullingCS);
 
@@ -101,10 +117,10 @@ namespace aZero
 #endif
 		}
 
-		void Renderer::InitMeshletDrawPipeline()
+		void Renderer::InitMeshletDrawPipeline(const std::string& msPath, const std::string& psPath)
 		{
-			m_MeshletDrawMS.CompileFromFile(m_Compiler, PROJECT_DIRECTORY + std::string("shaderSource/MeshletDraw.ms.hlsl"));
-			m_MeshletDrawPS.CompileFromFile(m_Compiler, PROJECT_DIRECTORY + std::string("shaderSource/MeshletDraw.ps.hlsl"));
+			m_MeshletDrawMS.CompileFromCache(m_ShaderCache, msPath);
+			m_MeshletDrawPS.CompileFromCache(m_ShaderCache, psPath);
 
 			Pipeline::MeshShaderPass::Description pipelineDesc;
 			pipelineDesc.m_RenderTargets.push_back({ DXGI_FORMAT::DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, "ColorTarget" });
@@ -158,6 +174,7 @@ namespace aZero
 			const bool hasNewFrameStarted = AdvanceFrameIfReady();
 			if (hasNewFrameStarted)
 			{
+				PROFILE_BEGIN_FRAME();
 				m_FrameIndex = static_cast<uint32_t>(m_FrameCount % m_FrameContexts.size());
 				m_FrameCount++;
 				m_NewResourceRecycler.SetFrameIndex(m_FrameIndex);
@@ -171,10 +188,12 @@ namespace aZero
 		{
 			FrameContext& frameContext = this->GetCurrentContext();
 			frameContext.SetLatestSignal(m_DirectCommandQueue.Signal());
+			PROFILE_END_FRAME();
 		}
 
 		void Renderer::FlushFrameAllocations()
 		{
+			PROFILE_SCOPE("Renderer::FlushFrameAllocations");
 			FrameContext& frameContext = this->GetCurrentContext();
 
 			// Perform uploads for all updated/new assets and other stagings
@@ -183,8 +202,9 @@ namespace aZero
 			frameContext.m_FrameAllocator.ClearQueuedAllocations();
 		}
 		
-		void Renderer::RecordMeshObjectCullingPass(const BindingConstants& bindings, uint32_t numStaticMeshes)
+		void Renderer::RecordMeshObjectCullingPass(const BindingConstants& bindings, uint32_t numVisibleInstances, uint32_t visibleInstanceOffset)
 		{
+			PROFILE_SCOPE("Renderer::RecordMeshObjectCullingPass");
 			FrameContext& frameContext = this->GetCurrentContext();
 			auto& cmdList = frameContext.m_DirectCmdList;
 
@@ -208,18 +228,22 @@ namespace aZero
 				uint32_t NumMeshObjects;
 				uint32_t IndirectArgumentMeshCullingBuffer;
 				uint32_t PassedMeshesCounterBuffer;
+				uint32_t VisibleInstanceBuffer;
+				uint32_t VisibleInstanceOffset;
 			} passConstants;
 
-			passConstants.NumMeshObjects = numStaticMeshes;
+			passConstants.NumMeshObjects = numVisibleInstances;
 			passConstants.IndirectArgumentMeshCullingBuffer = m_MeshObjectCullingUAV.GetHeapIndex();
 			passConstants.PassedMeshesCounterBuffer = m_PassedMeshCountUAV.GetHeapIndex();
+			passConstants.VisibleInstanceBuffer = frameContext.m_VisibleInstanceDescriptor.GetHeapIndex();
+			passConstants.VisibleInstanceOffset = visibleInstanceOffset;
 
 			auto bindingsBinding = m_MeshObjectCullingPass.GetConstantBindingIndex("Bindings");
 			cmdList.SetComputeRoot32BitConstantsSafe(bindingsBinding.GetRootIndex(), bindingsBinding.GetNumConstants(), &bindings, 0);
 
 			auto passConstantsBinding = m_MeshObjectCullingPass.GetConstantBindingIndex("PassConstants");
 			cmdList.SetComputeRoot32BitConstantsSafe(passConstantsBinding.GetRootIndex(), passConstantsBinding.GetNumConstants(), &passConstants, 0);
-			cmdList->Dispatch(std::ceil(numStaticMeshes / 64.f), 1, 1);
+			cmdList->Dispatch(std::ceil(numVisibleInstances / 64.f), 1, 1);
 
 			barrier = CD3DX12_RESOURCE_BARRIER::Transition(m_MeshObjectCullingBuffer.GetResource(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
 			cmdList->ResourceBarrier(1, &barrier);
@@ -227,6 +251,7 @@ namespace aZero
 
 		void Renderer::RecordMeshLetCullingPass(const BindingConstants& bindings)
 		{
+			PROFILE_SCOPE("Renderer::RecordMeshLetCullingPass");
 			FrameContext& frameContext = this->GetCurrentContext();
 			auto& cmdList = frameContext.m_DirectCmdList;
 
@@ -253,6 +278,7 @@ namespace aZero
 
 		void Renderer::ClearRenderSurfaces(const Scene::RenderData::Camera& camera)
 		{
+			PROFILE_SCOPE("Renderer::ClearRenderSurfaces");
 			FrameContext& frameContext = this->GetCurrentContext();
 
 			std::array<ID3D12DescriptorHeap*, 2> heaps{ m_ResourceHeapNew.Get(), m_SamplerHeapNew.Get() };
@@ -305,6 +331,7 @@ namespace aZero
 
 		void Renderer::RecordMeshDrawingPass(const BindingConstants& bindings, const Scene::RenderData::Camera& camera, std::optional<Rendering::RenderTarget*> renderTarget, std::optional<Rendering::DepthStencilTarget*> depthStencilTarget)
 		{
+			PROFILE_SCOPE("Renderer::RecordMeshDrawingPass");
 			FrameContext& frameContext = this->GetCurrentContext();
 			auto& cmdList = frameContext.m_DirectCmdList;
 
@@ -340,8 +367,13 @@ namespace aZero
 			m_DirectCommandQueue.ExecuteCommandList(cmdList, false);
 		}
 
-		void Renderer::Render(const Scene::SceneNew& scene)
+		void Renderer::Render(Scene::SceneNew& scene)
 		{
+			PROFILE_SCOPE("Renderer::Render");
+
+			// Apply all render state changes made since the last frame in one pass
+			scene.FlushRenderUpdates();
+
 			FrameContext& frameContext = this->GetCurrentContext();
 
 			// Perform uploads for all updated/new assets and other stagings
@@ -350,7 +382,7 @@ namespace aZero
 
 			// todo Save start offset for the instances inside the buffer so each scene has its own portion
 			const auto& staticMeshInstances = scene.GetProxy()->m_StaticMeshes.GetData();
-			frameContext.m_StaticMeshBuffer.Write(staticMeshInstances.data(), staticMeshInstances.size() * sizeof(staticMeshInstances[0]), 0);
+			PROFILE_COUNTER(Instances, staticMeshInstances.size());
 
 			const auto& pointLights = scene.GetProxy()->m_PointLights.GetData();
 			frameContext.m_PointLightBuffer.Write(pointLights.data(), pointLights.size() * sizeof(pointLights[0]), 0);
@@ -367,31 +399,76 @@ namespace aZero
 			struct { bool operator()(const Scene::RenderData::Camera& a, const Scene::RenderData::Camera& b) const { return a.m_Layer < b.m_Layer; } } customLess;
 			std::sort(cameras.begin(), cameras.end(), customLess);
 
-			uint32_t lastCameraIndex = 0;
-			for (const auto& camera : cameras)
+			// Only cameras with a target are rendered, each one owns a slot in the camera buffer and a region in the visible instance buffer
+			std::erase_if(cameras, [](const Scene::RenderData::Camera& camera) { return !camera.m_RenderTarget.has_value() && !camera.m_DepthStencilTarget.has_value(); });
+
+			// Cameras are culled and have their GPU data written on the job system, each one only writes to its own slot and region of the mapped buffers
+			m_CameraPreparations.resize(cameras.size());
+			Jobs::GetJobSystem().ParallelFor(static_cast<uint32_t>(cameras.size()), 1, [&](uint32_t begin, uint32_t end)
+				{
+					for (uint32_t cameraIndex = begin; cameraIndex < end; cameraIndex++)
+					{
+						const auto& camera = cameras[cameraIndex];
+						CameraPreparation& preparation = m_CameraPreparations[cameraIndex];
+
+						BindingConstants& constants = preparation.Constants;
+						constants.InstanceBuffer = frameContext.m_StaticMeshDescriptor.GetHeapIndex();
+						constants.MeshBuffer = m_ResourceManager.m_MeshBufferView.GetHeapIndex();
+						constants.CameraBuffer = frameContext.m_CameraDescriptor.GetHeapIndex();
+						constants.CameraID = cameraIndex;
+						constants.IndirectArgumentMeshletCullingBuffer = m_MeshletDrawArgumentUAV.GetHeapIndex();
+						constants.MeshletInstanceBuffer = m_MeshletInstanceUAV.GetHeapIndex();
+
+						const auto gpuCamera = camera.CreateGPUVersion();
+						frameContext.m_CameraBuffer.Write(&gpuCamera, sizeof(gpuCamera), sizeof(gpuCamera) * cameraIndex);
+
+						preparation.VisibleInstances.clear();
+						scene.GetProxy()->CullStaticMeshes(camera, preparation.VisibleInstances);
+						frameContext.m_VisibleInstanceBuffer.Write(preparation.VisibleInstances.data(), preparation.VisibleInstances.size() * sizeof(uint32_t), cameraIndex * FrameContext::MaxVisibleInstancesPerCamera * sizeof(uint32_t));
+					}
+				});
+
+			// The GPU only reads the instances that passed the CPU culling of some camera so only those runs of the instance buffer are written
+			m_IsInstanceVisible.assign(staticMeshInstances.size(), 0);
+			for (const CameraPreparation& preparation : m_CameraPreparations)
 			{
-				if (camera.m_RenderTarget.has_value() || camera.m_DepthStencilTarget.has_value())
+				for (const uint32_t instanceIndex : preparation.VisibleInstances)
 				{
-					BindingConstants constants;
-					constants.InstanceBuffer = frameContext.m_StaticMeshDescriptor.GetHeapIndex();
-					constants.MeshBuffer = m_ResourceManager.m_MeshBufferView.GetHeapIndex();
-					constants.CameraBuffer = frameContext.m_CameraDescriptor.GetHeapIndex();
-					constants.CameraID = lastCameraIndex;
-					constants.IndirectArgumentMeshletCullingBuffer = m_MeshletDrawArgumentUAV.GetHeapIndex();
-					constants.MeshletInstanceBuffer = m_MeshletInstanceUAV.GetHeapIndex();
+					m_IsInstanceVisible[instanceIndex] = 1;
+				}
+			}
 
-					const auto gpuCamera = camera.CreateGPUVersion();
-					frameContext.m_CameraBuffer.Write(&gpuCamera, sizeof(gpuCamera), sizeof(gpuCamera) * lastCameraIndex);
-					lastCameraIndex++;
+			for (uint32_t runStart = 0; runStart < staticMeshInstances.size();)
+			{
+				if (!m_IsInstanceVisible[runStart])
+				{
+					runStart++;
+					continue;
+				}
+
+				uint32_t runEnd = runStart + 1;
+				while (runEnd < staticMeshInstances.size() && m_IsInstanceVisible[runEnd])
+				{
+					runEnd++;
+				}
+
+				frameContext.m_StaticMeshBuffer.Write(&staticMeshInstances[runStart], (runEnd - runStart) * sizeof(staticMeshInstances[0]), runStart * sizeof(staticMeshInstances[0]));
+				runStart = runEnd;
+			}
 
-					this->ClearRenderSurfaces(camera);
+			// Commands are recorded on the render thread in layer order
+			for (uint32_t cameraIndex = 0; cameraIndex < cameras.size(); cameraIndex++)
+			{
+				const auto& camera = cameras[cameraIndex];
+				const CameraPreparation& preparation = m_CameraPreparations[cameraIndex];
 
-					this->RecordMeshObjectCullingPass(constants, staticMeshInstances.size());
+				this->ClearRenderSurfaces(camera);
 
-					this->RecordMeshLetCullingPass(constants);
+				this->RecordMeshObjectCullingPass(preparation.Constants, preparation.VisibleInstances.size(), cameraIndex * FrameContext::MaxVisibleInstancesPerCamera);
 
-					this->RecordMeshDrawingPass(constants, camera, camera.m_RenderTarget, camera.m_DepthStencilTarget);
-				}
+				this->RecordMeshLetCullingPass(preparation.Constants);
+
+				this->RecordMeshDrawingPass(preparation.Constants, camera, camera.m_RenderTarget, camera.m_DepthStencilTarget);
 			}
 
 			/*m_RenderPasses[0]->m_Desc.ExecutionCount = cameras.size();
@@ -484,6 +561,9 @@ namespace aZero
 
 			FrameContext& context = this->GetCurrentContext();
 			m_ResourceManager.UpdateRenderState(m_diDevice, context.m_DirectCmdList, m_NewResourceRecycler, m_ResourceHeapNew, *texture);
+
+			// The texels have been copied to the staging buffer, keeping the cooked file mapped would stop the texture cache from replacing it
+			texture->m_Data.CookedFile.Close();
 			m_DirectCommandQueue.ExecuteCommandList(context.m_DirectCmdList);
 		}
 
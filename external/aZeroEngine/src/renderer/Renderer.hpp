@@ -3,6 +3,8 @@
 #include "assets/Asset.hpp"
 #include "pipeline/shader/VertexShader.hpp"
 #include "pipeline/shader/PixelShader.hpp"
+#include "pipeline/shader/DxcShaderCompiler.hpp"
+#include "pipeline/shader/ShaderCache.hpp"
 #include "misc/CallbackExecutor.hpp"
 #include "graphics_api/resource/buffer/VertexBuffer.hpp"
 #include "graphics_api/resource/buffer/IndexedBuffer.hpp"
@@ -37,7 +39,7 @@ namespace aZero
 			friend class Engine;
 		public:
 			Renderer() = default;
-			Renderer(ID3D12DeviceX* device, uint32_t bufferCount, IDxcCompilerX& compiler);
+			Renderer(ID3D12DeviceX* device, uint32_t bufferCount);
 			Renderer(Renderer&&) noexcept = default;
 			Renderer& operator=(Renderer&&) noexcept = default;
 
@@ -54,7 +56,7 @@ namespace aZero
 
 			void FlushFrameAllocations();
 
-			void Render(const Scene::SceneNew& scene);
+			void Render(Scene::SceneNew& scene);
 
 			void CopyRenderTargetToSwapChain(RenderAPI::SwapChain& swapChain, Rendering::RenderTarget& renderTarget);
 
@@ -78,9 +80,9 @@ namespace aZero
 			bool AdvanceFrameIfReady();
 
 			void InitPipeline();
-			void InitMeshObjectCullPipeline();
-			void InitMeshletCullPipeline();
-			void InitMeshletDrawPipeline();
+			void InitMeshObjectCullPipeline(const std::string& csPath);
+			void InitMeshletCullPipeline(const std::string& csPath);
+			void InitMeshletDrawPipeline(const std::string& msPath, const std::string& psPath);
 
 			void ClearRenderSurfaces(const Scene::RenderData::Camera& camera);
 			
@@ -92,7 +94,9 @@ namespace aZero
 			// todo Figure out how this should be used to defer destruction of descriptors so that they wont be used until their no longer in use
 			aZero::CallbackExecutor m_CallbackExecutor;
 
-			IDxcCompilerX& m_Compiler;
+			// Shaders compiled on a previous launch are loaded from the cache directory instead of being recompiled
+			Pipeline::DxcShaderCompiler m_ShaderCompiler;
+			Pipeline::ShaderCache m_ShaderCache;
 
 			RenderAPI::CommandQueue m_DirectCommandQueue;
 			RenderAPI::CommandQueue m_CopyCommandQueue;
@@ -120,7 +124,16 @@ namespace aZero
 				uint32_t MeshletInstanceBuffer;
 			};
 			
-			void RecordMeshObjectCullingPass(const BindingConstants& bindings, uint32_t numStaticMeshes);
+			// Per-camera data prepared on the job system before any commands are recorded, reused across frames to avoid reallocating the visible lists
+			struct CameraPreparation
+			{
+				BindingConstants Constants;
+				std::vector<uint32_t> VisibleInstances;
+			};
+			std::vector<CameraPreparation> m_CameraPreparations;
+			std::vector<uint8_t> m_IsInstanceVisible;
+
+			void RecordMeshObjectCullingPass(const BindingConstants& bindings, uint32_t numVisibleInstances, uint32_t visibleInstanceOffset);
 			void RecordMeshLetCullingPass(const BindingConstants& bindings);
 			void RecordMeshDrawingPass(const BindingConstants& bindings, const Scene::RenderData::Camera& camera, std::optional<Rendering::RenderTarget*> renderTarget, std::optional<Rendering::DepthStencilTarget*> depthStencilTarget);
 
@@ -28,6 +28,9 @@ namespace aZero
 				uint32_t IndicesBuffer;
 				uint32_t PositionBuffer;
 				uint32_t VertexDataBuffer;
+
+				// Asset::VertexFormat of the position and vertex data buffers
+				uint32_t VertexFormat;
 				DirectX::BoundingSphere Bounds;
 			};
 
@@ -66,6 +69,7 @@ namespace aZero
 				gpuMesh.PositionBuffer = meshletBuffer.GetPositionsIndex();
 				gpuMesh.PrimitiveBuffer = meshletBuffer.GetPrimitivesIndex();
 				gpuMesh.VertexDataBuffer = meshletBuffer.GetGenericVertexDataIndex();
+				gpuMesh.VertexFormat = static_cast<uint32_t>(data.VertexFormat);
 				gpuMesh.MeshletCount = data.Meshlets.size();
 
 				frameAllocator.AddAllocation(&gpuMesh, &m_MeshDataBuffer.GetBuffer(), mesh.GetRenderID() * sizeof(gpuMesh), sizeof(gpuMesh));
@@ -103,23 +107,35 @@ namespace aZero
 				if (texture.GetRenderID() == Asset::InvalidRenderID) // Doesnt have a render proxy
 				{
 					const auto& data = texture.GetData();
-					m_TextureMap[texture.GetAssetID()] = RenderAPI::Texture2D(device, RenderAPI::Texture2D::Desc(data.Width, data.Height, data.Format, D3D12_RESOURCE_FLAG_ALLOW_SIMULTANEOUS_ACCESS, D3D12_RESOURCE_STATE_COPY_DEST), &recycler, {});
-					m_TextureDescriptorMap[texture.GetAssetID()] = RenderAPI::ShaderResourceView(device, descriptorHeap, m_TextureMap[texture.GetAssetID()]);
+					if (!data.HasTexels())
+					{
+						throw std::runtime_error("ResourceManager::UpdateRenderState() => Texture has no texel data, it has to be reloaded before it can be uploaded again");
+					}
+
+					const uint32_t numMips = static_cast<uint32_t>(data.Mips.size());
+					RenderAPI::Texture2D::Desc textureDesc(data.Width, data.Height, data.Format, D3D12_RESOURCE_FLAG_ALLOW_SIMULTANEOUS_ACCESS, D3D12_RESOURCE_STATE_COPY_DEST);
+					textureDesc.MipLevels = numMips;
+					m_TextureMap[texture.GetAssetID()] = RenderAPI::Texture2D(device, textureDesc, &recycler, {});
+					m_TextureDescriptorMap[texture.GetAssetID()] = RenderAPI::ShaderResourceView(device, descriptorHeap, m_TextureMap[texture.GetAssetID()], numMips);
 					texture.m_RenderID = m_TextureDescriptorMap[texture.GetAssetID()].GetHeapIndex();
 
-					const uint64_t stagingBufferSize = static_cast<uint64_t>(GetRequiredIntermediateSize(m_TextureMap[texture.GetAssetID()].GetResource(), 0, 1));
+					const uint64_t stagingBufferSize = static_cast<uint64_t>(GetRequiredIntermediateSize(m_TextureMap[texture.GetAssetID()].GetResource(), 0, numMips));
 					RenderAPI::Buffer stagingBuffer(device, RenderAPI::Buffer::Desc(stagingBufferSize, D3D12_HEAP_TYPE_UPLOAD), &recycler);
 
-					D3D12_SUBRESOURCE_DATA subresourceData{};
-					subresourceData.pData = data.TexelData.data();
-					subresourceData.RowPitch = /*roundUp(*/data.Width * sizeof(DWORD)/*, D3D12_TEXTURE_DATA_PITCH_ALIGNMENT)*/;
-					subresourceData.SlicePitch = subresourceData.RowPitch * data.Height;
+					// One subresource per mip, read straight from the mapped cooked file for cached textures
+					std::vector<D3D12_SUBRESOURCE_DATA> subresourceData(numMips);
+					for (uint32_t mipIndex = 0; mipIndex < numMips; mipIndex++)
+					{
+						subresourceData[mipIndex].pData = data.GetTexels() + data.Mips[mipIndex].Offset;
+						subresourceData[mipIndex].RowPitch = data.Mips[mipIndex].RowPitch;
+						subresourceData[mipIndex].SlicePitch = data.Mips[mipIndex].Size;
+					}
 
 					UpdateSubresources(
 						cmdList.Get(),
 						m_TextureMap[texture.GetAssetID()].GetResource(),
 						stagingBuffer.GetResource(),
-						0, 0, 1, &subresourceData);
+						0, 0, numMips, subresourceData.data());
 
 					auto barrier = m_TextureMap[texture.GetAssetID()].CreateTransition(D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE);
 					cmdList->ResourceBarrier(1, &barrier);
@@ -22,7 +22,7 @@ namespace aZero
 				SamplerDesc.MaxAnisotropy = 8;
 				SamplerDesc.ComparisonFunc = D3D12_COMPARISON_FUNC_NONE;
 				SamplerDesc.MinLOD = 0;
-				SamplerDesc.MaxLOD = 6;
+				SamplerDesc.MaxLOD = D3D12_FLOAT32_MAX;
 				m_Descriptors.emplace_back(heap.CreateDescriptor());
 				device->CreateSampler(&SamplerDesc, m_Descriptors.at(m_Descriptors.size() - 1).GetCpuHandle());
 			}
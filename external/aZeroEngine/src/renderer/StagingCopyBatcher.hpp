@@ -0,0 +1,253 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <cstring>
+#include <cstdint>
+
+namespace aZero
+{
+	namespace Rendering
+	{
+		/** @brief Receives the copies that a StagingCopyBatcher produces.
+		* Implemented by the renderer to record GPU buffer copies, and by tests and benchmarks to run the batching on the CPU only.
+		*/
+		template<typename DstType>
+		class CopyRecorder
+		{
+		public:
+			virtual ~CopyRecorder() = default;
+
+			/** Returns a pointer to numBytes of writable staging memory.
+			* The copies recorded until the next call read from this memory.
+			@param numBytes
+			@return uint8_t*
+			*/
+			virtual uint8_t* AllocateStaging(uint64_t numBytes) = 0;
+
+			/** Records a copy of numBytes from the latest staging memory to the destination
+			@param dst
+			@param dstOffset
+			@param stagingOffset Offset relative to the pointer returned by the latest AllocateStaging() call
+			@param numBytes
+			@return void
+			*/
+			virtual void RecordCopy(DstType dst, uint64_t dstOffset, uint64_t stagingOffset, uint64_t numBytes) = 0;
+		};
+
+		/** @brief Collects CPU-side writes to destinations and turns them into as few copies as possible.
+		* Writes are copied into growable CPU chunks when added, so any amount of data can be queued.
+		* When recorded, the writes are sorted by destination and offset, and adjacent or overlapping writes are merged into one copy.
+		* The merged regions are packed into a single staging allocation, and overlapping bytes keep the value of the latest write.
+		*/
+		template<typename DstType>
+		class StagingCopyBatcher
+		{
+		public:
+			struct RecordStats
+			{
+				uint32_t NumWrites = 0;
+				uint32_t NumCopies = 0;
+				uint64_t NumBytesWritten = 0;
+				uint64_t NumBytesCopied = 0;
+			};
+
+			// Start of each merged copy in the staging memory
+			static constexpr uint64_t StagingAlignment = 16;
+
+		private:
+			struct PendingWrite
+			{
+				DstType Dst;
+				uint64_t DstOffset;
+				uint64_t NumBytes;
+				const uint8_t* Data;
+				uint32_t Order;
+			};
+
+			struct Chunk
+			{
+				std::unique_ptr<uint8_t[]> Data;
+				uint64_t Size = 0;
+				uint64_t Used = 0;
+			};
+
+			struct MergedCopy
+			{
+				DstType Dst;
+				uint64_t DstOffset;
+				uint64_t NumBytes;
+				uint64_t StagingOffset;
+				size_t FirstWrite;
+				size_t EndWrite;
+				bool HasOverlap;
+			};
+
+			uint64_t m_ChunkSize = 1024 * 1024;
+			std::vector<Chunk> m_Chunks;
+			size_t m_CurrentChunk = 0;
+
+			std::vector<PendingWrite> m_PendingWrites;
+			std::vector<MergedCopy> m_MergedCopies;
+
+			uint8_t* AllocateCPU(uint64_t numBytes)
+			{
+				while (m_CurrentChunk < m_Chunks.size())
+				{
+					Chunk& chunk = m_Chunks[m_CurrentChunk];
+					if (chunk.Used + numBytes <= chunk.Size)
+					{
+						uint8_t* data = chunk.Data.get() + chunk.Used;
+						chunk.Used += numBytes;
+						return data;
+					}
+					m_CurrentChunk++;
+				}
+
+				// Writes larger than a chunk get a dedicated chunk that is released on Reset()
+				Chunk& chunk = m_Chunks.emplace_back();
+				chunk.Size = std::max(m_ChunkSize, numBytes);
+				chunk.Data = std::make_unique_for_overwrite<uint8_t[]>(chunk.Size);
+				chunk.Used = numBytes;
+				m_CurrentChunk = m_Chunks.size() - 1;
+				return chunk.Data.get();
+			}
+
+		public:
+			StagingCopyBatcher() = default;
+
+			StagingCopyBatcher(uint64_t chunkSize)
+				:m_ChunkSize(std::max(chunkSize, uint64_t(1))) { }
+
+			/** Queues a write of numBytes from data to the destination at dstOffset. The data is copied so it doesn't have to outlive the call.
+			@param data
+			@param dst
+			@param dstOffset
+			@param numBytes
+			@return void
+			*/
+			void Add(const void* data, DstType dst, uint64_t dstOffset, uint64_t numBytes)
+			{
+				if (numBytes == 0)
+				{
+					return;
+				}
+
+				uint8_t* cpuData = this->AllocateCPU(numBytes);
+				memcpy(cpuData, data, numBytes);
+				m_PendingWrites.push_back({ dst, dstOffset, numBytes, cpuData, static_cast<uint32_t>(m_PendingWrites.size()) });
+			}
+
+			/** Merges the queued writes and passes them to the recorder. Clears the queued writes.
+			@param recorder
+			@return RecordStats
+			*/
+			RecordStats Record(CopyRecorder<DstType>& recorder)
+			{
+				RecordStats stats;
+				stats.NumWrites = static_cast<uint32_t>(m_PendingWrites.size());
+				if (m_PendingWrites.empty())
+				{
+					return stats;
+				}
+
+				std::sort(m_PendingWrites.begin(), m_PendingWrites.end(), [](const PendingWrite& a, const PendingWrite& b) {
+					if (a.Dst != b.Dst)
+					{
+						return std::less<DstType>()(a.Dst, b.Dst);
+					}
+					return a.DstOffset != b.DstOffset ? a.DstOffset < b.DstOffset : a.Order < b.Order;
+					});
+
+				// Sweep the sorted writes and merge every write that starts before or at the end of the current copy
+				m_MergedCopies.clear();
+				uint64_t stagingSize = 0;
+				for (size_t writeIndex = 0; writeIndex < m_PendingWrites.size(); writeIndex++)
+				{
+					const PendingWrite& write = m_PendingWrites[writeIndex];
+					stats.NumBytesWritten += write.NumBytes;
+
+					if (!m_MergedCopies.empty())
+					{
+						MergedCopy& current = m_MergedCopies.back();
+						const uint64_t currentEnd = current.DstOffset + current.NumBytes;
+						if (current.Dst == write.Dst && write.DstOffset <= currentEnd)
+						{
+							current.HasOverlap |= write.DstOffset < currentEnd;
+							current.NumBytes = std::max(currentEnd, write.DstOffset + write.NumBytes) - current.DstOffset;
+							current.EndWrite = writeIndex + 1;
+							continue;
+						}
+
+						stagingSize = (current.StagingOffset + current.NumBytes + StagingAlignment - 1) & ~(StagingAlignment - 1);
+					}
+
+					m_MergedCopies.push_back({ write.Dst, write.DstOffset, write.NumBytes, stagingSize, writeIndex, writeIndex + 1, false });
+				}
+				stagingSize = m_MergedCopies.back().StagingOffset + m_MergedCopies.back().NumBytes;
+
+				uint8_t* staging = recorder.AllocateStaging(stagingSize);
+				for (const MergedCopy& copy : m_MergedCopies)
+				{
+					// Apply overlapping writes in the order they were added so the latest one wins
+					if (copy.HasOverlap)
+					{
+						std::sort(m_PendingWrites.begin() + copy.FirstWrite, m_PendingWrites.begin() + copy.EndWrite,
+							[](const PendingWrite& a, const PendingWrite& b) { return a.Order < b.Order; });
+					}
+
+					for (size_t writeIndex = copy.FirstWrite; writeIndex < copy.EndWrite; writeIndex++)
+					{
+						const PendingWrite& write = m_PendingWrites[writeIndex];
+						memcpy(staging + copy.StagingOffset + (write.DstOffset - copy.DstOffset), write.Data, write.NumBytes);
+					}
+
+					recorder.RecordCopy(copy.Dst, copy.DstOffset, copy.StagingOffset, copy.NumBytes);
+					stats.NumBytesCopied += copy.NumBytes;
+				}
+				stats.NumCopies = static_cast<uint32_t>(m_MergedCopies.size());
+
+				m_PendingWrites.clear();
+				return stats;
+			}
+
+			/** Drops the queued writes without recording them
+			@return void
+			*/
+			void ClearQueued()
+			{
+				m_PendingWrites.clear();
+			}
+
+			/** Drops the queued writes and rewinds the CPU chunks. Chunks that were allocated for oversized writes are released.
+			@return void
+			*/
+			void Reset()
+			{
+				m_PendingWrites.clear();
+				std::erase_if(m_Chunks, [this](const Chunk& chunk) { return chunk.Size > m_ChunkSize; });
+				for (Chunk& chunk : m_Chunks)
+				{
+					chunk.Used = 0;
+				}
+				m_CurrentChunk = 0;
+			}
+
+			size_t GetNumQueued() const { return m_PendingWrites.size(); }
+
+			/** Returns the number of bytes allocated by the CPU chunks
+			@return uint64_t
+			*/
+			uint64_t GetCPUMemoryUsage() const
+			{
+				uint64_t numBytes = 0;
+				for (const Chunk& chunk : m_Chunks)
+				{
+					numBytes += chunk.Size;
+				}
+				return numBytes;
+			}
+		};
+	}
+}
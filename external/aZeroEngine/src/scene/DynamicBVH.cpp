@@ -0,0 +1,535 @@
+#include "DynamicBVH.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+	float SurfaceArea(const float min[3], const float max[3])
+	{
+		const float dx = max[0] - min[0];
+		const float dy = max[1] - min[1];
+		const float dz = max[2] - min[2];
+		return 2.f * (dx * dy + dy * dz + dz * dx);
+	}
+
+	float UnionSurfaceArea(const float minA[3], const float maxA[3], const float minB[3], const float maxB[3])
+	{
+		float min[3];
+		float max[3];
+		for (int axis = 0; axis < 3; axis++)
+		{
+			min[axis] = std::min(minA[axis], minB[axis]);
+			max[axis] = std::max(maxA[axis], maxB[axis]);
+		}
+		return SurfaceArea(min, max);
+	}
+}
+
+namespace aZero
+{
+	namespace Scene
+	{
+		int32_t DynamicBVH::AllocateNode()
+		{
+			if (m_FreeList == NullNode)
+			{
+				m_Nodes.emplace_back();
+				return static_cast<int32_t>(m_Nodes.size() - 1);
+			}
+
+			const int32_t node = m_FreeList;
+			m_FreeList = m_Nodes[node].Parent;
+			m_Nodes[node] = Node();
+			return node;
+		}
+
+		void DynamicBVH::FreeNode(int32_t node)
+		{
+			m_Nodes[node].Parent = m_FreeList;
+			m_Nodes[node].Height = -1;
+			m_FreeList = node;
+		}
+
+		void DynamicBVH::SetFatBox(Node& node, const float sphere[4]) const
+		{
+			const float fatRadius = sphere[3] * (1.f + m_FatMarginScale);
+			for (int axis = 0; axis < 3; axis++)
+			{
+				node.Min[axis] = sphere[axis] - fatRadius;
+				node.Max[axis] = sphere[axis] + fatRadius;
+			}
+		}
+
+		void DynamicBVH::SetUnion(Node& node, const Node& a, const Node& b) const
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				node.Min[axis] = std::min(a.Min[axis], b.Min[axis]);
+				node.Max[axis] = std::max(a.Max[axis], b.Max[axis]);
+			}
+		}
+
+		void DynamicBVH::Insert(uint32_t userID, const float sphere[4])
+		{
+			if (m_UserToLeaf.Contains(userID))
+			{
+				throw std::invalid_argument("DynamicBVH::Insert() => User ID already has a leaf");
+			}
+
+			const int32_t leaf = this->AllocateNode();
+			Node& node = m_Nodes[leaf];
+			std::copy(sphere, sphere + 4, node.Sphere);
+			this->SetFatBox(node, sphere);
+			node.Height = 0;
+			node.UserID = userID;
+
+			this->InsertLeaf(leaf);
+			m_UserToLeaf.Set(userID, static_cast<uint32_t>(leaf));
+			m_NumLeaves++;
+			m_NumChangesSinceRebuild++;
+		}
+
+		void DynamicBVH::Remove(uint32_t userID)
+		{
+			const uint32_t leaf = m_UserToLeaf.Get(userID);
+			if (leaf == DS::PagedSparseIndex<uint32_t>::InvalidIndex)
+			{
+				return;
+			}
+
+			this->RemoveLeaf(static_cast<int32_t>(leaf));
+			this->FreeNode(static_cast<int32_t>(leaf));
+			m_UserToLeaf.Reset(userID, true);
+			m_NumLeaves--;
+			m_NumChangesSinceRebuild++;
+		}
+
+		bool DynamicBVH::Update(uint32_t userID, const float sphere[4])
+		{
+			const uint32_t leafIndex = m_UserToLeaf.Get(userID);
+			if (leafIndex == DS::PagedSparseIndex<uint32_t>::InvalidIndex)
+			{
+				throw std::invalid_argument("DynamicBVH::Update() => User ID has no leaf");
+			}
+
+			const int32_t leaf = static_cast<int32_t>(leafIndex);
+			Node& node = m_Nodes[leaf];
+			std::copy(sphere, sphere + 4, node.Sphere);
+
+			bool contained = true;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				contained &= node.Min[axis] <= sphere[axis] - sphere[3] && sphere[axis] + sphere[3] <= node.Max[axis];
+			}
+
+			if (contained)
+			{
+				return false;
+			}
+
+			this->RemoveLeaf(leaf);
+			this->SetFatBox(m_Nodes[leaf], sphere);
+			this->InsertLeaf(leaf);
+			m_NumChangesSinceRebuild++;
+			return true;
+		}
+
+		void DynamicBVH::Clear()
+		{
+			m_Nodes.clear();
+			m_UserToLeaf.Clear();
+			m_Root = NullNode;
+			m_FreeList = NullNode;
+			m_NumLeaves = 0;
+			m_NumChangesSinceRebuild = 0;
+		}
+
+		void DynamicBVH::Rebuild()
+		{
+			std::vector<Node> leaves;
+			leaves.reserve(m_NumLeaves);
+			for (const Node& node : m_Nodes)
+			{
+				if (node.Height == 0)
+				{
+					leaves.push_back(node);
+				}
+			}
+
+			m_Nodes.clear();
+			m_Nodes.reserve(leaves.empty() ? 0 : leaves.size() * 2 - 1);
+			m_FreeList = NullNode;
+			m_Root = leaves.empty() ? NullNode : this->BuildTopDown(leaves, 0, leaves.size(), NullNode);
+			m_NumChangesSinceRebuild = 0;
+		}
+
+		bool DynamicBVH::ShouldRebuild() const
+		{
+			return m_NumChangesSinceRebuild > std::max(m_NumLeaves / 4, 64u);
+		}
+
+		int32_t DynamicBVH::BuildTopDown(std::vector<Node>& leaves, size_t first, size_t end, int32_t parent)
+		{
+			const int32_t index = static_cast<int32_t>(m_Nodes.size());
+			if (end - first == 1)
+			{
+				Node& leaf = m_Nodes.emplace_back(leaves[first]);
+				leaf.Parent = parent;
+				m_UserToLeaf.Set(leaf.UserID, static_cast<uint32_t>(index));
+				return index;
+			}
+
+			// Split at the median along the axis where the leaf centers are spread the most
+			float centerMin[3] = { leaves[first].Sphere[0], leaves[first].Sphere[1], leaves[first].Sphere[2] };
+			float centerMax[3] = { centerMin[0], centerMin[1], centerMin[2] };
+			for (size_t leafIndex = first + 1; leafIndex < end; leafIndex++)
+			{
+				for (int axis = 0; axis < 3; axis++)
+				{
+					centerMin[axis] = std::min(centerMin[axis], leaves[leafIndex].Sphere[axis]);
+					centerMax[axis] = std::max(centerMax[axis], leaves[leafIndex].Sphere[axis]);
+				}
+			}
+
+			int splitAxis = 0;
+			for (int axis = 1; axis < 3; axis++)
+			{
+				if (centerMax[axis] - centerMin[axis] > centerMax[splitAxis] - centerMin[splitAxis])
+				{
+					splitAxis = axis;
+				}
+			}
+
+			const size_t middle = first + (end - first) / 2;
+			std::nth_element(leaves.begin() + first, leaves.begin() + middle, leaves.begin() + end,
+				[splitAxis](const Node& a, const Node& b) { return a.Sphere[splitAxis] < b.Sphere[splitAxis]; });
+
+			// The node is added before its children so that the first child directly follows it
+			m_Nodes.emplace_back().Parent = parent;
+			const int32_t child1 = this->BuildTopDown(leaves, first, middle, index);
+			const int32_t child2 = this->BuildTopDown(leaves, middle, end, index);
+
+			Node& node = m_Nodes[index];
+			node.Child1 = child1;
+			node.Child2 = child2;
+			node.Height = 1 + std::max(m_Nodes[child1].Height, m_Nodes[child2].Height);
+			this->SetUnion(node, m_Nodes[child1], m_Nodes[child2]);
+			return index;
+		}
+
+		void DynamicBVH::InsertLeaf(int32_t leaf)
+		{
+			if (m_Root == NullNode)
+			{
+				m_Root = leaf;
+				m_Nodes[leaf].Parent = NullNode;
+				return;
+			}
+
+			// Descend towards the sibling with the lowest surface area cost.
+			// Every node on the way down has its area increased by the leaf, which is the inherited cost.
+			const Node& leafNode = m_Nodes[leaf];
+			int32_t index = m_Root;
+			while (!m_Nodes[index].IsLeaf())
+			{
+				const Node& node = m_Nodes[index];
+				const float area = SurfaceArea(node.Min, node.Max);
+				const float combinedArea = UnionSurfaceArea(node.Min, node.Max, leafNode.Min, leafNode.Max);
+
+				// Cost of making a new parent for this node and the leaf
+				const float cost = 2.f * combinedArea;
+				const float inheritanceCost = 2.f * (combinedArea - area);
+
+				auto childCost = [&](int32_t childIndex) {
+					const Node& child = m_Nodes[childIndex];
+					const float unionArea = UnionSurfaceArea(child.Min, child.Max, leafNode.Min, leafNode.Max);
+					return child.IsLeaf() ? unionArea + inheritanceCost : unionArea - SurfaceArea(child.Min, child.Max) + inheritanceCost;
+					};
+
+				const float cost1 = childCost(node.Child1);
+				const float cost2 = childCost(node.Child2);
+				if (cost < cost1 && cost < cost2)
+				{
+					break;
+				}
+
+				index = cost1 < cost2 ? node.Child1 : node.Child2;
+			}
+
+			const int32_t sibling = index;
+			const int32_t oldParent = m_Nodes[sibling].Parent;
+			const int32_t newParent = this->AllocateNode();
+			{
+				Node& parent = m_Nodes[newParent];
+				parent.Parent = oldParent;
+				parent.Child1 = sibling;
+				parent.Child2 = leaf;
+				parent.Height = m_Nodes[sibling].Height + 1;
+				this->SetUnion(parent, m_Nodes[sibling], m_Nodes[leaf]);
+			}
+
+			if (oldParent != NullNode)
+			{
+				Node& grandParent = m_Nodes[oldParent];
+				(grandParent.Child1 == sibling ? grandParent.Child1 : grandParent.Child2) = newParent;
+			}
+			else
+			{
+				m_Root = newParent;
+			}
+			m_Nodes[sibling].Parent = newParent;
+			m_Nodes[leaf].Parent = newParent;
+
+			// Refit and rebalance the ancestors
+			index = m_Nodes[leaf].Parent;
+			while (index != NullNode)
+			{
+				index = this->Balance(index);
+				Node& node = m_Nodes[index];
+				node.Height = 1 + std::max(m_Nodes[node.Child1].Height, m_Nodes[node.Child2].Height);
+				this->SetUnion(node, m_Nodes[node.Child1], m_Nodes[node.Child2]);
+				index = node.Parent;
+			}
+		}
+
+		void DynamicBVH::RemoveLeaf(int32_t leaf)
+		{
+			if (leaf == m_Root)
+			{
+				m_Root = NullNode;
+				return;
+			}
+
+			const int32_t parent = m_Nodes[leaf].Parent;
+			const int32_t grandParent = m_Nodes[parent].Parent;
+			const int32_t sibling = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+			// The sibling takes the place of the parent
+			if (grandParent != NullNode)
+			{
+				Node& grandParentNode = m_Nodes[grandParent];
+				(grandParentNode.Child1 == parent ? grandParentNode.Child1 : grandParentNode.Child2) = sibling;
+				m_Nodes[sibling].Parent = grandParent;
+				this->FreeNode(parent);
+
+				int32_t index = grandParent;
+				while (index != NullNode)
+				{
+					index = this->Balance(index);
+					Node& node = m_Nodes[index];
+					node.Height = 1 + std::max(m_Nodes[node.Child1].Height, m_Nodes[node.Child2].Height);
+					this->SetUnion(node, m_Nodes[node.Child1], m_Nodes[node.Child2]);
+					index = node.Parent;
+				}
+			}
+			else
+			{
+				m_Root = sibling;
+				m_Nodes[sibling].Parent = NullNode;
+				this->FreeNode(parent);
+			}
+		}
+
+		int32_t DynamicBVH::Balance(int32_t iA)
+		{
+			// Rotates the taller child of A up if the heights of A's children differ by more than one
+			Node& A = m_Nodes[iA];
+			if (A.IsLeaf() || A.Height < 2)
+			{
+				return iA;
+			}
+
+			const int32_t iB = A.Child1;
+			const int32_t iC = A.Child2;
+			Node& B = m_Nodes[iB];
+			Node& C = m_Nodes[iC];
+			const int32_t balance = C.Height - B.Height;
+
+			// Rotate C up
+			if (balance > 1)
+			{
+				const int32_t iF = C.Child1;
+				const int32_t iG = C.Child2;
+				Node& F = m_Nodes[iF];
+				Node& G = m_Nodes[iG];
+
+				C.Child1 = iA;
+				C.Parent = A.Parent;
+				A.Parent = iC;
+
+				if (C.Parent != NullNode)
+				{
+					Node& parent = m_Nodes[C.Parent];
+					(parent.Child1 == iA ? parent.Child1 : parent.Child2) = iC;
+				}
+				else
+				{
+					m_Root = iC;
+				}
+
+				if (F.Height > G.Height)
+				{
+					C.Child2 = iF;
+					A.Child2 = iG;
+					G.Parent = iA;
+					this->SetUnion(A, B, G);
+					this->SetUnion(C, A, F);
+					A.Height = 1 + std::max(B.Height, G.Height);
+					C.Height = 1 + std::max(A.Height, F.Height);
+				}
+				else
+				{
+					C.Child2 = iG;
+					A.Child2 = iF;
+					F.Parent = iA;
+					this->SetUnion(A, B, F);
+					this->SetUnion(C, A, G);
+					A.Height = 1 + std::max(B.Height, F.Height);
+					C.Height = 1 + std::max(A.Height, G.Height);
+				}
+
+				return iC;
+			}
+
+			// Rotate B up
+			if (balance < -1)
+			{
+				const int32_t iD = B.Child1;
+				const int32_t iE = B.Child2;
+				Node& D = m_Nodes[iD];
+				Node& E = m_Nodes[iE];
+
+				B.Child1 = iA;
+				B.Parent = A.Parent;
+				A.Parent = iB;
+
+				if (B.Parent != NullNode)
+				{
+					Node& parent = m_Nodes[B.Parent];
+					(parent.Child1 == iA ? parent.Child1 : parent.Child2) = iB;
+				}
+				else
+				{
+					m_Root = iB;
+				}
+
+				if (D.Height > E.Height)
+				{
+					B.Child2 = iD;
+					A.Child1 = iE;
+					E.Parent = iA;
+					this->SetUnion(A, C, E);
+					this->SetUnion(B, A, D);
+					A.Height = 1 + std::max(C.Height, E.Height);
+					B.Height = 1 + std::max(A.Height, D.Height);
+				}
+				else
+				{
+					B.Child2 = iE;
+					A.Child1 = iD;
+					D.Parent = iA;
+					this->SetUnion(A, C, D);
+					this->SetUnion(B, A, E);
+					A.Height = 1 + std::max(C.Height, D.Height);
+					B.Height = 1 + std::max(A.Height, E.Height);
+				}
+
+				return iB;
+			}
+
+			return iA;
+		}
+
+		void DynamicBVH::Cull(const Culling::FrustumPlanes& planes, std::vector<uint32_t>& visibleUserIDs) const
+		{
+			if (m_Root == NullNode)
+			{
+				return;
+			}
+
+			// Leaves that intersect the frustum are gathered and tested four at a time
+			alignas(16) float batchX[4] = {};
+			alignas(16) float batchY[4] = {};
+			alignas(16) float batchZ[4] = {};
+			alignas(16) float batchRadius[4] = {};
+			uint32_t batchIDs[4];
+			uint32_t batchSize = 0;
+
+			auto flushBatch = [&]() {
+				const uint32_t visibleMask = planes.TestSpheres4(batchX, batchY, batchZ, batchRadius);
+				for (uint32_t lane = 0; lane < batchSize; lane++)
+				{
+					if (visibleMask & (1u << lane))
+					{
+						visibleUserIDs.push_back(batchIDs[lane]);
+					}
+				}
+				batchSize = 0;
+				};
+
+			std::vector<int32_t> stack;
+			stack.reserve(64);
+			std::vector<int32_t> insideStack;
+			stack.push_back(m_Root);
+			while (!stack.empty())
+			{
+				const int32_t index = stack.back();
+				stack.pop_back();
+				const Node& node = m_Nodes[index];
+
+				// Leaves skip the box test since the exact sphere is tested in the batch
+				if (node.IsLeaf())
+				{
+					batchX[batchSize] = node.Sphere[0];
+					batchY[batchSize] = node.Sphere[1];
+					batchZ[batchSize] = node.Sphere[2];
+					batchRadius[batchSize] = node.Sphere[3];
+					batchIDs[batchSize] = node.UserID;
+					if (++batchSize == 4)
+					{
+						flushBatch();
+					}
+					continue;
+				}
+
+				const float center[3] = { (node.Min[0] + node.Max[0]) * 0.5f, (node.Min[1] + node.Max[1]) * 0.5f, (node.Min[2] + node.Max[2]) * 0.5f };
+				const float extents[3] = { (node.Max[0] - node.Min[0]) * 0.5f, (node.Max[1] - node.Min[1]) * 0.5f, (node.Max[2] - node.Min[2]) * 0.5f };
+				const Culling::CullResult result = planes.TestBox(center, extents);
+				if (result == Culling::CullResult::Outside)
+				{
+					continue;
+				}
+
+				if (result == Culling::CullResult::Inside)
+				{
+					// Every leaf below is visible
+					insideStack.push_back(index);
+					while (!insideStack.empty())
+					{
+						const Node& insideNode = m_Nodes[insideStack.back()];
+						insideStack.pop_back();
+						if (insideNode.IsLeaf())
+						{
+							visibleUserIDs.push_back(insideNode.UserID);
+						}
+						else
+						{
+							insideStack.push_back(insideNode.Child1);
+							insideStack.push_back(insideNode.Child2);
+						}
+					}
+					continue;
+				}
+
+				stack.push_back(node.Child1);
+				stack.push_back(node.Child2);
+			}
+
+			if (batchSize > 0)
+			{
+				// Unused lanes are never reported
+				flushBatch();
+			}
+		}
+	}
+}
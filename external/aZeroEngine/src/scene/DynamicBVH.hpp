@@ -0,0 +1,117 @@
+#pragma once
+#include "FrustumCulling.hpp"
+#include "misc/PagedSparseIndex.hpp"
+
+namespace aZero
+{
+	namespace Scene
+	{
+		/** @brief Incrementally updated bounding volume hierarchy over bounding spheres, used for CPU frustum culling.
+		* Leaves store a box that is enlarged by a margin relative to the sphere radius. Moving an object only touches the tree when its sphere leaves that box,
+		* in which case the leaf is removed and reinserted at the position of lowest surface area cost. The tree is kept height balanced with rotations.
+		* Frustum queries skip subtrees that are fully outside, accept subtrees that are fully inside without further tests, and test the remaining leaf spheres four at a time.
+		* Leaves are addressed by user ID, so Rebuild() can reorder the nodes depth first for cache friendly traversal after large changes.
+		*/
+		class DynamicBVH
+		{
+		public:
+			static constexpr int32_t NullNode = -1;
+
+		private:
+			struct Node
+			{
+				float Min[3];
+				float Max[3];
+
+				// Exact sphere of a leaf, x y z radius
+				float Sphere[4];
+
+				// Next free node when the node is in the free list
+				int32_t Parent = NullNode;
+				int32_t Child1 = NullNode;
+				int32_t Child2 = NullNode;
+
+				// Leaf = 0, free node = -1
+				int32_t Height = -1;
+				uint32_t UserID = 0;
+
+				bool IsLeaf() const { return Child1 == NullNode; }
+			};
+
+			std::vector<Node> m_Nodes;
+			int32_t m_Root = NullNode;
+			int32_t m_FreeList = NullNode;
+			uint32_t m_NumLeaves = 0;
+			uint32_t m_NumChangesSinceRebuild = 0;
+			float m_FatMarginScale = 0.1f;
+
+			DS::PagedSparseIndex<uint32_t> m_UserToLeaf;
+
+			int32_t AllocateNode();
+			void FreeNode(int32_t node);
+
+			void InsertLeaf(int32_t leaf);
+			void RemoveLeaf(int32_t leaf);
+			int32_t Balance(int32_t node);
+			int32_t BuildTopDown(std::vector<Node>& leaves, size_t first, size_t end, int32_t parent);
+
+			void SetFatBox(Node& node, const float sphere[4]) const;
+			void SetUnion(Node& node, const Node& a, const Node& b) const;
+
+		public:
+			DynamicBVH() = default;
+
+			/** @param fatMarginScale Margin that leaf boxes are enlarged by, relative to the sphere radius */
+			DynamicBVH(float fatMarginScale)
+				:m_FatMarginScale(fatMarginScale) { }
+
+			/** Inserts a sphere for the user ID
+			@param userID Value that is returned by Cull() when the sphere is visible
+			@param sphere x, y, z, radius
+			@return void
+			*/
+			void Insert(uint32_t userID, const float sphere[4]);
+
+			/** Removes the sphere of the user ID if there is one
+			@param userID
+			@return void
+			*/
+			void Remove(uint32_t userID);
+
+			/** Updates the sphere of the user ID. The tree is only modified if the sphere has moved outside the enlarged leaf box.
+			@param userID
+			@param sphere x, y, z, radius
+			@return bool True if the leaf was reinserted
+			*/
+			bool Update(uint32_t userID, const float sphere[4]);
+
+			bool Contains(uint32_t userID) const { return m_UserToLeaf.Contains(userID); }
+
+			/** Rebuilds the tree top-down with median splits and stores the nodes in depth first order.
+			* Incremental insertion produces trees with scattered nodes, which makes traversal bound by cache misses.
+			@return void
+			*/
+			void Rebuild();
+
+			/** Returns true once enough leaves have been inserted, moved or removed since the last rebuild that the scattered nodes outweigh the cost of Rebuild().
+			* Incremental changes keep the tree balanced, so this only tracks the memory layout.
+			@return bool
+			*/
+			bool ShouldRebuild() const;
+
+			/** Appends the user IDs of all leaves whose sphere intersects the frustum
+			@param planes
+			@param visibleUserIDs
+			@return void
+			*/
+			void Cull(const Culling::FrustumPlanes& planes, std::vector<uint32_t>& visibleUserIDs) const;
+
+			void Clear();
+
+			uint32_t GetNumLeaves() const { return m_NumLeaves; }
+			int32_t GetHeight() const { return m_Root == NullNode ? 0 : m_Nodes[m_Root].Height; }
+			uint32_t GetNumChangesSinceRebuild() const { return m_NumChangesSinceRebuild; }
+			size_t GetMemoryUsage() const { return m_Nodes.capacity() * sizeof(Node) + m_UserToLeaf.GetMemoryUsage(); }
+		};
+	}
+}
@@ -0,0 +1,183 @@
+#include "FrustumCulling.hpp"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define AZERO_CULLING_SSE 1
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+	uint32_t CountTrailingZeros(uint32_t mask)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return index;
+#else
+		return __builtin_ctz(mask);
+#endif
+	}
+}
+
+namespace aZero
+{
+	namespace Scene
+	{
+		namespace Culling
+		{
+			FrustumPlanes::FrustumPlanes(const float planes[NumPlanes][4])
+			{
+				for (uint32_t planeIndex = 0; planeIndex < NumPaddedPlanes; planeIndex++)
+				{
+					const float* plane = planes[std::min(planeIndex, NumPlanes - 1)];
+					X[planeIndex] = plane[0];
+					Y[planeIndex] = plane[1];
+					Z[planeIndex] = plane[2];
+					W[planeIndex] = plane[3];
+					AbsX[planeIndex] = std::abs(plane[0]);
+					AbsY[planeIndex] = std::abs(plane[1]);
+					AbsZ[planeIndex] = std::abs(plane[2]);
+				}
+			}
+
+#ifdef AZERO_CULLING_SSE
+			CullResult FrustumPlanes::TestBox(const float center[3], const float extents[3]) const
+			{
+				const __m128 centerX = _mm_set1_ps(center[0]);
+				const __m128 centerY = _mm_set1_ps(center[1]);
+				const __m128 centerZ = _mm_set1_ps(center[2]);
+				const __m128 extentX = _mm_set1_ps(extents[0]);
+				const __m128 extentY = _mm_set1_ps(extents[1]);
+				const __m128 extentZ = _mm_set1_ps(extents[2]);
+
+				int outsideMask = 0;
+				int insideMask = 0;
+				for (uint32_t batch = 0; batch < NumPaddedPlanes; batch += 4)
+				{
+					// Signed distance of the center and the projected radius of the box for 4 planes at a time
+					const __m128 distance = _mm_add_ps(
+						_mm_add_ps(_mm_mul_ps(_mm_load_ps(X + batch), centerX), _mm_mul_ps(_mm_load_ps(Y + batch), centerY)),
+						_mm_add_ps(_mm_mul_ps(_mm_load_ps(Z + batch), centerZ), _mm_load_ps(W + batch)));
+					const __m128 radius = _mm_add_ps(
+						_mm_add_ps(_mm_mul_ps(_mm_load_ps(AbsX + batch), extentX), _mm_mul_ps(_mm_load_ps(AbsY + batch), extentY)),
+						_mm_mul_ps(_mm_load_ps(AbsZ + batch), extentZ));
+
+					outsideMask |= _mm_movemask_ps(_mm_cmpgt_ps(distance, radius));
+					insideMask |= _mm_movemask_ps(_mm_cmpgt_ps(distance, _mm_sub_ps(_mm_setzero_ps(), radius)));
+				}
+
+				if (outsideMask)
+				{
+					return CullResult::Outside;
+				}
+
+				return insideMask ? CullResult::Intersects : CullResult::Inside;
+			}
+
+			uint32_t FrustumPlanes::TestSpheres4(const float* x, const float* y, const float* z, const float* radius) const
+			{
+				const __m128 sphereX = _mm_loadu_ps(x);
+				const __m128 sphereY = _mm_loadu_ps(y);
+				const __m128 sphereZ = _mm_loadu_ps(z);
+				const __m128 sphereRadius = _mm_loadu_ps(radius);
+
+				// Spheres in lanes, one plane at a time
+				__m128 outside = _mm_setzero_ps();
+				for (uint32_t planeIndex = 0; planeIndex < NumPlanes; planeIndex++)
+				{
+					const __m128 distance = _mm_add_ps(
+						_mm_add_ps(_mm_mul_ps(_mm_set1_ps(X[planeIndex]), sphereX), _mm_mul_ps(_mm_set1_ps(Y[planeIndex]), sphereY)),
+						_mm_add_ps(_mm_mul_ps(_mm_set1_ps(Z[planeIndex]), sphereZ), _mm_set1_ps(W[planeIndex])));
+					outside = _mm_or_ps(outside, _mm_cmpgt_ps(distance, sphereRadius));
+				}
+
+				return static_cast<uint32_t>(~_mm_movemask_ps(outside)) & 0xF;
+			}
+#else
+			CullResult FrustumPlanes::TestBox(const float center[3], const float extents[3]) const
+			{
+				bool intersects = false;
+				for (uint32_t planeIndex = 0; planeIndex < NumPlanes; planeIndex++)
+				{
+					const float distance = X[planeIndex] * center[0] + Y[planeIndex] * center[1] + Z[planeIndex] * center[2] + W[planeIndex];
+					const float radius = AbsX[planeIndex] * extents[0] + AbsY[planeIndex] * extents[1] + AbsZ[planeIndex] * extents[2];
+					if (distance > radius)
+					{
+						return CullResult::Outside;
+					}
+					intersects |= distance > -radius;
+				}
+
+				return intersects ? CullResult::Intersects : CullResult::Inside;
+			}
+
+			uint32_t FrustumPlanes::TestSpheres4(const float* x, const float* y, const float* z, const float* radius) const
+			{
+				uint32_t visibleMask = 0;
+				for (uint32_t lane = 0; lane < 4; lane++)
+				{
+					const float sphere[4] = { x[lane], y[lane], z[lane], radius[lane] };
+					visibleMask |= this->TestSphere(sphere) ? 1u << lane : 0u;
+				}
+				return visibleMask;
+			}
+#endif
+
+			bool FrustumPlanes::TestSphere(const float sphere[4]) const
+			{
+				for (uint32_t planeIndex = 0; planeIndex < NumPlanes; planeIndex++)
+				{
+					const float distance = X[planeIndex] * sphere[0] + Y[planeIndex] * sphere[1] + Z[planeIndex] * sphere[2] + W[planeIndex];
+					if (distance > sphere[3])
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+
+			void SphereArray::Resize(uint32_t numSpheres)
+			{
+				// Padding spheres have a radius of -inf so they never pass the plane tests
+				const size_t paddedSize = (static_cast<size_t>(numSpheres) + 3) & ~size_t(3);
+				m_X.resize(paddedSize, 0.f);
+				m_Y.resize(paddedSize, 0.f);
+				m_Z.resize(paddedSize, 0.f);
+				m_Radius.resize(paddedSize, -std::numeric_limits<float>::infinity());
+				for (size_t index = numSpheres; index < paddedSize; index++)
+				{
+					m_Radius[index] = -std::numeric_limits<float>::infinity();
+				}
+				m_NumSpheres = numSpheres;
+			}
+
+			void SphereArray::Set(uint32_t index, const float sphere[4])
+			{
+				m_X[index] = sphere[0];
+				m_Y[index] = sphere[1];
+				m_Z[index] = sphere[2];
+				m_Radius[index] = sphere[3];
+			}
+
+			void SphereArray::Cull(const FrustumPlanes& planes, std::vector<uint32_t>& visibleIndices) const
+			{
+				for (uint32_t first = 0; first < m_NumSpheres; first += 4)
+				{
+					uint32_t visibleMask = planes.TestSpheres4(&m_X[first], &m_Y[first], &m_Z[first], &m_Radius[first]);
+					while (visibleMask)
+					{
+						visibleIndices.push_back(first + CountTrailingZeros(visibleMask));
+						visibleMask &= visibleMask - 1;
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace aZero
+{
+	namespace Scene
+	{
+		namespace Culling
+		{
+			enum class CullResult
+			{
+				Outside,
+				Intersects,
+				Inside
+			};
+
+			/** @brief The six planes of a world space frustum in SoA form for SIMD tests.
+			* Plane normals point out of the frustum, so a point is outside a plane if dot(normal, point) + w > 0.
+			* The planes are padded to 8 by repeating the last plane so that the tests always run over two full 4-wide batches.
+			*/
+			struct FrustumPlanes
+			{
+				static constexpr uint32_t NumPlanes = 6;
+				static constexpr uint32_t NumPaddedPlanes = 8;
+
+				alignas(16) float X[NumPaddedPlanes];
+				alignas(16) float Y[NumPaddedPlanes];
+				alignas(16) float Z[NumPaddedPlanes];
+				alignas(16) float W[NumPaddedPlanes];
+
+				// Absolute normal components used for the box extent projection
+				alignas(16) float AbsX[NumPaddedPlanes];
+				alignas(16) float AbsY[NumPaddedPlanes];
+				alignas(16) float AbsZ[NumPaddedPlanes];
+
+				FrustumPlanes() = default;
+
+				/** Creates the planes from six normalized (x, y, z, w) planes
+				@param planes
+				*/
+				FrustumPlanes(const float planes[NumPlanes][4]);
+
+				/** Tests the box given by its center and half extents against the planes
+				@param center
+				@param extents
+				@return CullResult
+				*/
+				CullResult TestBox(const float center[3], const float extents[3]) const;
+
+				/** Returns true if the sphere isn't fully outside any of the planes
+				@param sphere x, y, z, radius
+				@return bool
+				*/
+				bool TestSphere(const float sphere[4]) const;
+
+				/** Tests four spheres given in SoA form. Bit i of the result is set if sphere i is visible.
+				@param x
+				@param y
+				@param z
+				@param radius
+				@return uint32_t
+				*/
+				uint32_t TestSpheres4(const float* x, const float* y, const float* z, const float* radius) const;
+			};
+
+			/** @brief World space bounding spheres in SoA form, padded to a multiple of four with spheres that are always culled */
+			class SphereArray
+			{
+			private:
+				std::vector<float> m_X;
+				std::vector<float> m_Y;
+				std::vector<float> m_Z;
+				std::vector<float> m_Radius;
+				uint32_t m_NumSpheres = 0;
+
+			public:
+				SphereArray() = default;
+
+				void Resize(uint32_t numSpheres);
+				void Set(uint32_t index, const float sphere[4]);
+				uint32_t Size() const { return m_NumSpheres; }
+
+				/** Appends the indices of all spheres that intersect the frustum to visibleIndices
+				@param planes
+				@param visibleIndices
+				@return void
+				*/
+				void Cull(const FrustumPlanes& planes, std::vector<uint32_t>& visibleIndices) const;
+			};
+		}
+	}
+}
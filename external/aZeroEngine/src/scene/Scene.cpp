@@ -1,9 +1,74 @@
 #include "Scene.hpp"
+#include "misc/Profiler.hpp"
 
 namespace aZero
 {
 	namespace Scene
 	{
-		
+		void SceneNew::MarkRenderStateDirty(const ECS::Entity& entity, ComponentFlag flag)
+		{
+			PROFILE_SCOPE("SceneNew::MarkRenderStateDirty");
+			if (flag == ComponentFlag::None)
+			{
+				return;
+			}
+
+			const ECS::EntityID id = entity.GetID();
+			m_DirtyEntities.Add(id, ComponentUpdateInfo());
+			ComponentUpdateInfo& updateInfo = m_DirtyEntities.Get(id);
+			if (flag == ComponentFlag::All)
+			{
+				updateInfo.m_UpdateFlag.set();
+			}
+			else
+			{
+				updateInfo.m_UpdateFlag.set(static_cast<size_t>(flag));
+			}
+		}
+
+		void SceneNew::FlushRenderUpdates()
+		{
+			PROFILE_SCOPE("SceneNew::FlushRenderUpdates");
+			const std::span<const ECS::EntityID> dirtyIDs = m_DirtyEntities.GetIDs();
+			const std::vector<ComponentUpdateInfo>& dirtyInfos = m_DirtyEntities.GetData();
+
+			for (size_t index = 0; index < dirtyIDs.size(); index++)
+			{
+				const ECS::EntityID id = dirtyIDs[index];
+				const std::bitset<NumComponentFlags>& updateFlag = dirtyInfos[index].m_UpdateFlag;
+
+				// NOTE: Missing components are passed as nullptr which removes the entry from the proxy
+				// NOTE: When we have SkeletalMeshComp we will make this if-statement be one or the other
+				if (updateFlag.test(static_cast<size_t>(ComponentFlag::Transform)) || updateFlag.test(static_cast<size_t>(ComponentFlag::StaticMesh)))
+				{
+					m_Proxy->UpdateStaticMesh(id,
+						m_ComponentManager.GetComponentArray<ECS::TransformComponent>().GetComponent(id),
+						m_ComponentManager.GetComponentArray<ECS::StaticMeshComponent>().GetComponent(id));
+				}
+
+				if (updateFlag.test(static_cast<size_t>(ComponentFlag::PointLight)))
+				{
+					m_Proxy->UpdatePointLight(id, m_ComponentManager.GetComponentArray<ECS::PointLightComponent>().GetComponent(id));
+				}
+
+				if (updateFlag.test(static_cast<size_t>(ComponentFlag::SpotLight)))
+				{
+					m_Proxy->UpdateSpotLight(id, m_ComponentManager.GetComponentArray<ECS::SpotLightComponent>().GetComponent(id));
+				}
+
+				if (updateFlag.test(static_cast<size_t>(ComponentFlag::Camera)))
+				{
+					m_Proxy->UpdateCamera(id, m_ComponentManager.GetComponentArray<ECS::CameraComponent>().GetComponent(id));
+				}
+
+				if (updateFlag.test(static_cast<size_t>(ComponentFlag::DirectionalLight)))
+				{
+					m_Proxy->UpdateDirectionalLight(id, m_ComponentManager.GetComponentArray<ECS::DirectionalLightComponent>().GetComponent(id));
+				}
+			}
+
+			m_DirtyEntities.Clear();
+			m_Proxy->OptimizeCulling();
+		}
 	}
 }
\ No newline at end of file
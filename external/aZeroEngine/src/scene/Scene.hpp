@@ -24,6 +24,20 @@ namespace aZero
 				None = 1338
 			};
 
+			static constexpr size_t NumComponentFlags = 6;
+
+			template<typename ComponentType>
+			static constexpr ComponentFlag GetComponentFlag()
+			{
+				if constexpr (std::is_same_v<ComponentType, ECS::TransformComponent>) { return ComponentFlag::Transform; }
+				else if constexpr (std::is_same_v<ComponentType, ECS::StaticMeshComponent>) { return ComponentFlag::StaticMesh; }
+				else if constexpr (std::is_same_v<ComponentType, ECS::DirectionalLightComponent>) { return ComponentFlag::DirectionalLight; }
+				else if constexpr (std::is_same_v<ComponentType, ECS::PointLightComponent>) { return ComponentFlag::PointLight; }
+				else if constexpr (std::is_same_v<ComponentType, ECS::SpotLightComponent>) { return ComponentFlag::SpotLight; }
+				else if constexpr (std::is_same_v<ComponentType, ECS::CameraComponent>) { return ComponentFlag::Camera; }
+				else { return ComponentFlag::None; }
+			}
+
 			SceneProxy* GetProxy() const { return m_Proxy.get(); }
 
 			SceneNew()
@@ -35,6 +49,7 @@ namespace aZero
 				m_ComponentManager.GetComponentArray<ECS::SpotLightComponent>().Init(1000);
 				m_ComponentManager.GetComponentArray<ECS::DirectionalLightComponent>().Init(1000);
 				m_ComponentManager.GetComponentArray<ECS::CameraComponent>().Init(1000);
+				m_DirtyEntities.Init(1000);
 			}
 
 			ECS::Entity AddEntity()
@@ -52,57 +67,92 @@ namespace aZero
 				this->RemoveEntity(m_Entities.at(entity));
 			}
 
+			/** Removes the entity and all of its components.
+			* The render state of the entity is removed from the proxy on the next FlushRenderUpdates()
+			@param entity
+			@return void
+			*/
 			void RemoveEntity(const ECS::Entity& entity)
 			{
-
+				if (!m_EntityManager.IsValid(entity))
+				{
+					return;
+				}
+
+				ECS::Entity removedEntity = entity;
+				m_ComponentManager.RemoveComponent<ECS::TransformComponent>(removedEntity);
+				m_ComponentManager.RemoveComponent<ECS::StaticMeshComponent>(removedEntity);
+				m_ComponentManager.RemoveComponent<ECS::DirectionalLightComponent>(removedEntity);
+				m_ComponentManager.RemoveComponent<ECS::PointLightComponent>(removedEntity);
+				m_ComponentManager.RemoveComponent<ECS::SpotLightComponent>(removedEntity);
+				m_ComponentManager.RemoveComponent<ECS::CameraComponent>(removedEntity);
+				this->MarkRenderStateDirty(removedEntity, ComponentFlag::All);
+
+				if (auto name = m_Entity_To_Name.find(removedEntity.GetID()); name != m_Entity_To_Name.end())
+				{
+					m_Entities.erase(name->second);
+					m_Entity_To_Name.erase(name);
+				}
+
+				m_EntityManager.RemoveEntity(removedEntity);
 			}
 
+			/** Adds the component to the entity and marks the matching render state as dirty
+			@param entity
+			@param component
+			@return void
+			*/
 			template<typename ComponentType>
-			void AddComponent(const ECS::Entity& entity, ComponentType&& component)
+			void AddComponent(ECS::Entity& entity, ComponentType&& component)
 			{
-				// Add the component to ecs
-				
-				// Remove the component if the entity is in m_DirtyEntities and the component is flagged in m_RemovedFlag
-				
+				using DecayedType = std::decay_t<ComponentType>;
+				m_ComponentManager.template AddComponent<DecayedType>(entity, std::forward<ComponentType>(component));
+				this->MarkRenderStateDirty(entity, GetComponentFlag<DecayedType>());
 			}
 
+			/** Removes the component from the entity.
+			* The render state is removed from the proxy on the next FlushRenderUpdates()
+			@param entity
+			@return void
+			*/
 			template<typename ComponentType>
-			void RemoveComponent(const ECS::Entity& entity)
+			void RemoveComponent(ECS::Entity& entity)
 			{
-				// Remove the component from ecs
-				
-				// Add entity to m_DirtyEntities and modify the component flag in m_RemovedFlag
-				
+				m_ComponentManager.RemoveComponent<ComponentType>(entity);
+				this->MarkRenderStateDirty(entity, GetComponentFlag<ComponentType>());
 			}
 
+			/** Returns whether or not the entity belongs to the scene and hasn't been removed
+			@param entity
+			@return bool
+			*/
+			bool IsValid(const ECS::Entity& entity) const { return m_EntityManager.IsValid(entity); }
+
 			template<typename ComponentType>
-			void HasComponent(const ECS::Entity& entity) const
+			bool HasComponent(const ECS::Entity& entity) const
 			{
 				return m_ComponentManager.HasComponent<ComponentType>(entity);
 			}
 
-			void MarkRenderStateDirty(const ECS::Entity& entity, ComponentFlag flag)
-			{
-				ECS::TransformComponent* transformComp = m_ComponentManager.GetComponent<ECS::TransformComponent>(entity);
-
-				// NOTE: When we have SkeletalMeshComp we will make this if-statement be one or the other
-				ECS::EntityID id = entity.GetID();
-
-				ECS::StaticMeshComponent* staticMeshComp = m_ComponentManager.GetComponent<ECS::StaticMeshComponent>(entity);
-				m_Proxy->UpdateStaticMesh(id, transformComp, staticMeshComp);
-
-				ECS::PointLightComponent* pointLightComp = m_ComponentManager.GetComponent<ECS::PointLightComponent>(entity);
-				m_Proxy->UpdatePointLight(id, pointLightComp);
-
-				ECS::SpotLightComponent* spotLightComp = m_ComponentManager.GetComponent<ECS::SpotLightComponent>(entity);
-				m_Proxy->UpdateSpotLight(id, spotLightComp);
-
-				ECS::CameraComponent* cameraComp = m_ComponentManager.GetComponent<ECS::CameraComponent>(entity);
-				m_Proxy->UpdateCamera(id, cameraComp);
-
-				ECS::DirectionalLightComponent* DirLightComp = m_ComponentManager.GetComponent<ECS::DirectionalLightComponent>(entity);
-				m_Proxy->UpdateDirectionalLight(id, DirLightComp);
-			}
+			/** Flags the render state of the component kind as dirty for the entity.
+			* Flags are merged until the next FlushRenderUpdates(), so marking the same entity several times during a frame only updates it once.
+			* A dirty Transform also updates the render state of the components that depend on it, ex. the static mesh.
+			@param entity
+			@param flag
+			@return void
+			*/
+			void MarkRenderStateDirty(const ECS::Entity& entity, ComponentFlag flag);
+
+			/** Applies all render state changes that have been marked since the last flush to the proxy.
+			* Only the component kinds that were marked are rebuilt. Components that have been removed are removed from the proxy.
+			@return void
+			*/
+			void FlushRenderUpdates();
+
+			/** Returns the number of entities that currently have pending render state changes
+			@return size_t
+			*/
+			size_t GetNumDirtyEntities() const { return m_DirtyEntities.Size(); }
 
 			void RenameEntity(ECS::Entity entity, const std::string& newName)
 			{
@@ -131,21 +181,13 @@ namespace aZero
 				return "Entity_" + std::to_string(nameDummy++);
 			}
 
-			/*void OnDestroy(){}
-			void CreateRenderUpdates(){}
-			void ClearRenderUpdates(){}*/
-
-			// More mem than necessary, but quick add/remove + itteration
-			/*DS::SparseSet<ECS::EntityID, ECS::EntityID> m_NewEntities;
-			DS::SparseSet<ECS::EntityID, ECS::EntityID> m_RemovedEntities;
-
 			struct ComponentUpdateInfo
 			{
-				std::bitset<sizeof(int32_t)> m_UpdateFlag;
-				std::bitset<sizeof(int32_t)> m_RemovedFlag;
+				std::bitset<NumComponentFlags> m_UpdateFlag;
 			};
-			DS::SparseSet<ECS::EntityID, ComponentUpdateInfo> m_DirtyEntities;*/
-			//
+
+			// Entities with render state changes since the last flush. Dense so the flush is a linear pass.
+			DS::SparseSet<ECS::EntityID, ComponentUpdateInfo> m_DirtyEntities;
 
 			std::unique_ptr<SceneProxy> m_Proxy;
 
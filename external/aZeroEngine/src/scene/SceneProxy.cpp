@@ -1,4 +1,5 @@
 #include "SceneProxy.hpp"
+#include "misc/Profiler.hpp"
 
 namespace aZero
 {
@@ -6,23 +7,38 @@ namespace aZero
 	{
 		void SceneProxy::UpdateStaticMesh(ECS::EntityID id, const ECS::TransformComponent* transformComponent, const ECS::StaticMeshComponent* staticMeshComponent)
 		{
+			PROFILE_COUNTER(ProxyUpdates, 1);
+
 			if (!transformComponent || !staticMeshComponent) {
 				m_StaticMeshes.Remove(id);
+				m_StaticMeshBVH.Remove(id);
 				return;
 			}
 
 			RenderData::StaticMesh staticMesh(*transformComponent, *staticMeshComponent);
 			if (staticMesh.IsRenderReady()) {
+				DirectX::BoundingSphere worldBounds;
+				staticMeshComponent->GetMesh()->GetVertexData().Bounds.Transform(worldBounds, transformComponent->GetTransform());
+				const float sphere[4] = { worldBounds.Center.x, worldBounds.Center.y, worldBounds.Center.z, worldBounds.Radius };
+				if (m_StaticMeshBVH.Contains(id)) {
+					m_StaticMeshBVH.Update(id, sphere);
+				}
+				else {
+					m_StaticMeshBVH.Insert(id, sphere);
+				}
 
 				m_StaticMeshes.AddOrUpdate(id, std::move(staticMesh));
 			}
 			else {
 				m_StaticMeshes.Remove(id);
+				m_StaticMeshBVH.Remove(id);
 			}
 		}
 
 		void SceneProxy::UpdateCamera(ECS::EntityID id, const ECS::CameraComponent* cameraComponent)
 		{
+			PROFILE_COUNTER(ProxyUpdates, 1);
+
 			if (!cameraComponent) {
 				m_Cameras.Remove(id);
 				return;
@@ -38,6 +54,8 @@ namespace aZero
 
 		void SceneProxy::UpdateDirectionalLight(ECS::EntityID id, const ECS::DirectionalLightComponent* lightComponent)
 		{
+			PROFILE_COUNTER(ProxyUpdates, 1);
+
 			if (!lightComponent) {
 				m_DirectionalLights.Remove(id);
 				return;
@@ -48,6 +66,8 @@ namespace aZero
 
 		void SceneProxy::UpdatePointLight(ECS::EntityID id, const ECS::PointLightComponent* lightComponent)
 		{
+			PROFILE_COUNTER(ProxyUpdates, 1);
+
 			if (!lightComponent) {
 				m_PointLights.Remove(id);
 				return;
@@ -58,6 +78,8 @@ namespace aZero
 
 		void SceneProxy::UpdateSpotLight(ECS::EntityID id, const ECS::SpotLightComponent* lightComponent)
 		{
+			PROFILE_COUNTER(ProxyUpdates, 1);
+
 			if (!lightComponent) {
 				m_SpotLights.Remove(id);
 				return;
@@ -65,5 +87,28 @@ namespace aZero
 
 			m_SpotLights.AddOrUpdate(id, RenderData::SpotLight(*lightComponent));
 		}
+
+		void SceneProxy::CullStaticMeshes(const RenderData::Camera& camera, std::vector<uint32_t>& visibleInstances) const
+		{
+			PROFILE_SCOPE("SceneProxy::CullStaticMeshes");
+			// The BVH appends entity IDs to the caller's vector which are then replaced by their instance indices in place
+			const size_t firstVisible = visibleInstances.size();
+			m_StaticMeshBVH.Cull(camera.GetWorldFrustumPlanes(), visibleInstances);
+
+			for (size_t i = firstVisible; i < visibleInstances.size(); i++)
+			{
+				visibleInstances[i] = m_StaticMeshes.GetIndex(visibleInstances[i]);
+			}
+			PROFILE_COUNTER(VisibleInstances, visibleInstances.size() - firstVisible);
+		}
+
+		void SceneProxy::OptimizeCulling()
+		{
+			PROFILE_SCOPE("SceneProxy::OptimizeCulling");
+			// Incremental inserts keep the tree balanced but scatter its nodes, a rebuild restores the depth first layout
+			if (m_StaticMeshBVH.ShouldRebuild()) {
+				m_StaticMeshBVH.Rebuild();
+			}
+		}
 	}
 }
\ No newline at end of file
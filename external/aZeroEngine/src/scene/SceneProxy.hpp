@@ -1,6 +1,7 @@
 #pragma once
 #include "misc/SparseMappedVector.hpp"
 #include "SceneRenderData.hpp"
+#include "DynamicBVH.hpp"
 
 namespace aZero
 {
@@ -18,6 +19,22 @@ namespace aZero
 			void UpdatePointLight(ECS::EntityID id, const ECS::PointLightComponent* lightComponent);
 			void UpdateSpotLight(ECS::EntityID id, const ECS::SpotLightComponent* lightComponent);
 
+			/** Appends the indices into m_StaticMeshes.GetData() of the static meshes whose world bounds intersect the frustum of the camera.
+			* visibleInstances is owned by the caller so it can be cleared and reused every frame without reallocating.
+			@param camera
+			@param visibleInstances
+			@return void
+			*/
+			void CullStaticMeshes(const RenderData::Camera& camera, std::vector<uint32_t>& visibleInstances) const;
+
+			/** Rebuilds the static mesh BVH if many instances were added, removed or moved since the last rebuild.
+			* Called once per frame after the render updates have been flushed.
+			@return void
+			*/
+			void OptimizeCulling();
+
+			const DynamicBVH& GetStaticMeshBVH() const { return m_StaticMeshBVH; }
+
 			/*
 			NOTE:
 				If we move to a fully gpu-driven rendering pipeline this data need to have a mirrored version in vram.
@@ -32,6 +49,8 @@ namespace aZero
 			DataStructures::SparseMappedVector<ECS::EntityID, RenderData::SpotLight> m_SpotLights;
 
 		private:
+			// World space bounding spheres of the render ready static meshes, keyed by entity ID
+			DynamicBVH m_StaticMeshBVH;
 		};
 	}
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include "ecs/aZeroECS.hpp"
 #include "misc/HelperFunctions.hpp"
+#include "FrustumCulling.hpp"
 
 namespace aZero
 {
@@ -78,6 +79,25 @@ namespace aZero
 				}
 
 				GPUVersion CreateGPUVersion() const { return GPUVersion(*this); }
+
+				/** Returns the frustum planes in world space for CPU culling
+				@return Culling::FrustumPlanes
+				*/
+				Culling::FrustumPlanes GetWorldFrustumPlanes() const
+				{
+					DirectX::BoundingFrustum worldFrustum;
+					m_Frustrum.Transform(worldFrustum, m_View.Invert());
+
+					DirectX::XMVECTOR planeVectors[Culling::FrustumPlanes::NumPlanes];
+					worldFrustum.GetPlanes(&planeVectors[0], &planeVectors[1], &planeVectors[2], &planeVectors[3], &planeVectors[4], &planeVectors[5]);
+
+					float planes[Culling::FrustumPlanes::NumPlanes][4];
+					for (uint32_t planeIndex = 0; planeIndex < Culling::FrustumPlanes::NumPlanes; planeIndex++)
+					{
+						DirectX::XMStoreFloat4(reinterpret_cast<DirectX::XMFLOAT4*>(planes[planeIndex]), planeVectors[planeIndex]);
+					}
+					return Culling::FrustumPlanes(planes);
+				}
 			};
 
 			struct DirectionalLight
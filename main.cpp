@@ -5,6 +5,7 @@
 
 #ifdef RUN_TESTS
 #include "tests/Tests.hpp"
+#include "tests/Benchmarks.hpp"
 #endif
 
 #if USE_DEBUG
@@ -54,6 +55,7 @@ int main(int argc, char* argv[])
 
 #ifdef RUN_TESTS
 		RunTests(engine);
+		RunBenchmarks();
 #endif
 
 		// Create your own implemented window and swapchain + input system
@@ -67,26 +69,38 @@ int main(int argc, char* argv[])
 		auto dsv = renderer.CreateDepthStencilTarget(Rendering::DepthStencilTarget::Desc(width, height, 1, 0, true, true));
 		//
 
-		Asset::Mesh mesh(0);
+		std::vector<Asset::Mesh> meshes;
 		Asset::Material material(0);
 		Asset::Texture albedo(0);
 		Asset::Texture normalMap(1);
-		LoadAssets(engine, mesh, material, albedo, normalMap);
+		LoadAssets(engine, meshes, material, albedo, normalMap);
 		
 		Scene::SceneNew scene;
-		CreateScene(scene, mesh, material, { (float)width, (float)height });
+		CreateScene(scene, meshes, material, { (float)width, (float)height });
 		//
 
 		renderer.FlushFrameAllocations();
 
-		ECS::Entity meshEntity = scene.GetEntity("MeshEntity").value();
-		ECS::TransformComponent& tf = *scene.m_ComponentManager.GetComponent<ECS::TransformComponent>(meshEntity);
+		// The submeshes of the model are moved together
+		std::vector<ECS::Entity> meshEntities;
+		for (size_t meshIndex = 0; meshIndex < meshes.size(); meshIndex++)
+		{
+			meshEntities.push_back(scene.GetEntity("MeshEntity" + std::to_string(meshIndex)).value());
+		}
+		const auto setMeshTransform = [&scene, &meshEntities](const DXM::Matrix& transform) {
+			for (ECS::Entity meshEntity : meshEntities)
+			{
+				scene.m_ComponentManager.GetComponent<ECS::TransformComponent>(meshEntity)->SetTransform(transform);
+				scene.MarkRenderStateDirty(meshEntity, aZero::Scene::SceneNew::ComponentFlag::Transform);
+			}
+		};
+		DXM::Matrix meshTransform = DXM::Matrix::CreateRotationY(3.14) * DXM::Matrix::CreateTranslation(-10, -2, 4);
 
 		ECS::Entity camEnt = scene.GetEntity("CameraEntity").value();
 		ECS::CameraComponent& cam = *scene.m_ComponentManager.GetComponent<ECS::CameraComponent>(camEnt);
 		cam.m_RenderTarget = &rtv;
 		cam.m_DepthStencilTarget = &dsv;
-		scene.MarkRenderStateDirty(camEnt, aZero::Scene::SceneNew::ComponentFlag());
+		scene.MarkRenderStateDirty(camEnt, aZero::Scene::SceneNew::ComponentFlag::Camera);
 
 		
 		ECS::Entity camEnt2 = scene.GetEntity("CameraEntity2").value();
@@ -94,17 +108,17 @@ int main(int argc, char* argv[])
 		cam2.m_RenderTarget = &rtv;
 		cam2.m_DepthStencilTarget = &dsv;
 		cam2.m_Position = { 0,0,-10 };
-		scene.MarkRenderStateDirty(camEnt2, aZero::Scene::SceneNew::ComponentFlag());
+		scene.MarkRenderStateDirty(camEnt2, aZero::Scene::SceneNew::ComponentFlag::Camera);
 		
 
 		Input::KeyboardListener listener = window.GetDeviceManager().ListenKeyboard({
-			[&window, meshEntity, &tf, &scene](const SDL_Event& event, Input::Keyboard& keyboard) {
+			[&window, &meshTransform, &setMeshTransform](const SDL_Event& event, Input::Keyboard& keyboard) {
 				if (event.key.key == SDLK_RETURN)
 					window.Close();
 				if (event.key.key == SDLK_R)
 				{
-					tf.SetTransform(DXM::Matrix::CreateRotationY(3.14) * DXM::Matrix::CreateTranslation(0, -2, 4));
-					scene.MarkRenderStateDirty(meshEntity, aZero::Scene::SceneNew::ComponentFlag());
+					meshTransform = DXM::Matrix::CreateRotationY(3.14) * DXM::Matrix::CreateTranslation(0, -2, 4);
+					setMeshTransform(meshTransform);
 				}
 			},
 			[](const SDL_Event& event, Input::Keyboard& keyboard) { }
@@ -150,10 +164,10 @@ int main(int argc, char* argv[])
 			{
 				cam.m_Position += DXM::Vector3(0, -0.01f, 0);
 			}
-			scene.MarkRenderStateDirty(camEnt, aZero::Scene::SceneNew::ComponentFlag());
+			scene.MarkRenderStateDirty(camEnt, aZero::Scene::SceneNew::ComponentFlag::Camera);
 
-			tf.SetTransform(DXM::Matrix::CreateRotationY(0.001f) * tf.GetTransform());
-			scene.MarkRenderStateDirty(meshEntity, aZero::Scene::SceneNew::ComponentFlag());
+			meshTransform = DXM::Matrix::CreateRotationY(0.001f) * meshTransform;
+			setMeshTransform(meshTransform);
 			//
 
 			// Rendering the scene
@@ -0,0 +1,205 @@
+#pragma once
+#ifdef RUN_TESTS
+#include "HeadlessBenchmarks.hpp"
+#include "aZeroEngine/Engine.hpp"
+#include "assets/TextureCache.hpp"
+#include "misc/stb_image.h"
+
+// Joined Transform+StaticMesh iteration via ECS::View compared to per-entity GetComponent lookups
+inline void BenchmarkECSView()
+{
+	using namespace aZero;
+
+	printf("ECS view vs per-entity lookup (Transform + StaticMesh, every 4th entity has a StaticMesh)\n");
+	for (const uint32_t numEntities : { 100000u, 1000000u })
+	{
+		ECS::EntityManager entityManager;
+		ECS::ComponentManager<ECS::TransformComponent, ECS::StaticMeshComponent, ECS::PointLightComponent> componentManager;
+		componentManager.GetComponentArray<ECS::TransformComponent>().Init(numEntities);
+		componentManager.GetComponentArray<ECS::StaticMeshComponent>().Init(numEntities);
+
+		std::vector<ECS::Entity> entities(numEntities);
+		for (uint32_t i = 0; i < numEntities; i++)
+		{
+			entities[i] = entityManager.CreateEntity();
+			componentManager.AddComponent(entities[i], ECS::TransformComponent(DXM::Matrix::CreateTranslation(static_cast<float>(i), 0, 0)));
+			if (i % 4 == 0)
+			{
+				componentManager.AddComponent(entities[i], ECS::StaticMeshComponent());
+			}
+		}
+
+		float lookupSum = 0.f;
+		const double lookupTime = MeasureMilliseconds([&]() {
+			for (const ECS::Entity& entity : entities)
+			{
+				const ECS::TransformComponent* transform = componentManager.GetComponent<ECS::TransformComponent>(entity);
+				const ECS::StaticMeshComponent* staticMesh = componentManager.GetComponent<ECS::StaticMeshComponent>(entity);
+				if (transform && staticMesh)
+				{
+					lookupSum += transform->GetTransform()._41;
+				}
+			}
+			});
+
+		float viewSum = 0.f;
+		const double viewTime = MeasureMilliseconds([&]() {
+			componentManager.Each<ECS::TransformComponent, ECS::StaticMeshComponent>(
+				[&viewSum](ECS::EntityID, const ECS::TransformComponent& transform, const ECS::StaticMeshComponent&) {
+					viewSum += transform.GetTransform()._41;
+				});
+			});
+
+		printf("\t%u entities: lookup %.3f ms | view %.3f ms | %.2fx (checksum %s)\n",
+			numEntities, lookupTime, viewTime, lookupTime / std::max(viewTime, 0.001), lookupSum == viewSum ? "ok" : "MISMATCH");
+	}
+}
+
+// Sparse array memory of the paged component arrays compared to a flat ID => index array per component type
+inline void BenchmarkECSSparseMemory()
+{
+	using namespace aZero;
+
+	const uint32_t numEntities = 4000000;
+	printf("ECS sparse array memory, %u entities (flat = one uint32_t per entity and component type)\n", numEntities);
+
+	ECS::EntityManager entityManager;
+	ECS::ComponentManager<ECS::TransformComponent, ECS::StaticMeshComponent, ECS::PointLightComponent, ECS::CameraComponent> componentManager;
+
+	std::vector<ECS::Entity> entities(numEntities);
+	std::mt19937 random(1337);
+	for (uint32_t i = 0; i < numEntities; i++)
+	{
+		entities[i] = entityManager.CreateEntity();
+		componentManager.AddComponent(entities[i], ECS::TransformComponent());
+
+		// Meshes are spawned together, lights and cameras are scattered over the whole world
+		if (i < numEntities / 4)
+		{
+			componentManager.AddComponent(entities[i], ECS::StaticMeshComponent());
+		}
+
+		if (random() % 1000 < 5)
+		{
+			componentManager.AddComponent(entities[i], ECS::PointLightComponent());
+		}
+
+		if (random() % 100000 == 0)
+		{
+			componentManager.AddComponent(entities[i], ECS::CameraComponent());
+		}
+	}
+
+	const auto printArray = [numEntities](const char* name, const auto& componentArray) {
+		const size_t pagedBytes = componentArray.GetSparseMemoryUsage();
+		const size_t flatBytes = static_cast<size_t>(numEntities) * sizeof(ECS::EntityID);
+		printf("\t%-12s %8zu components: paged %8zu KB | flat %8zu KB | %6.2fx smaller | dense %8zu KB\n",
+			name, componentArray.GetNumComponents(), pagedBytes / 1024, flatBytes / 1024,
+			static_cast<double>(flatBytes) / std::max(pagedBytes, size_t(1)),
+			(componentArray.GetMemoryUsage() - pagedBytes) / 1024);
+		};
+
+	printArray("Transform", componentManager.GetComponentArray<ECS::TransformComponent>());
+	printArray("StaticMesh", componentManager.GetComponentArray<ECS::StaticMeshComponent>());
+	printArray("PointLight", componentManager.GetComponentArray<ECS::PointLightComponent>());
+	printArray("Camera", componentManager.GetComponentArray<ECS::CameraComponent>());
+
+	for (ECS::Entity& entity : entities)
+	{
+		componentManager.RemoveComponent<ECS::PointLightComponent>(entity);
+	}
+	printf("\tPointLight sparse pages after removing all: %zu KB (empty pages released)\n", componentManager.GetComponentArray<ECS::PointLightComponent>().GetSparseMemoryUsage() / 1024);
+
+	// Stale handles are rejected once the ID has been recycled
+	ECS::Entity stale = entities[0];
+	entityManager.RemoveEntity(entities[0]);
+	const ECS::Entity recycled = entityManager.CreateEntity();
+	size_t numValid = 0;
+	const double validTime = MeasureMilliseconds([&]() {
+		for (const ECS::Entity& entity : entities)
+		{
+			numValid += entityManager.IsValid(entity) ? 1 : 0;
+		}
+		});
+	printf("\tIsValid over %u handles: %.3f ms (%zu valid) | stale handle %s\n", numEntities, validTime, numValid,
+		!entityManager.IsValid(stale) && entityManager.IsValid(recycled) && stale.GetID() == recycled.GetID() ? "rejected" : "ALIASED");
+}
+
+// Mip generation and block compression throughput with the compression quality, and cold (decode + cook) vs warm (mapped cooked file) loads
+inline void BenchmarkTextureCooking()
+{
+	using namespace aZero;
+	using namespace aZero::Asset::TextureProcessing;
+	const std::string filePath = PROJECT_DIRECTORY + TEXTURE_ASSET_RELATIVE_PATH + "goblinAlbedo.png";
+
+	int32_t width, height, channels;
+	stbi_uc* texels = stbi_load(filePath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+	if (!texels)
+	{
+		printf("Texture cooking: failed to load %s\n", filePath.c_str());
+		return;
+	}
+
+	const double numMegaPixels = static_cast<double>(width) * height / 1000000.0;
+	printf("Texture cooking (%dx%d)\n", width, height);
+	for (const MipFilter filter : { MipFilter::Box, MipFilter::Kaiser })
+	{
+		std::vector<MipLevel> mips;
+		const double mipTime = MeasureMilliseconds([&]() { mips = GenerateMipChain(texels, width, height, filter, true); });
+		printf("\t%s mips: %.2f ms (%.1f MPix/s) | %zu levels\n",
+			filter == MipFilter::Box ? "Box" : "Kaiser", mipTime, numMegaPixels / std::max(mipTime, 0.001) * 1000.0, mips.size() + 1);
+	}
+
+	const std::pair<BlockFormat, const char*> formats[] = { { BlockFormat::BC1, "BC1" }, { BlockFormat::BC3, "BC3" }, { BlockFormat::BC5, "BC5" }, { BlockFormat::BC7, "BC7" } };
+	std::vector<uint8_t> decompressed(static_cast<size_t>(width) * height * 4);
+	for (const auto& [format, name] : formats)
+	{
+		std::vector<uint8_t> blocks(GetCompressedSize(width, height, format));
+		const double compressTime = MeasureMilliseconds([&]() { CompressImage(texels, width, height, format, blocks.data()); });
+		DecompressImage(blocks.data(), width, height, format, decompressed.data());
+
+		// BC1 is opaque and BC5 only stores red and green
+		const uint32_t numChannels = format == BlockFormat::BC5 ? 2 : (format == BlockFormat::BC1 ? 3 : 4);
+		printf("\t%s: %.2f ms (%.1f MPix/s) | PSNR %.2f dB | %zu KB (%.1fx smaller than RGBA8)\n",
+			name, compressTime, numMegaPixels / std::max(compressTime, 0.001) * 1000.0,
+			ComputePSNR(texels, decompressed.data(), width, height, numChannels),
+			blocks.size() / 1024, static_cast<double>(decompressed.size()) / blocks.size());
+	}
+	stbi_image_free(texels);
+
+	const Asset::TextureCookSettings settings;
+	std::error_code error;
+	std::filesystem::remove(Asset::TextureCache::GetCachePath(filePath, settings), error);
+
+	Asset::Texture uncooked;
+	const double decodeTime = MeasureMilliseconds([&]() { uncooked.Load(filePath, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB); });
+
+	Asset::Texture cold;
+	const double coldTime = MeasureMilliseconds([&]() { cold.Load(filePath, settings); });
+
+	Asset::Texture warm;
+	const double warmTime = MeasureMilliseconds([&]() { warm.Load(filePath, settings); });
+
+	printf("\tLoad: decode only %.2f ms | cold cook %.2f ms | warm %.2f ms (%.1fx faster than decode only)\n",
+		decodeTime, coldTime, warmTime, decodeTime / std::max(warmTime, 0.001));
+}
+
+inline void RunBenchmarks()
+{
+	BenchmarkMeshLoading();
+	BenchmarkMeshImportScaling();
+	BenchmarkECSView();
+	BenchmarkSparseMappedVector();
+	BenchmarkECSSparseMemory();
+	BenchmarkStagingCopyBatching();
+	BenchmarkFrustumCulling();
+	BenchmarkJobSystemScaling();
+	BenchmarkTextureCooking();
+	BenchmarkMeshletLods();
+	BenchmarkVertexQuantization();
+	BenchmarkSparseSet();
+	BenchmarkECSEntities();
+	BenchmarkProxyUpdates();
+	BenchmarkMeshletBuild();
+}
+#endif
@@ -0,0 +1,898 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <variant>
+#ifdef _WIN32
+#include <Windows.h>
+#include <psapi.h>
+#else
+#include <fstream>
+#endif
+#include "assets/Mesh.hpp"
+#include "assets/MeshletCache.hpp"
+#include "assets/MeshletLod.hpp"
+#include "assets/VertexQuantization.hpp"
+#include "ecs/EntityManager.hpp"
+#include "ecs/ComponentManager.hpp"
+#include "ecs/components/TransformComponent.hpp"
+#include "ecs/components/LightComponents.hpp"
+#include "misc/JobSystem.hpp"
+#include "misc/Profiler.hpp"
+#include "misc/RelativePathMacros.hpp"
+#include "misc/SparseMappedVector.hpp"
+#include "misc/SparseSet.hpp"
+#include "renderer/StagingCopyBatcher.hpp"
+#include "scene/DynamicBVH.hpp"
+
+// Benchmarks that only depend on the platform independent parts of the engine, so they also run in the headless Linux target (tests/headless)
+
+struct BenchmarkMemoryUsage
+{
+	size_t WorkingSet = 0;
+	size_t PeakWorkingSet = 0;
+};
+
+inline BenchmarkMemoryUsage GetBenchmarkMemoryUsage()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters{};
+	GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+	return { counters.WorkingSetSize, counters.PeakWorkingSetSize };
+#else
+	// The resident set is the closest to the working set, both are listed in KB
+	BenchmarkMemoryUsage usage;
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line))
+	{
+		if (line.starts_with("VmRSS:"))
+		{
+			usage.WorkingSet = std::stoull(line.substr(6)) * 1024;
+		}
+		else if (line.starts_with("VmHWM:"))
+		{
+			usage.PeakWorkingSet = std::stoull(line.substr(6)) * 1024;
+		}
+	}
+	return usage;
+#endif
+}
+
+template<typename Callable>
+inline double MeasureMilliseconds(Callable&& callable)
+{
+	const auto start = std::chrono::high_resolution_clock::now();
+	callable();
+	const auto end = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Roughly the size of a static mesh instance
+struct BenchmarkInstance
+{
+	DXM::Matrix Transform;
+	DXM::Vector4 BoundingSphere;
+	uint32_t MeshIndex = 0;
+	uint32_t MaterialIndex = 0;
+};
+
+// Same planes as Scene::RenderData::Camera::GetWorldFrustumPlanes() for a 90 degree 16:9 camera, without the render target the camera owns
+inline aZero::Scene::Culling::FrustumPlanes CreateBenchmarkFrustumPlanes(const DXM::Vector3& position, const DXM::Vector3& forward)
+{
+	using namespace aZero;
+	const DXM::Matrix projection = DXM::Matrix::CreatePerspectiveFieldOfView(DirectX::XM_PIDIV2, 16.f / 9.f, 0.1f, 1000.f);
+	const DXM::Matrix view = DXM::Matrix::CreateLookAt(position, position + forward, DXM::Vector3::Up);
+
+	DirectX::BoundingFrustum worldFrustum;
+	DirectX::BoundingFrustum(projection, true).Transform(worldFrustum, view.Invert());
+
+	DirectX::XMVECTOR planeVectors[Scene::Culling::FrustumPlanes::NumPlanes];
+	worldFrustum.GetPlanes(&planeVectors[0], &planeVectors[1], &planeVectors[2], &planeVectors[3], &planeVectors[4], &planeVectors[5]);
+
+	float planes[Scene::Culling::FrustumPlanes::NumPlanes][4];
+	for (uint32_t planeIndex = 0; planeIndex < Scene::Culling::FrustumPlanes::NumPlanes; planeIndex++)
+	{
+		DirectX::XMStoreFloat4(reinterpret_cast<DirectX::XMFLOAT4*>(planes[planeIndex]), planeVectors[planeIndex]);
+	}
+	return Scene::Culling::FrustumPlanes(planes);
+}
+
+// Closed UV sphere with welded seam and poles, 4 * rings^2 triangles
+inline void CreateBenchmarkSphere(uint32_t rings, std::vector<aZero::Asset::VertexPosition>& positions, std::vector<aZero::Asset::GenericVertexData>& vertexData, std::vector<aZero::Asset::VertexIndex>& indices)
+{
+	using namespace aZero;
+	const uint32_t segments = rings * 2;
+	positions.clear();
+	vertexData.clear();
+	indices.clear();
+
+	positions.emplace_back(0.f, 1.f, 0.f);
+	for (uint32_t ring = 1; ring < rings; ring++)
+	{
+		const float theta = DirectX::XM_PI * ring / rings;
+		for (uint32_t segment = 0; segment < segments; segment++)
+		{
+			const float phi = DirectX::XM_2PI * segment / segments;
+			positions.emplace_back(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+		}
+	}
+	positions.emplace_back(0.f, -1.f, 0.f);
+
+	const auto ringVertex = [segments](uint32_t ring, uint32_t segment) { return 1 + (ring - 1) * segments + segment % segments; };
+	const uint32_t bottomPole = static_cast<uint32_t>(positions.size()) - 1;
+	for (uint32_t segment = 0; segment < segments; segment++)
+	{
+		indices.insert(indices.end(), { 0, ringVertex(1, segment + 1), ringVertex(1, segment) });
+		indices.insert(indices.end(), { bottomPole, ringVertex(rings - 1, segment), ringVertex(rings - 1, segment + 1) });
+		for (uint32_t ring = 1; ring < rings - 1; ring++)
+		{
+			indices.insert(indices.end(), { ringVertex(ring, segment), ringVertex(ring, segment + 1), ringVertex(ring + 1, segment) });
+			indices.insert(indices.end(), { ringVertex(ring, segment + 1), ringVertex(ring + 1, segment + 1), ringVertex(ring + 1, segment) });
+		}
+	}
+
+	vertexData.reserve(positions.size());
+	for (const Asset::VertexPosition& position : positions)
+	{
+		vertexData.push_back({ DXM::Vector2(), position, DXM::Vector3(1.f, 0.f, 0.f) });
+	}
+}
+
+// Cold = import + meshlet build + cook, warm = mapping and validating the cooked file
+inline void BenchmarkMeshLoading()
+{
+	using namespace aZero;
+	const std::string meshDirectory = PROJECT_DIRECTORY + MESH_ASSET_RELATIVE_PATH;
+
+	printf("Mesh loading (cold vs warm cache)\n");
+	for (const auto& entry : std::filesystem::directory_iterator(meshDirectory))
+	{
+		if (!entry.is_regular_file())
+		{
+			continue;
+		}
+
+		const std::string filename = entry.path().filename().string();
+		const Asset::MeshletBuildSettings settings;
+
+		std::error_code error;
+		std::filesystem::remove(Asset::MeshletCache::GetCachePath(filename, settings), error);
+
+		std::vector<Asset::MeshletMeshData> coldMeshes;
+		const BenchmarkMemoryUsage coldBefore = GetBenchmarkMemoryUsage();
+		const double coldTime = MeasureMilliseconds([&]() { coldMeshes = Asset::LoadFromFile(filename, settings); });
+		const BenchmarkMemoryUsage coldAfter = GetBenchmarkMemoryUsage();
+		coldMeshes.clear();
+		coldMeshes.shrink_to_fit();
+
+		std::vector<Asset::MeshletMeshData> warmMeshes;
+		const BenchmarkMemoryUsage warmBefore = GetBenchmarkMemoryUsage();
+		const double warmTime = MeasureMilliseconds([&]() { warmMeshes = Asset::LoadFromFile(filename, settings); });
+		const BenchmarkMemoryUsage warmAfter = GetBenchmarkMemoryUsage();
+
+		// NOTE: The peak is process wide and never decreases, so the warm peak only shows growth beyond the cold run
+		printf("\t%s: cold %.2f ms (+%zu KB ws, +%zu KB peak) | warm %.2f ms (+%zu KB ws, +%zu KB peak) | %.1fx\n",
+			filename.c_str(),
+			coldTime, (coldAfter.WorkingSet - std::min(coldAfter.WorkingSet, coldBefore.WorkingSet)) / 1024, (coldAfter.PeakWorkingSet - coldBefore.PeakWorkingSet) / 1024,
+			warmTime, (warmAfter.WorkingSet - std::min(warmAfter.WorkingSet, warmBefore.WorkingSet)) / 1024, (warmAfter.PeakWorkingSet - warmBefore.PeakWorkingSet) / 1024,
+			coldTime / std::max(warmTime, 0.001));
+	}
+}
+
+// Uncached import of every mesh file with an increasing number of import jobs. 1 job is the serial path.
+inline void BenchmarkMeshImportScaling()
+{
+	using namespace aZero;
+	const std::string meshDirectory = PROJECT_DIRECTORY + MESH_ASSET_RELATIVE_PATH;
+	const uint32_t maxThreads = Jobs::GetJobSystem().GetNumWorkers();
+
+	printf("Mesh import thread scaling (uncached)\n");
+	for (const auto& entry : std::filesystem::directory_iterator(meshDirectory))
+	{
+		if (!entry.is_regular_file())
+		{
+			continue;
+		}
+
+		const std::string filename = entry.path().filename().string();
+
+		double serialTime = 0.0;
+		for (uint32_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+		{
+			Asset::MeshletBuildSettings settings;
+			settings.UseCache = false;
+			settings.NumImportThreads = numThreads;
+
+			size_t numSubMeshes = 0;
+			const double time = MeasureMilliseconds([&]() { numSubMeshes = Asset::LoadFromFile(filename, settings).size(); });
+			if (numThreads == 1)
+			{
+				serialTime = time;
+			}
+
+			printf("\t%s (%zu submeshes): %u threads %.2f ms | %.2fx\n", filename.c_str(), numSubMeshes, numThreads, time, serialTime / std::max(time, 0.001));
+		}
+	}
+}
+
+// Add/update/remove throughput of the flat SparseMappedVector that backs the SceneProxy primitive lists
+inline void BenchmarkSparseMappedVector()
+{
+	using namespace aZero;
+
+	printf("SparseMappedVector (entity IDs spread over 2x the instance count, removal in shuffled order)\n");
+	for (const uint32_t numInstances : { 10000u, 100000u, 1000000u })
+	{
+		std::vector<ECS::EntityID> IDs(numInstances);
+		for (uint32_t i = 0; i < numInstances; i++)
+		{
+			IDs[i] = i * 2;
+		}
+
+		DataStructures::SparseMappedVector<ECS::EntityID, BenchmarkInstance> instances;
+
+		const BenchmarkMemoryUsage before = GetBenchmarkMemoryUsage();
+		const double addTime = MeasureMilliseconds([&]() {
+			for (const ECS::EntityID ID : IDs)
+			{
+				instances.AddOrUpdate(ID, BenchmarkInstance{ DXM::Matrix::CreateTranslation(static_cast<float>(ID), 0, 0) });
+			}
+			});
+		const BenchmarkMemoryUsage after = GetBenchmarkMemoryUsage();
+		const size_t allocatedBytes = instances.GetMemoryUsage();
+
+		const double updateTime = MeasureMilliseconds([&]() {
+			for (const ECS::EntityID ID : IDs)
+			{
+				instances.AddOrUpdate(ID, BenchmarkInstance{ DXM::Matrix::CreateTranslation(0, static_cast<float>(ID), 0) });
+			}
+			});
+
+		std::shuffle(IDs.begin(), IDs.end(), std::mt19937(1337));
+		const double removeTime = MeasureMilliseconds([&]() {
+			for (const ECS::EntityID ID : IDs)
+			{
+				instances.Remove(ID);
+			}
+			});
+
+		const auto throughput = [numInstances](double time) { return numInstances / std::max(time, 0.001) / 1000.0; };
+		printf("\t%u instances: add %.2f ms (%.1f M/s) | update %.2f ms (%.1f M/s) | remove %.2f ms (%.1f M/s) | %zu KB allocated, +%zu KB ws (%s)\n",
+			numInstances,
+			addTime, throughput(addTime),
+			updateTime, throughput(updateTime),
+			removeTime, throughput(removeTime),
+			allocatedBytes / 1024, (after.WorkingSet - std::min(after.WorkingSet, before.WorkingSet)) / 1024,
+			instances.Size() == 0 ? "ok" : "NOT EMPTY");
+	}
+}
+
+// Packs into a reused CPU staging array and counts the copies, isolating the batching cost from the device
+struct BenchmarkCopyRecorder : public aZero::Rendering::CopyRecorder<uint32_t>
+{
+	std::vector<uint8_t> Staging;
+	uint32_t NumCopies = 0;
+
+	uint8_t* AllocateStaging(uint64_t numBytes) override
+	{
+		Staging.resize(std::max<size_t>(Staging.size(), numBytes));
+		return Staging.data();
+	}
+
+	void RecordCopy(uint32_t, uint64_t, uint64_t, uint64_t) override { NumCopies++; }
+};
+
+// Per-frame instance uploads through the staging batcher. Mostly sequential per buffer with some scattered updates.
+inline void BenchmarkStagingCopyBatching()
+{
+	using namespace aZero;
+	struct InstanceData
+	{
+		DXM::Matrix Transform;
+	};
+
+	printf("Staging copy batching (64 byte writes over 4 buffers, 10%% scattered)\n");
+	for (const uint32_t numWrites : { 10000u, 100000u, 1000000u })
+	{
+		std::vector<std::pair<uint32_t, uint64_t>> writes(numWrites);
+		std::mt19937 random(1337);
+		for (uint32_t i = 0; i < numWrites; i++)
+		{
+			const uint32_t dst = i % 4;
+			const uint64_t element = random() % 10 == 0 ? random() % numWrites : i / 4;
+			writes[i] = { dst, element * sizeof(InstanceData) };
+		}
+
+		Rendering::StagingCopyBatcher<uint32_t> batcher;
+		BenchmarkCopyRecorder recorder;
+		const InstanceData instance{ DXM::Matrix::Identity };
+
+		// Warm up so the CPU chunks and staging are allocated
+		for (const auto& [dst, offset] : writes)
+		{
+			batcher.Add(&instance, dst, offset, sizeof(instance));
+		}
+		batcher.Record(recorder);
+		batcher.Reset();
+
+		const double addTime = MeasureMilliseconds([&]() {
+			for (const auto& [dst, offset] : writes)
+			{
+				batcher.Add(&instance, dst, offset, sizeof(instance));
+			}
+			});
+
+		recorder.NumCopies = 0;
+		Rendering::StagingCopyBatcher<uint32_t>::RecordStats stats;
+		const double recordTime = MeasureMilliseconds([&]() { stats = batcher.Record(recorder); });
+		batcher.Reset();
+
+		printf("\t%u writes: add %.2f ms | record %.2f ms | %u copies (%.1fx fewer) | %.1f MB written, %.1f MB copied\n",
+			numWrites, addTime, recordTime, stats.NumCopies, static_cast<double>(stats.NumWrites) / std::max(stats.NumCopies, 1u),
+			stats.NumBytesWritten / (1024.0 * 1024.0), stats.NumBytesCopied / (1024.0 * 1024.0));
+	}
+}
+
+// Brute force SIMD sphere tests vs the static mesh BVH for a few cameras in a large uniformly filled world
+inline void BenchmarkFrustumCulling()
+{
+	using namespace aZero;
+	constexpr float worldExtent = 2000.f;
+	constexpr uint32_t numRepeats = 10;
+
+	std::vector<Scene::Culling::FrustumPlanes> cameras;
+	const DXM::Vector3 cameraSetup[][2] = {
+		{ { 0.f, 0.f, 0.f }, { 1.f, 0.f, 0.f } },
+		{ { 1000.f, 0.f, 1000.f }, { 0.f, 0.f, -1.f } },
+		{ { -1800.f, 0.f, -1800.f }, { 0.7071f, 0.f, 0.7071f } },
+		{ { 0.f, 1800.f, 0.f }, { 0.f, -0.6f, 0.8f } },
+	};
+	for (const auto& [position, forward] : cameraSetup)
+	{
+		cameras.push_back(CreateBenchmarkFrustumPlanes(position, forward));
+	}
+
+	printf("Frustum culling (%zu cameras, brute force vs BVH)\n", cameras.size());
+	for (const uint32_t numInstances : { 10000u, 100000u, 1000000u })
+	{
+		std::mt19937 random(1337);
+		std::uniform_real_distribution<float> position(-worldExtent, worldExtent);
+		std::uniform_real_distribution<float> radius(0.5f, 5.f);
+
+		Scene::Culling::SphereArray spheres;
+		spheres.Resize(numInstances);
+		Scene::DynamicBVH bvh;
+		std::vector<std::array<float, 4>> bounds(numInstances);
+		const double insertTime = MeasureMilliseconds([&]() {
+			for (uint32_t i = 0; i < numInstances; i++)
+			{
+				bounds[i] = { position(random), position(random), position(random), radius(random) };
+				spheres.Set(i, bounds[i].data());
+				bvh.Insert(i, bounds[i].data());
+			}
+			});
+		const double rebuildTime = MeasureMilliseconds([&]() { bvh.Rebuild(); });
+
+		// Move 10% of the instances slightly, most of them stay inside their enlarged leaf boxes
+		uint32_t numReinserted = 0;
+		const double updateTime = MeasureMilliseconds([&]() {
+			for (uint32_t i = 0; i < numInstances; i += 10)
+			{
+				bounds[i][0] += 0.2f;
+				spheres.Set(i, bounds[i].data());
+				numReinserted += bvh.Update(i, bounds[i].data()) ? 1 : 0;
+			}
+			});
+
+		double bruteTime = 0.0;
+		double bvhTime = 0.0;
+		size_t numVisible = 0;
+		bool match = true;
+		std::vector<uint32_t> bruteVisible;
+		std::vector<uint32_t> bvhVisible;
+		for (const Scene::Culling::FrustumPlanes& planes : cameras)
+		{
+			bruteTime += MeasureMilliseconds([&]() {
+				for (uint32_t repeat = 0; repeat < numRepeats; repeat++)
+				{
+					bruteVisible.clear();
+					spheres.Cull(planes, bruteVisible);
+				}
+				});
+			bvhTime += MeasureMilliseconds([&]() {
+				for (uint32_t repeat = 0; repeat < numRepeats; repeat++)
+				{
+					bvhVisible.clear();
+					bvh.Cull(planes, bvhVisible);
+				}
+				});
+
+			std::sort(bvhVisible.begin(), bvhVisible.end());
+			match &= bruteVisible == bvhVisible;
+			numVisible += bruteVisible.size();
+		}
+
+		const double numCulls = static_cast<double>(cameras.size() * numRepeats);
+		printf("\t%u instances: insert %.2f ms | rebuild %.2f ms | update 10%% %.2f ms (%u reinserted) | brute %.3f ms/camera | BVH %.3f ms/camera (%.1fx) | %zu visible | %s | BVH %.1f MB\n",
+			numInstances, insertTime, rebuildTime, updateTime, numReinserted, bruteTime / numCulls, bvhTime / numCulls, bruteTime / std::max(bvhTime, 0.001),
+			numVisible / cameras.size(), match ? "results match" : "RESULTS DIFFER", bvh.GetMemoryUsage() / (1024.0 * 1024.0));
+	}
+}
+
+// Job system scaling with the number of workers for a compute bound parallel-for, many tiny jobs and nested fork-join
+inline void BenchmarkJobSystemScaling()
+{
+	using namespace aZero;
+	const uint32_t maxWorkers = std::max(std::thread::hardware_concurrency(), 1u);
+	constexpr uint32_t numElements = 1 << 22;
+	constexpr uint32_t numTinyJobs = 100000;
+
+	std::vector<float> output(numElements);
+	double serialParallelForTime = 0.0;
+	double serialNestedTime = 0.0;
+
+	std::vector<uint32_t> workerCounts;
+	for (uint32_t numWorkers = 1; numWorkers < maxWorkers; numWorkers *= 2)
+	{
+		workerCounts.push_back(numWorkers);
+	}
+	workerCounts.push_back(maxWorkers);
+
+	printf("Job system scaling\n");
+	for (const uint32_t numWorkers : workerCounts)
+	{
+		Jobs::JobSystem jobSystem(numWorkers - 1);
+
+		const double parallelForTime = MeasureMilliseconds([&]() {
+			jobSystem.ParallelFor(numElements, 1024, [&](uint32_t begin, uint32_t end)
+				{
+					for (uint32_t index = begin; index < end; index++)
+					{
+						float value = static_cast<float>(index);
+						for (uint32_t iteration = 0; iteration < 16; iteration++)
+						{
+							value = value * 0.999f + std::sqrt(value + iteration);
+						}
+						output[index] = value;
+					}
+				});
+			});
+
+		std::atomic<uint32_t> numExecuted = 0;
+		const double tinyJobsTime = MeasureMilliseconds([&]() {
+			Jobs::JobCounter counter;
+			for (uint32_t jobIndex = 0; jobIndex < numTinyJobs; jobIndex++)
+			{
+				jobSystem.Run([&numExecuted]() { numExecuted++; }, &counter);
+			}
+			jobSystem.Wait(counter);
+			});
+
+		std::atomic<uint64_t> nestedSum = 0;
+		const double nestedTime = MeasureMilliseconds([&]() {
+			jobSystem.ParallelFor(256, 1, [&](uint32_t begin, uint32_t end)
+				{
+					for (uint32_t outer = begin; outer < end; outer++)
+					{
+						jobSystem.ParallelFor(4096, 256, [&](uint32_t innerBegin, uint32_t innerEnd)
+							{
+								uint64_t sum = 0;
+								for (uint32_t inner = innerBegin; inner < innerEnd; inner++)
+								{
+									sum += static_cast<uint64_t>(std::sqrt(static_cast<float>(outer * inner)));
+								}
+								nestedSum += sum;
+							});
+					}
+				});
+			});
+
+		if (numWorkers == 1)
+		{
+			serialParallelForTime = parallelForTime;
+			serialNestedTime = nestedTime;
+		}
+
+		printf("\t%u workers: parallel-for %.2f ms (%.2fx) | %u tiny jobs %.2f ms (%.0f jobs/ms) | nested fork-join %.2f ms (%.2fx)\n",
+			numWorkers, parallelForTime, serialParallelForTime / std::max(parallelForTime, 0.001),
+			numExecuted.load(), tinyJobsTime, numTinyJobs / std::max(tinyJobsTime, 0.001),
+			nestedTime, serialNestedTime / std::max(nestedTime, 0.001));
+	}
+}
+
+// Cluster LOD build cost and how many triangles the selected cut keeps at increasing distances
+inline void BenchmarkMeshletLods()
+{
+	using namespace aZero;
+	const std::string meshDirectory = PROJECT_DIRECTORY + MESH_ASSET_RELATIVE_PATH;
+
+	printf("Meshlet LOD hierarchy (uncached, 1 px error at 1080p and 45 degree FOV)\n");
+	for (const auto& entry : std::filesystem::directory_iterator(meshDirectory))
+	{
+		if (!entry.is_regular_file())
+		{
+			continue;
+		}
+
+		const std::string filename = entry.path().filename().string();
+
+		Asset::MeshletBuildSettings settings;
+		settings.UseCache = false;
+		settings.GenerateLods = false;
+		const double flatTime = MeasureMilliseconds([&]() { Asset::LoadFromFile(filename, settings); });
+
+		settings.GenerateLods = true;
+		std::vector<Asset::MeshletMeshData> meshes;
+		const double lodTime = MeasureMilliseconds([&]() { meshes = Asset::LoadFromFile(filename, settings); });
+		printf("\t%s: build %.2f ms without LODs | %.2f ms with LODs\n", filename.c_str(), flatTime, lodTime);
+
+		for (const Asset::MeshletMeshData& mesh : meshes)
+		{
+			uint32_t numLevels = 0;
+			for (const Asset::MeshletGroup& group : mesh.MeshletGroups)
+			{
+				numLevels = std::max(numLevels, group.Level);
+			}
+
+			uint32_t numLod0Triangles = 0;
+			uint32_t numTotalTriangles = 0;
+			uint32_t numRootTriangles = 0;
+			for (const Asset::Meshlet& meshlet : mesh.Meshlets)
+			{
+				numTotalTriangles += meshlet.PrimitivesCount;
+				numLod0Triangles += meshlet.SourceGroup == Asset::InvalidMeshletGroup ? meshlet.PrimitivesCount : 0;
+				numRootTriangles += meshlet.ParentGroup == Asset::InvalidMeshletGroup ? meshlet.PrimitivesCount : 0;
+			}
+
+			printf("\t\t%s: %u levels | %u LOD0 tris | %u total tris (%.2fx) | %u root tris\n", mesh.Name.c_str(), numLevels, numLod0Triangles, numTotalTriangles,
+				static_cast<double>(numTotalTriangles) / std::max(numLod0Triangles, 1u), numRootTriangles);
+
+			Asset::MeshletLodView view;
+			view.ProjectionScale = 1080.f / (2.f * std::tan(DirectX::XM_PIDIV4 * 0.5f));
+			std::vector<uint32_t> selected;
+			for (const float radii : { 2.f, 8.f, 32.f, 128.f })
+			{
+				view.Position = DXM::Vector3(mesh.Bounds.Center) + DXM::Vector3(0.f, 0.f, -mesh.Bounds.Radius * radii);
+				selected.clear();
+				Asset::SelectMeshletLods(mesh, view, selected);
+
+				uint32_t numTriangles = 0;
+				for (const uint32_t meshlet : selected)
+				{
+					numTriangles += mesh.Meshlets[meshlet].PrimitivesCount;
+				}
+				printf("\t\t\tat %.0f radii: %zu meshlets | %u tris (%.1f%%)\n", radii, selected.size(), numTriangles, 100.0 * numTriangles / std::max(numLod0Triangles, 1u));
+			}
+		}
+	}
+}
+
+// Vertex stream size and precision of the quantized format compared to the float format
+inline void BenchmarkVertexQuantization()
+{
+	using namespace aZero;
+	using namespace aZero::Asset::VertexQuantization;
+	const std::string meshDirectory = PROJECT_DIRECTORY + MESH_ASSET_RELATIVE_PATH;
+
+	printf("Vertex quantization (float vs quantized vertex streams)\n");
+	for (const auto& entry : std::filesystem::directory_iterator(meshDirectory))
+	{
+		if (!entry.is_regular_file())
+		{
+			continue;
+		}
+
+		const std::string filename = entry.path().filename().string();
+
+		Asset::MeshletBuildSettings settings;
+		settings.UseCache = false;
+		std::vector<Asset::MeshletMeshData> meshes = Asset::LoadFromFile(filename, settings);
+
+		QuantizationStats total;
+		const double encodeTime = MeasureMilliseconds([&]() {
+			for (Asset::MeshletMeshData& mesh : meshes)
+			{
+				const QuantizationStats stats = QuantizeVertices(mesh);
+				total.MaxPositionError = std::max(total.MaxPositionError, stats.MaxPositionError / mesh.Bounds.Radius);
+				total.MaxNormalError = std::max(total.MaxNormalError, stats.MaxNormalError);
+				total.MaxTangentError = std::max(total.MaxTangentError, stats.MaxTangentError);
+				total.MaxUVError = std::max(total.MaxUVError, stats.MaxUVError);
+				total.FloatBytes += stats.FloatBytes;
+				total.QuantizedBytes += stats.QuantizedBytes;
+			}
+			});
+
+		printf("\t%s: %.2f MB -> %.2f MB (%.2fx) | encode %.2f ms\n", filename.c_str(), total.FloatBytes / (1024.0 * 1024.0), total.QuantizedBytes / (1024.0 * 1024.0),
+			static_cast<double>(total.FloatBytes) / std::max(total.QuantizedBytes, uint64_t(1)), encodeTime);
+		printf("\t\tmax error: position %.2e of bounds radius | normal %.4f deg | tangent %.4f deg | UV %.2e\n",
+			total.MaxPositionError, total.MaxNormalError, total.MaxTangentError, total.MaxUVError);
+	}
+}
+
+// Insert, shuffled lookup, dense iteration and shuffled removal of the paged SparseSet compared to std::unordered_map
+inline void BenchmarkSparseSet()
+{
+	using namespace aZero;
+
+	printf("SparseSet vs std::unordered_map (IDs spread over 2x the element count, lookup and removal in shuffled order)\n");
+	for (const uint32_t numElements : { 10000u, 100000u, 1000000u })
+	{
+		std::vector<uint32_t> IDs(numElements);
+		for (uint32_t i = 0; i < numElements; i++)
+		{
+			IDs[i] = i * 2;
+		}
+		std::vector<uint32_t> shuffledIDs = IDs;
+		std::shuffle(shuffledIDs.begin(), shuffledIDs.end(), std::mt19937(1337));
+
+		DS::SparseSet<uint32_t, DXM::Matrix> sparseSet;
+		std::unordered_map<uint32_t, DXM::Matrix> map;
+
+		const double setAddTime = MeasureMilliseconds([&]() {
+			for (const uint32_t ID : IDs)
+			{
+				sparseSet.Add(ID, DXM::Matrix::CreateTranslation(static_cast<float>(ID), 0, 0));
+			}
+			});
+		const double mapAddTime = MeasureMilliseconds([&]() {
+			for (const uint32_t ID : IDs)
+			{
+				map.emplace(ID, DXM::Matrix::CreateTranslation(static_cast<float>(ID), 0, 0));
+			}
+			});
+
+		double setLookupSum = 0.0;
+		const double setLookupTime = MeasureMilliseconds([&]() {
+			for (const uint32_t ID : shuffledIDs)
+			{
+				setLookupSum += sparseSet.Find(ID)->_41;
+			}
+			});
+		double mapLookupSum = 0.0;
+		const double mapLookupTime = MeasureMilliseconds([&]() {
+			for (const uint32_t ID : shuffledIDs)
+			{
+				mapLookupSum += map.find(ID)->second._41;
+			}
+			});
+
+		double setIterateSum = 0.0;
+		const double setIterateTime = MeasureMilliseconds([&]() {
+			const std::vector<DXM::Matrix>& elements = sparseSet.GetData();
+			for (uint32_t i = 0; i < sparseSet.Size(); i++)
+			{
+				setIterateSum += elements[i]._41;
+			}
+			});
+		double mapIterateSum = 0.0;
+		const double mapIterateTime = MeasureMilliseconds([&]() {
+			for (const auto& [ID, element] : map)
+			{
+				mapIterateSum += element._41;
+			}
+			});
+
+		const double setRemoveTime = MeasureMilliseconds([&]() {
+			for (const uint32_t ID : shuffledIDs)
+			{
+				sparseSet.Remove(ID);
+			}
+			});
+		const double mapRemoveTime = MeasureMilliseconds([&]() {
+			for (const uint32_t ID : shuffledIDs)
+			{
+				map.erase(ID);
+			}
+			});
+
+		const bool match = setLookupSum == mapLookupSum && setIterateSum == mapIterateSum && sparseSet.Size() == 0 && map.empty();
+		printf("\t%u elements: add %.2f / %.2f ms | lookup %.2f / %.2f ms | iterate %.3f / %.3f ms | remove %.2f / %.2f ms (set / map, checksum %s)\n",
+			numElements, setAddTime, mapAddTime, setLookupTime, mapLookupTime, setIterateTime, mapIterateTime, setRemoveTime, mapRemoveTime, match ? "ok" : "MISMATCH");
+	}
+}
+
+// Entity creation, joined iteration and churn of half the entities, the ECS work of a scene without the render proxy
+inline void BenchmarkECSEntities()
+{
+	using namespace aZero;
+
+	printf("ECS entities (Transform on every entity, PointLight on every 4th, every other entity removed and recreated)\n");
+	for (const uint32_t numEntities : { 100000u, 1000000u })
+	{
+		ECS::EntityManager entityManager;
+		ECS::ComponentManager<ECS::TransformComponent, ECS::PointLightComponent> componentManager;
+
+		std::vector<ECS::Entity> entities(numEntities);
+		const double createTime = MeasureMilliseconds([&]() {
+			for (uint32_t i = 0; i < numEntities; i++)
+			{
+				entities[i] = entityManager.CreateEntity();
+				componentManager.AddComponent(entities[i], ECS::TransformComponent(DXM::Matrix::CreateTranslation(static_cast<float>(i), 0, 0)));
+				if (i % 4 == 0)
+				{
+					componentManager.AddComponent(entities[i], ECS::PointLightComponent());
+				}
+			}
+			});
+
+		double viewSum = 0.0;
+		const double viewTime = MeasureMilliseconds([&]() {
+			componentManager.Each<ECS::TransformComponent, ECS::PointLightComponent>(
+				[&viewSum](ECS::EntityID, const ECS::TransformComponent& transform, const ECS::PointLightComponent&) {
+					viewSum += transform.GetTransform()._41;
+				});
+			});
+
+		const double churnTime = MeasureMilliseconds([&]() {
+			for (uint32_t i = 0; i < numEntities; i += 2)
+			{
+				componentManager.RemoveComponent<ECS::TransformComponent>(entities[i]);
+				componentManager.RemoveComponent<ECS::PointLightComponent>(entities[i]);
+				entityManager.RemoveEntity(entities[i]);
+
+				entities[i] = entityManager.CreateEntity();
+				componentManager.AddComponent(entities[i], ECS::TransformComponent(DXM::Matrix::CreateTranslation(static_cast<float>(i), 0, 0)));
+			}
+			});
+
+		// Every light was on an even index, so none are left after the churn
+		double churnedViewSum = 0.0;
+		componentManager.Each<ECS::TransformComponent, ECS::PointLightComponent>(
+			[&churnedViewSum](ECS::EntityID, const ECS::TransformComponent& transform, const ECS::PointLightComponent&) {
+				churnedViewSum += transform.GetTransform()._41;
+			});
+
+		const bool valid = churnedViewSum == 0.0 && entityManager.GetNumEntities() == numEntities;
+		printf("\t%u entities: create %.2f ms | view %.3f ms | churn %u %.2f ms (%.1f M/s) | %s\n",
+			numEntities, createTime, viewTime, numEntities / 2, churnTime, numEntities / 2 / std::max(churnTime, 0.001) / 1000.0, valid ? "ok" : "INVALID");
+	}
+}
+
+// Frames of moving instances through the same steps as SceneProxy: dirty set, flush into the instance storage and BVH, rebuild policy and culling.
+// SceneProxy itself depends on D3D12 resources, so its storage is driven directly.
+inline void BenchmarkProxyUpdates()
+{
+	using namespace aZero;
+	constexpr float worldExtent = 2000.f;
+	constexpr uint32_t numFrames = 60;
+
+	const Scene::Culling::FrustumPlanes planes = CreateBenchmarkFrustumPlanes(DXM::Vector3(0.f, 0.f, 0.f), DXM::Vector3(1.f, 0.f, 0.f));
+	Profiling::Profiler& profiler = Profiling::GetProfiler();
+
+	printf("Proxy updates (%u frames, 5%% of the instances move each frame, 1 camera)\n", numFrames);
+	for (const uint32_t numInstances : { 10000u, 100000u, 1000000u })
+	{
+		std::mt19937 random(1337);
+		std::uniform_real_distribution<float> position(-worldExtent, worldExtent);
+		std::uniform_int_distribution<uint32_t> instance(0, numInstances - 1);
+
+		std::vector<std::array<float, 4>> bounds(numInstances);
+		DS::SparseSet<uint32_t, std::monostate> dirtyInstances;
+		DataStructures::SparseMappedVector<uint32_t, BenchmarkInstance> instances;
+		Scene::DynamicBVH bvh;
+		for (uint32_t i = 0; i < numInstances; i++)
+		{
+			bounds[i] = { position(random), position(random), position(random), 2.f };
+			dirtyInstances.Add(i, std::monostate());
+		}
+
+		const auto flush = [&]() {
+			for (const uint32_t ID : dirtyInstances.GetIDs())
+			{
+				const std::array<float, 4>& sphere = bounds[ID];
+				instances.AddOrUpdate(ID, BenchmarkInstance{ DXM::Matrix::CreateTranslation(sphere[0], sphere[1], sphere[2]), DXM::Vector4(sphere.data()) });
+				if (bvh.Contains(ID))
+				{
+					bvh.Update(ID, sphere.data());
+				}
+				else
+				{
+					bvh.Insert(ID, sphere.data());
+				}
+			}
+			profiler.AddCounter(Profiling::Counter::ProxyUpdates, dirtyInstances.Size());
+			dirtyInstances.Clear();
+
+			if (bvh.ShouldRebuild())
+			{
+				bvh.Rebuild();
+			}
+		};
+
+		const double loadTime = MeasureMilliseconds(flush);
+
+		std::vector<uint32_t> visible;
+		double minFrameTime = std::numeric_limits<double>::max();
+		double maxFrameTime = 0.0;
+		double totalFrameTime = 0.0;
+		uint64_t numProxyUpdates = 0;
+		uint64_t numVisible = 0;
+		for (uint32_t frame = 0; frame < numFrames; frame++)
+		{
+			for (uint32_t mover = 0; mover < numInstances / 20; mover++)
+			{
+				const uint32_t ID = instance(random);
+				bounds[ID][0] += 0.5f;
+				dirtyInstances.Add(ID, std::monostate());
+			}
+
+			profiler.BeginFrame();
+			flush();
+			visible.clear();
+			bvh.Cull(planes, visible);
+			profiler.AddCounter(Profiling::Counter::Instances, instances.Size());
+			profiler.AddCounter(Profiling::Counter::VisibleInstances, visible.size());
+			const Profiling::FrameStats stats = profiler.EndFrame();
+
+			minFrameTime = std::min(minFrameTime, stats.GetMilliseconds());
+			maxFrameTime = std::max(maxFrameTime, stats.GetMilliseconds());
+			totalFrameTime += stats.GetMilliseconds();
+			numProxyUpdates += stats.Get(Profiling::Counter::ProxyUpdates);
+			numVisible += stats.Get(Profiling::Counter::VisibleInstances);
+		}
+
+		printf("\t%u instances: load %.2f ms | frame %.3f ms avg, %.3f min, %.3f max | %llu proxy updates/frame | %llu visible | %.1f MB instances, %.1f MB BVH\n",
+			numInstances, loadTime, totalFrameTime / numFrames, minFrameTime, maxFrameTime,
+			static_cast<unsigned long long>(numProxyUpdates / numFrames), static_cast<unsigned long long>(numVisible / numFrames),
+			instances.GetMemoryUsage() / (1024.0 * 1024.0), bvh.GetMemoryUsage() / (1024.0 * 1024.0));
+	}
+}
+
+// Meshlet build of procedural spheres of increasing size, isolates the meshlet, LOD and quantization cost from file import
+inline void BenchmarkMeshletBuild()
+{
+	using namespace aZero;
+
+	printf("Meshlet build (procedural UV spheres, uncached)\n");
+	for (const uint32_t rings : { 64u, 256u, 512u })
+	{
+		std::vector<Asset::VertexPosition> positions;
+		std::vector<Asset::GenericVertexData> vertexData;
+		std::vector<Asset::VertexIndex> indices;
+		CreateBenchmarkSphere(rings, positions, vertexData, indices);
+
+		Asset::MeshletBuildSettings settings;
+		settings.UseCache = false;
+		settings.GenerateLods = false;
+		Asset::MeshletMeshData flatMesh;
+		const double flatTime = MeasureMilliseconds([&]() { flatMesh = Asset::GenerateMeshletMeshData(positions, vertexData, indices, settings); });
+
+		settings.GenerateLods = true;
+		Asset::MeshletMeshData lodMesh;
+		const double lodTime = MeasureMilliseconds([&]() { lodMesh = Asset::GenerateMeshletMeshData(positions, vertexData, indices, settings); });
+
+		settings.VertexFormat = Asset::VertexFormat::Quantized;
+		Asset::MeshletMeshData quantizedMesh;
+		const double quantizedTime = MeasureMilliseconds([&]() { quantizedMesh = Asset::GenerateMeshletMeshData(positions, vertexData, indices, settings); });
+
+		const size_t numTriangles = indices.size() / 3;
+		const size_t quantizedBytes = quantizedMesh.QuantizedPositions.size() * sizeof(Asset::QuantizedVertexPosition)
+			+ quantizedMesh.QuantizedVertexData.size() * sizeof(Asset::QuantizedVertexData);
+		printf("\t%zu tris: flat %.2f ms (%zu meshlets, %.2f M tris/s) | LODs %.2f ms (%zu meshlets) | LODs + quantized %.2f ms (%.2f MB vertex streams)\n",
+			numTriangles, flatTime, flatMesh.Meshlets.size(), numTriangles / std::max(flatTime, 0.001) / 1000.0,
+			lodTime, lodMesh.Meshlets.size(), quantizedTime, quantizedBytes / (1024.0 * 1024.0));
+	}
+}
+
+inline void RunHeadlessBenchmarks()
+{
+	BenchmarkMeshLoading();
+	BenchmarkMeshImportScaling();
+	BenchmarkSparseMappedVector();
+	BenchmarkStagingCopyBatching();
+	BenchmarkFrustumCulling();
+	BenchmarkJobSystemScaling();
+	BenchmarkMeshletLods();
+	BenchmarkVertexQuantization();
+	BenchmarkSparseSet();
+	BenchmarkECSEntities();
+	BenchmarkProxyUpdates();
+	BenchmarkMeshletBuild();
+}
@@ -1,6 +1,18 @@
 #pragma once
 #ifdef RUN_TESTS
+#include <random>
+#include <fstream>
+#include <unordered_set>
+#include <filesystem>
 #include "aZeroEngine/Engine.hpp"
+#include "renderer/StagingCopyBatcher.hpp"
+#include "misc/JobSystem.hpp"
+#include "pipeline/shader/ShaderCache.hpp"
+#include "assets/TextureCache.hpp"
+#include "assets/MeshletLod.hpp"
+#include "assets/VertexQuantization.hpp"
+#include "misc/Profiler.hpp"
+#include "misc/Hash.hpp"
 
 inline bool CreateRenderPasses(const aZero::Engine& engine)
 {
@@ -28,8 +40,724 @@ inline bool CreateRenderPasses(const aZero::Engine& engine)
 	return (vsCompRes && msCompRes && psCompRes && vsPassRes && msPassRes);
 }
 
-inline void RunTests(const aZero::Engine& engine)
+// Applies the recorded copies to CPU byte arrays so the batching can be validated without a device
+struct TestCopyRecorder : public aZero::Rendering::CopyRecorder<uint32_t>
+{
+	std::vector<std::vector<uint8_t>> Destinations;
+	std::vector<uint8_t> Staging;
+	uint32_t NumCopies = 0;
+
+	uint8_t* AllocateStaging(uint64_t numBytes) override
+	{
+		Staging.assign(numBytes, 0);
+		return Staging.data();
+	}
+
+	void RecordCopy(uint32_t dst, uint64_t dstOffset, uint64_t stagingOffset, uint64_t numBytes) override
+	{
+		memcpy(Destinations[dst].data() + dstOffset, Staging.data() + stagingOffset, numBytes);
+		NumCopies++;
+	}
+};
+
+inline bool TestStagingCopyBatcher()
+{
+	using namespace aZero;
+	const uint32_t numDestinations = 3;
+	const uint32_t destinationSize = 4096;
+
+	// Small chunks so that writes span several chunks and some need a dedicated one
+	Rendering::StagingCopyBatcher<uint32_t> batcher(256);
+	TestCopyRecorder recorder;
+	recorder.Destinations.assign(numDestinations, std::vector<uint8_t>(destinationSize, 0));
+	std::vector<std::vector<uint8_t>> expected = recorder.Destinations;
+
+	std::mt19937 random(1337);
+	for (uint32_t round = 0; round < 4; round++)
+	{
+		// Random, partly overlapping writes where the latest write has to win
+		for (uint32_t writeIndex = 0; writeIndex < 2000; writeIndex++)
+		{
+			const uint32_t dst = random() % numDestinations;
+			const uint32_t numBytes = writeIndex % 100 == 0 ? 1000 : 1 + random() % 64;
+			const uint32_t dstOffset = random() % (destinationSize - numBytes);
+
+			std::vector<uint8_t> data(numBytes);
+			for (uint8_t& byte : data)
+			{
+				byte = static_cast<uint8_t>(random());
+			}
+
+			batcher.Add(data.data(), dst, dstOffset, numBytes);
+			memcpy(expected[dst].data() + dstOffset, data.data(), numBytes);
+		}
+
+		batcher.Record(recorder);
+		if (recorder.Destinations != expected)
+		{
+			return false;
+		}
+		batcher.Reset();
+	}
+
+	// Back-to-back writes to the same destination collapse into a single copy
+	recorder.NumCopies = 0;
+	for (uint32_t element = 0; element < 100; element++)
+	{
+		const uint64_t value = element;
+		batcher.Add(&value, 1, element * sizeof(value), sizeof(value));
+	}
+	const auto stats = batcher.Record(recorder);
+
+	return stats.NumWrites == 100 && stats.NumCopies == 1 && recorder.NumCopies == 1 && batcher.GetNumQueued() == 0;
+}
+
+// Runs on a private job system so that it doesn't depend on the engine or the number of hardware threads
+inline bool TestJobSystem()
+{
+	using namespace aZero;
+	Jobs::JobSystem jobSystem(3);
+	bool passed = true;
+
+	// Every index is visited exactly once
+	std::vector<std::atomic<uint32_t>> visits(100000);
+	jobSystem.ParallelFor(static_cast<uint32_t>(visits.size()), 64, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t index = begin; index < end; index++)
+			{
+				visits[index]++;
+			}
+		});
+	passed &= std::all_of(visits.begin(), visits.end(), [](const std::atomic<uint32_t>& count) { return count.load() == 1; });
+
+	// Nested parallel loops wait by helping instead of blocking the workers
+	std::atomic<uint32_t> numNested = 0;
+	jobSystem.ParallelFor(64, 1, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t index = begin; index < end; index++)
+			{
+				jobSystem.ParallelFor(100, 1, [&](uint32_t nestedBegin, uint32_t nestedEnd) { numNested += nestedEnd - nestedBegin; });
+			}
+		});
+	passed &= numNested == 6400;
+
+	// Jobs scheduled after a counter only start once all jobs of the counter are done
+	Jobs::JobCounter first;
+	Jobs::JobCounter second;
+	std::atomic<uint32_t> numFirstDone = 0;
+	std::atomic<bool> startedEarly = false;
+	for (uint32_t jobIndex = 0; jobIndex < 100; jobIndex++)
+	{
+		jobSystem.Run([&]() { std::this_thread::sleep_for(std::chrono::microseconds(10)); numFirstDone++; }, &first);
+	}
+	for (uint32_t jobIndex = 0; jobIndex < 10; jobIndex++)
+	{
+		jobSystem.RunAfter(first, [&]() { startedEarly = startedEarly || numFirstDone != 100; }, &second);
+	}
+	jobSystem.Wait(second);
+	passed &= !startedEarly && numFirstDone == 100;
+
+	// More jobs than a deque holds, spawned from a worker
+	Jobs::JobCounter spawned;
+	std::atomic<uint32_t> numSpawned = 0;
+	jobSystem.Run([&]()
+		{
+			for (uint32_t jobIndex = 0; jobIndex < Jobs::JobSystem::DequeCapacity * 2; jobIndex++)
+			{
+				jobSystem.Run([&]() { numSpawned++; }, &spawned);
+			}
+		}, &spawned);
+	jobSystem.Wait(spawned);
+	passed &= numSpawned == Jobs::JobSystem::DequeCapacity * 2;
+
+	// Exceptions are rethrown by the waiting thread
+	Jobs::JobCounter throwing;
+	jobSystem.Run([]() { throw std::runtime_error("TestJobSystem"); }, &throwing);
+	bool caught = false;
+	try
+	{
+		jobSystem.Wait(throwing);
+	}
+	catch (const std::runtime_error&)
+	{
+		caught = true;
+	}
+	passed &= caught;
+
+	// Exceptions of jobs without a counter are kept by the job system instead of terminating
+	Jobs::JobCounter afterUnhandled;
+	jobSystem.Run([]() { throw std::runtime_error("TestJobSystem"); });
+	jobSystem.Run([]() {}, &afterUnhandled);
+	jobSystem.Wait(afterUnhandled);
+	std::exception_ptr unhandled;
+	for (uint32_t attempt = 0; attempt < 1000 && !unhandled; attempt++)
+	{
+		unhandled = jobSystem.TakeUnhandledException();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	passed &= unhandled != nullptr && jobSystem.TakeUnhandledException() == nullptr;
+
+	return passed;
+}
+
+// Produces bytecode from the source text so that cache hits can be validated without DXC or a device
+struct TestShaderCompiler : public aZero::Pipeline::ShaderCompilerBase
+{
+	std::string Identifier = "test-1";
+	std::atomic<uint32_t> NumCompilations = 0;
+
+	std::string GetIdentifier() const override { return Identifier; }
+
+	bool Compile(const aZero::Pipeline::ShaderCompileRequest& request, aZero::Pipeline::CompiledShader& output) override
+	{
+		NumCompilations++;
+		std::ifstream stream(request.Path);
+		if (!stream.is_open())
+		{
+			return false;
+		}
+
+		const std::string source((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+		if (source.find("error") != std::string::npos)
+		{
+			return false;
+		}
+
+		output.Bytecode.assign(source.begin(), source.end());
+		output.Reflection.Resources.push_back({ "Constants", D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS, 0, 0, 4 });
+		output.Reflection.Resources.push_back({ "Instances", D3D12_ROOT_PARAMETER_TYPE_SRV, 1, 0, 0 });
+		output.Reflection.OutputParameters.push_back({ "SV_TARGET", 0, 15 });
+		output.Reflection.ThreadGroupSize[0] = 32;
+		return true;
+	}
+};
+
+inline bool TestShaderCache()
 {
+	using namespace aZero;
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "aZeroShaderCacheTest";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory / "include");
+
+	const auto writeFile = [&](const std::string& name, const std::string& contents) { std::ofstream(directory / name, std::ios::trunc) << contents; };
+	writeFile("include/Common.hlsli", "#include \"Nested.hlsli\"\n");
+	writeFile("include/Nested.hlsli", "#define GROUP_SIZE 32\n");
+	writeFile("Test.cs.hlsl", "#include \"Common.hlsli\"\n[numthreads(GROUP_SIZE, 1, 1)] void main() {}\n");
+
+	TestShaderCompiler compiler;
+	Pipeline::ShaderCompileRequest request;
+	request.Path = (directory / "Test.cs.hlsl").string();
+	request.TargetProfile = "cs_6_6";
+	request.IncludeDirectories.push_back((directory / "include").string());
+
+	bool passed = true;
+	{
+		// Miss, then served from memory
+		Pipeline::ShaderCache cache(compiler, (directory / "cache").string());
+		std::shared_ptr<const Pipeline::CompiledShader> compiled = cache.Get(request);
+		passed &= compiled && compiler.NumCompilations == 1 && cache.Get(request) == compiled && cache.GetNumMemoryHits() == 1;
+	}
+
+	Pipeline::ShaderCache cache(compiler, (directory / "cache").string());
+	{
+		// Served from disk with the reflection intact
+		std::shared_ptr<const Pipeline::CompiledShader> compiled = cache.Get(request);
+		passed &= compiled && compiler.NumCompilations == 1 && cache.GetNumDiskHits() == 1;
+		passed &= compiled && compiled->Reflection.Resources.size() == 2 && compiled->Reflection.Resources[0].Name == "Constants"
+			&& compiled->Reflection.Resources[0].Num32BitConstants == 4 && compiled->Reflection.Resources[1].ShaderRegister == 1
+			&& compiled->Reflection.OutputParameters.size() == 1 && compiled->Reflection.OutputParameters[0].Mask == 15
+			&& compiled->Reflection.ThreadGroupSize[0] == 32;
+	}
+
+	// Every input of the key invalidates the entry
+	const uint64_t key = cache.ComputeKey(request);
+	writeFile("include/Nested.hlsli", "#define GROUP_SIZE 64\n");
+	passed &= cache.ComputeKey(request) != key;
+	writeFile("include/Nested.hlsli", "#define GROUP_SIZE 32\n");
+	passed &= cache.ComputeKey(request) == key;
+
+	Pipeline::ShaderCompileRequest otherRequest = request;
+	otherRequest.TargetProfile = "cs_6_5";
+	passed &= cache.ComputeKey(otherRequest) != key;
+	otherRequest = request;
+	otherRequest.Arguments.push_back("-DUSE_WAVE_OPS");
+	passed &= cache.ComputeKey(otherRequest) != key;
+	compiler.Identifier = "test-2";
+	passed &= cache.ComputeKey(request) != key;
+	compiler.Identifier = "test-1";
+
+	// Corrupt entries are recompiled
+	cache.ClearMemory();
+	std::filesystem::resize_file(cache.GetEntryPath(key), sizeof(Pipeline::ShaderCache::FileHeader) + 1);
+	passed &= cache.Get(request) != nullptr && compiler.NumCompilations == 2;
+
+	// Counts that the rest of the entry can't hold are rejected before anything is allocated from them
+	cache.ClearMemory();
+	{
+		const uint32_t numResources = std::numeric_limits<uint32_t>::max();
+		std::fstream entry(cache.GetEntryPath(key), std::ios::in | std::ios::out | std::ios::binary);
+		entry.seekp(offsetof(Pipeline::ShaderCache::FileHeader, NumResources));
+		entry.write(reinterpret_cast<const char*>(&numResources), sizeof(numResources));
+	}
+	passed &= cache.Get(request) != nullptr && compiler.NumCompilations == 3;
+
+	// Batched misses, duplicates are only compiled once and failures aren't cached
+	std::vector<Pipeline::ShaderCompileRequest> requests;
+	for (uint32_t shaderIndex = 0; shaderIndex < 8; shaderIndex++)
+	{
+		const std::string name = "Batch" + std::to_string(shaderIndex) + ".cs.hlsl";
+		writeFile(name, shaderIndex == 7 ? std::string("error") : "#include \"Common.hlsli\"\n// " + std::to_string(shaderIndex) + "\n");
+		requests.push_back(request);
+		requests.back().Path = (directory / name).string();
+	}
+	requests.push_back(requests.front());
+
+	const uint32_t numCompilationsBefore = compiler.NumCompilations;
+	std::vector<std::shared_ptr<const Pipeline::CompiledShader>> results = cache.Get(requests);
+	passed &= compiler.NumCompilations == numCompilationsBefore + 8;
+	passed &= std::all_of(results.begin(), results.begin() + 7, [](const auto& result) { return result != nullptr; }) && results[7] == nullptr && results[8] == results[0];
+	cache.Get(requests);
+	passed &= compiler.NumCompilations == numCompilationsBefore + 9;
+
+	std::filesystem::remove_all(directory);
+	return passed;
+}
+
+inline bool TestTextureCooking()
+{
+	using namespace aZero;
+	using namespace aZero::Asset::TextureProcessing;
+
+	// Smooth color and alpha gradients with a little noise, roughly what block compression sees in real textures
+	const uint32_t width = 64;
+	const uint32_t height = 32;
+	std::mt19937 rng(7);
+	std::uniform_int_distribution<int32_t> noise(-3, 3);
+	std::vector<uint8_t> texels(width * height * 4);
+	for (uint32_t y = 0; y < height; y++)
+	{
+		for (uint32_t x = 0; x < width; x++)
+		{
+			uint8_t* texel = &texels[(y * width + x) * 4];
+			texel[0] = static_cast<uint8_t>(std::clamp(static_cast<int32_t>(x * 4) + noise(rng), 0, 255));
+			texel[1] = static_cast<uint8_t>(std::clamp(static_cast<int32_t>(y * 8) + noise(rng), 0, 255));
+			texel[2] = static_cast<uint8_t>(std::clamp(128 + noise(rng), 0, 255));
+			texel[3] = static_cast<uint8_t>(255 - x * 2);
+		}
+	}
+
+	bool passed = true;
+
+	// A black and white checker averages to the middle of the linear range, which is 188 in sRGB and 128 in UNORM
+	uint8_t checker[4 * 4 * 4];
+	for (uint32_t texel = 0; texel < 16; texel++)
+	{
+		const uint8_t value = ((texel % 4) + (texel / 4)) % 2 ? 255 : 0;
+		checker[texel * 4] = checker[texel * 4 + 1] = checker[texel * 4 + 2] = checker[texel * 4 + 3] = value;
+	}
+	const std::vector<MipLevel> sRGBMips = GenerateMipChain(checker, 4, 4, MipFilter::Box, true);
+	const std::vector<MipLevel> linearMips = GenerateMipChain(checker, 4, 4, MipFilter::Box, false);
+	passed &= sRGBMips.size() == 2 && sRGBMips[0].Width == 2 && sRGBMips[1].Width == 1;
+	passed &= sRGBMips[0].Texels[0] == 188 && sRGBMips[0].Texels[3] == 128 && linearMips[0].Texels[0] == 128;
+
+	// Cooked layout, every mip down to 1x1 with whole blocks
+	Asset::TextureCookSettings settings;
+	settings.Format = DXGI_FORMAT_BC7_UNORM_SRGB;
+	std::optional<Asset::TextureData> cooked = Asset::CookTexture(texels.data(), width, height, 4, settings);
+	passed &= cooked.has_value() && cooked->Mips.size() == GetNumMipLevels(width, height) && cooked->Mips.size() == 7;
+	if (!cooked.has_value())
+	{
+		return false;
+	}
+
+	for (size_t mipIndex = 0; mipIndex < cooked->Mips.size(); mipIndex++)
+	{
+		const Asset::TextureMip& mip = cooked->Mips[mipIndex];
+		passed &= mip.Width == std::max(width >> mipIndex, 1u) && mip.Height == std::max(height >> mipIndex, 1u);
+		passed &= mip.Size == GetCompressedSize(mip.Width, mip.Height, BlockFormat::BC7) && mip.Offset + mip.Size <= cooked->TexelData.size();
+	}
+
+	// Compression quality of the top level
+	const std::pair<BlockFormat, uint32_t> formats[] = { { BlockFormat::BC1, 3 }, { BlockFormat::BC3, 4 }, { BlockFormat::BC5, 2 }, { BlockFormat::BC7, 4 } };
+	for (const auto& [format, numChannels] : formats)
+	{
+		std::vector<uint8_t> blocks(GetCompressedSize(width, height, format));
+		std::vector<uint8_t> decompressed(texels.size());
+		CompressImage(texels.data(), width, height, format, blocks.data());
+		DecompressImage(blocks.data(), width, height, format, decompressed.data());
+		passed &= ComputePSNR(texels.data(), decompressed.data(), width, height, numChannels) > 32.0;
+	}
+
+	// Sizes that aren't whole blocks fall back to uncompressed texels
+	std::optional<Asset::TextureData> fallback = Asset::CookTexture(texels.data(), 30, 30, 4, settings);
+	passed &= fallback.has_value() && fallback->Format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB && fallback->Mips[0].Size == 30 * 30 * 4;
+
+	// The cooked file maps back to identical texels and rejects other sources and settings
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "aZeroTextureCacheTest";
+	std::filesystem::remove_all(directory);
+	const std::string cachePath = (directory / "Test.aztex").string();
+	passed &= Asset::TextureCache::Save(cachePath, 1234, settings, cooked.value());
+	{
+		std::optional<Asset::TextureData> loaded = Asset::TextureCache::Load(cachePath, 1234, settings);
+		passed &= loaded.has_value() && loaded->CookedFile.IsOpen() && loaded->Mips.size() == cooked->Mips.size() && loaded->Format == cooked->Format;
+		for (size_t mipIndex = 0; loaded.has_value() && mipIndex < loaded->Mips.size(); mipIndex++)
+		{
+			const Asset::TextureMip& loadedMip = loaded->Mips[mipIndex];
+			const Asset::TextureMip& cookedMip = cooked->Mips[mipIndex];
+			passed &= loadedMip.Offset % Asset::TextureCache::SectionAlignment == 0 && loadedMip.Size == cookedMip.Size
+				&& memcmp(loaded->GetTexels() + loadedMip.Offset, cooked->GetTexels() + cookedMip.Offset, cookedMip.Size) == 0;
+		}
+	}
+
+	Asset::TextureCookSettings otherSettings = settings;
+	otherSettings.Filter = MipFilter::Box;
+	passed &= !Asset::TextureCache::Load(cachePath, 4321, settings).has_value() && !Asset::TextureCache::Load(cachePath, 1234, otherSettings).has_value();
+	std::filesystem::resize_file(cachePath, std::filesystem::file_size(cachePath) - 1);
+	passed &= !Asset::TextureCache::Load(cachePath, 1234, settings).has_value();
 
+	std::filesystem::remove_all(directory);
+	return passed;
+}
+
+inline bool TestMeshletLods()
+{
+	using namespace aZero;
+
+	// Closed UV sphere with welded seam and poles so the simplification isn't limited by open borders
+	const uint32_t rings = 96;
+	const uint32_t segments = 192;
+	std::vector<Asset::VertexPosition> positions;
+	std::vector<Asset::GenericVertexData> vertexData;
+	std::vector<Asset::VertexIndex> indices;
+	positions.emplace_back(0.f, 1.f, 0.f);
+	for (uint32_t ring = 1; ring < rings; ring++)
+	{
+		const float theta = DirectX::XM_PI * ring / rings;
+		for (uint32_t segment = 0; segment < segments; segment++)
+		{
+			const float phi = DirectX::XM_2PI * segment / segments;
+			positions.emplace_back(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+		}
+	}
+	positions.emplace_back(0.f, -1.f, 0.f);
+
+	const auto ringVertex = [segments](uint32_t ring, uint32_t segment) { return 1 + (ring - 1) * segments + segment % segments; };
+	const uint32_t bottomPole = static_cast<uint32_t>(positions.size()) - 1;
+	for (uint32_t segment = 0; segment < segments; segment++)
+	{
+		indices.insert(indices.end(), { 0, ringVertex(1, segment + 1), ringVertex(1, segment) });
+		indices.insert(indices.end(), { bottomPole, ringVertex(rings - 1, segment), ringVertex(rings - 1, segment + 1) });
+		for (uint32_t ring = 1; ring < rings - 1; ring++)
+		{
+			indices.insert(indices.end(), { ringVertex(ring, segment), ringVertex(ring, segment + 1), ringVertex(ring + 1, segment) });
+			indices.insert(indices.end(), { ringVertex(ring, segment + 1), ringVertex(ring + 1, segment + 1), ringVertex(ring + 1, segment) });
+		}
+	}
+
+	for (const Asset::VertexPosition& position : positions)
+	{
+		vertexData.push_back({ DXM::Vector2(), position, DXM::Vector3(1.f, 0.f, 0.f) });
+	}
+
+	Asset::MeshletBuildSettings settings;
+	settings.UseCache = false;
+	const Asset::MeshletMeshData mesh = Asset::GenerateMeshletMeshData(positions, vertexData, indices, settings);
+
+	bool passed = !mesh.MeshletGroups.empty();
+	if (!passed)
+	{
+		return false;
+	}
+
+	uint32_t numLevels = 0;
+	for (const Asset::MeshletGroup& group : mesh.MeshletGroups)
+	{
+		numLevels = std::max(numLevels, group.Level);
+		for (uint32_t child = group.FirstChild; child < group.FirstChild + group.NumChildren; child++)
+		{
+			// The group bounds contain the ones of its children, otherwise the selection could pick overlapping levels
+			const Asset::MeshletLodBounds& childLod = mesh.Meshlets[mesh.MeshletGroupChildren[child]].Lod;
+			passed &= group.Lod.Error >= childLod.Error;
+			passed &= (group.Lod.Center - childLod.Center).Length() + childLod.Radius <= group.Lod.Radius * 1.0001f + 1e-5f;
+		}
+	}
+	passed &= numLevels >= 3;
+
+	const auto countTriangles = [&mesh](const std::vector<uint32_t>& meshlets)
+		{
+			uint32_t numTriangles = 0;
+			for (const uint32_t meshlet : meshlets)
+			{
+				numTriangles += mesh.Meshlets[meshlet].PrimitivesCount;
+			}
+			return numTriangles;
+		};
+
+	const auto computeArea = [&mesh](const std::vector<uint32_t>& meshlets)
+		{
+			float area = 0.f;
+			for (const uint32_t meshletIndex : meshlets)
+			{
+				const Asset::Meshlet& meshlet = mesh.Meshlets[meshletIndex];
+				for (uint32_t primitive = 0; primitive < meshlet.PrimitivesCount; primitive++)
+				{
+					const uint32_t packed = mesh.MeshletPrimitives[meshlet.PrimitiveOffset + primitive];
+					const DXM::Vector3& a = mesh.Positions[mesh.MeshletIndices[meshlet.VertexOffset + (packed & 0xFF)]];
+					const DXM::Vector3& b = mesh.Positions[mesh.MeshletIndices[meshlet.VertexOffset + ((packed >> 8) & 0xFF)]];
+					const DXM::Vector3& c = mesh.Positions[mesh.MeshletIndices[meshlet.VertexOffset + ((packed >> 16) & 0xFF)]];
+					area += (b - a).Cross(c - a).Length() * 0.5f;
+				}
+			}
+			return area;
+		};
+
+	// A zero threshold only accepts the full detail meshlets
+	Asset::MeshletLodView view;
+	view.ProjectionScale = 1080.f / (2.f * std::tan(DirectX::XM_PIDIV4 * 0.5f));
+	view.ErrorThreshold = 0.f;
+	std::vector<uint32_t> selected;
+	Asset::SelectMeshletLods(mesh, view, selected);
+	const uint32_t numFullDetailTriangles = static_cast<uint32_t>(indices.size() / 3);
+	passed &= countTriangles(selected) == numFullDetailTriangles;
+	const float fullDetailArea = computeArea(selected);
+
+	// The cut only gets coarser with distance, and while the sphere covers most of the screen the surface barely changes
+	view.ErrorThreshold = 1.f;
+	uint32_t previousTriangles = numFullDetailTriangles;
+	for (const float distance : { 2.f, 4.f, 8.f, 32.f, 128.f, 512.f })
+	{
+		view.Position = DXM::Vector3(0.f, 0.f, -distance);
+		selected.clear();
+		Asset::SelectMeshletLods(mesh, view, selected);
+		const uint32_t numTriangles = countTriangles(selected);
+		passed &= numTriangles <= previousTriangles;
+		if (distance <= 8.f)
+		{
+			passed &= std::abs(computeArea(selected) - fullDetailArea) < fullDetailArea * 0.02f;
+		}
+		previousTriangles = numTriangles;
+	}
+
+	// Far enough away only the roots are left
+	view.Position = DXM::Vector3(0.f, 0.f, -1e6f);
+	selected.clear();
+	Asset::SelectMeshletLods(mesh, view, selected);
+	for (const uint32_t meshlet : selected)
+	{
+		passed &= mesh.Meshlets[meshlet].ParentGroup == Asset::InvalidMeshletGroup;
+	}
+	passed &= countTriangles(selected) < numFullDetailTriangles / 2;
+
+	return passed;
+}
+
+inline bool TestVertexQuantization()
+{
+	using namespace aZero;
+	using namespace aZero::Asset::VertexQuantization;
+
+	bool passed = true;
+
+	// Half floats keep 11 significant bits
+	for (const float value : { 0.f, 1.f, -2.5f, 0.3333f, 1000.25f, 65504.f, -0.0078125f })
+	{
+		passed &= std::abs(DecodeHalf(EncodeHalf(value)) - value) <= std::abs(value) / 2048.f;
+	}
+	passed &= EncodeHalf(1.f) == 0x3C00 && EncodeHalf(-2.f) == 0xC000 && EncodeHalf(1e6f) == 0x7C00;
+
+	// Octahedral directions, including the axes and the folded lower hemisphere
+	std::mt19937 rng(11);
+	std::uniform_real_distribution<float> unit(-1.f, 1.f);
+	std::vector<DXM::Vector3> directions = { { 1.f, 0.f, 0.f }, { -1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 0.f, -1.f, 0.f }, { 0.f, 0.f, 1.f }, { 0.f, 0.f, -1.f } };
+	for (uint32_t i = 0; i < 10000; i++)
+	{
+		directions.emplace_back(unit(rng), unit(rng), unit(rng));
+	}
+
+	float maxAngle = 0.f;
+	for (const DXM::Vector3& direction : directions)
+	{
+		const DXM::Vector3 decoded = DecodeOctahedral(EncodeOctahedral(direction));
+		maxAngle = std::max(maxAngle, std::atan2(decoded.Cross(direction).Length(), decoded.Dot(direction)) * 180.f / DirectX::XM_PI);
+	}
+	passed &= maxAngle < 0.01f;
+
+	// Positions are within half a step of the bounds radius per axis
+	std::vector<Asset::VertexPosition> positions;
+	std::vector<Asset::GenericVertexData> vertexData;
+	std::vector<Asset::VertexIndex> indices;
+	const uint32_t gridSize = 64;
+	for (uint32_t y = 0; y <= gridSize; y++)
+	{
+		for (uint32_t x = 0; x <= gridSize; x++)
+		{
+			const float u = static_cast<float>(x) / gridSize;
+			const float v = static_cast<float>(y) / gridSize;
+			positions.emplace_back(u * 20.f - 5.f, std::sin(u * 6.f) * std::cos(v * 4.f), v * 10.f + 100.f);
+			vertexData.push_back({ DXM::Vector2(u * 4.f, v * 4.f), DXM::Vector3(unit(rng), unit(rng), 1.f), DXM::Vector3(1.f, unit(rng), unit(rng)) });
+			if (x < gridSize && y < gridSize)
+			{
+				const uint32_t corner = y * (gridSize + 1) + x;
+				indices.insert(indices.end(), { corner, corner + 1, corner + gridSize + 1, corner + 1, corner + gridSize + 2, corner + gridSize + 1 });
+			}
+		}
+	}
+
+	Asset::MeshletMeshData mesh;
+	mesh.Positions = positions;
+	mesh.GenericVertexData = vertexData;
+	mesh.Bounds = DirectX::BoundingSphere(DXM::Vector3(5.f, 0.f, 105.f), 1.f);
+	const QuantizationStats stats = QuantizeVertices(mesh);
+
+	// The too small radius is grown to the largest axis offset
+	passed &= mesh.VertexFormat == Asset::VertexFormat::Quantized && mesh.Positions.empty() && mesh.Bounds.Radius == 10.f;
+	passed &= stats.MaxPositionError <= mesh.Bounds.Radius / 32767.f && stats.MaxNormalError < 0.01f && stats.MaxTangentError < 0.01f && stats.MaxUVError <= 4.f / 2048.f;
+	passed &= stats.FloatBytes == positions.size() * 44 && stats.QuantizedBytes == positions.size() * 20;
+
+	std::vector<Asset::VertexPosition> decodedPositions;
+	std::vector<Asset::GenericVertexData> decodedVertexData;
+	DecodeVertices(mesh, decodedPositions, decodedVertexData);
+	passed &= decodedPositions.size() == positions.size() && decodedVertexData.size() == vertexData.size();
+	for (size_t vertex = 0; vertex < decodedPositions.size(); vertex++)
+	{
+		passed &= (decodedPositions[vertex] - positions[vertex]).Length() <= stats.MaxPositionError;
+	}
+
+	// Quantization selected in the build settings
+	Asset::MeshletBuildSettings settings;
+	settings.UseCache = false;
+	settings.GenerateLods = false;
+	settings.VertexFormat = Asset::VertexFormat::Quantized;
+	const Asset::MeshletMeshData built = Asset::GenerateMeshletMeshData(positions, vertexData, indices, settings);
+	passed &= built.VertexFormat == Asset::VertexFormat::Quantized && built.Positions.empty() && built.GenericVertexData.empty();
+	passed &= built.QuantizedPositions.size() == positions.size() && built.QuantizedVertexData.size() == positions.size();
+
+	return passed;
+}
+
+// The content hash keys the mesh, texture and shader caches, so a collision serves a stale cooked asset
+inline bool TestHash()
+{
+	using namespace aZero;
+	bool passed = true;
+
+	// Flipping the top bit of two words cancels out for a plain (hash ^ word) * prime
+	uint8_t zero[16]{};
+	uint8_t flipped[16]{};
+	flipped[7] ^= 0x80;
+	flipped[15] ^= 0x80;
+	passed &= Helper::HashBytes(zero, sizeof(zero)) != Helper::HashBytes(flipped, sizeof(flipped));
+
+	// Every single and double bit flip of a small buffer gives a unique hash
+	uint8_t buffer[16]{};
+	std::unordered_set<uint64_t> hashes = { Helper::HashBytes(buffer, sizeof(buffer)) };
+	size_t numHashed = 1;
+	for (uint32_t first = 0; first < sizeof(buffer) * 8; first++)
+	{
+		buffer[first / 8] ^= 1 << (first % 8);
+		hashes.insert(Helper::HashBytes(buffer, sizeof(buffer)));
+		numHashed++;
+		for (uint32_t second = first + 1; second < sizeof(buffer) * 8; second++)
+		{
+			buffer[second / 8] ^= 1 << (second % 8);
+			hashes.insert(Helper::HashBytes(buffer, sizeof(buffer)));
+			numHashed++;
+			buffer[second / 8] ^= 1 << (second % 8);
+		}
+		buffer[first / 8] ^= 1 << (first % 8);
+	}
+	passed &= hashes.size() == numHashed;
+
+	// Trailing zero bytes change the hash
+	passed &= Helper::HashBytes(zero, 3) != Helper::HashBytes(zero, 4);
+
+	return passed;
+}
+
+// Uses a private profiler so that it doesn't depend on USE_PROFILER or the markers of the engine
+inline bool TestProfiler()
+{
+	using namespace aZero;
+	Profiling::Profiler profiler;
+	bool passed = true;
+
+	profiler.BeginCapture();
+	passed &= profiler.IsCapturing();
+
+	// Nested markers record the number of markers that were open when they started
+	const uint64_t outerStart = profiler.BeginMarker();
+	const uint64_t innerStart = profiler.BeginMarker();
+	profiler.EndMarker("Inner", innerStart);
+	profiler.EndMarker("Outer", outerStart);
+
+	const std::vector<Profiling::ProfileEvent> events = profiler.GetThreadEvents();
+	passed &= events.size() == 2;
+	if (!passed)
+	{
+		return false;
+	}
+	passed &= std::string(events[0].Name) == "Inner" && events[0].Depth == 1;
+	passed &= std::string(events[1].Name) == "Outer" && events[1].Depth == 0;
+	passed &= events[1].StartNs <= events[0].StartNs && events[0].EndNs <= events[1].EndNs;
+
+	// Other threads record into their own buffer
+	std::thread worker([&profiler]()
+		{
+			profiler.SetThreadName("Profiler test worker");
+			profiler.EndMarker("Worker", profiler.BeginMarker());
+			profiler.AddCounter(Profiling::Counter::ProxyUpdates, 3);
+		});
+	worker.join();
+	passed &= profiler.GetThreadEvents().size() == 2;
+
+	// Counters are summed over the frame and reset when it ends
+	profiler.BeginFrame();
+	profiler.AddCounter(Profiling::Counter::ProxyUpdates, 2);
+	profiler.AddCounter(Profiling::Counter::StagedBytes, 1024);
+	const Profiling::FrameStats first = profiler.EndFrame();
+	passed &= first.FrameIndex == 0 && first.Get(Profiling::Counter::ProxyUpdates) == 5 && first.Get(Profiling::Counter::StagedBytes) == 1024;
+	passed &= first.EndNs >= first.StartNs && profiler.GetCounter(Profiling::Counter::ProxyUpdates) == 0;
+
+	const Profiling::FrameStats second = profiler.EndFrame();
+	passed &= second.FrameIndex == 1 && second.StartNs == first.EndNs && second.Get(Profiling::Counter::ProxyUpdates) == 0;
+	profiler.EndCapture();
+
+	// The history is a ring of the latest frames, oldest first
+	for (size_t frame = 0; frame < Profiling::Profiler::FrameHistorySize; frame++)
+	{
+		profiler.EndFrame();
+	}
+	const std::vector<Profiling::FrameStats> history = profiler.GetFrameHistory();
+	passed &= history.size() == Profiling::Profiler::FrameHistorySize;
+	passed &= !history.empty() && history.front().FrameIndex == 2 && history.back().FrameIndex == Profiling::Profiler::FrameHistorySize + 1;
+
+	// Only the frames of the capture are exported
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "aZeroProfilerTest.json";
+	passed &= profiler.ExportChromeTrace(path.string());
+
+	std::ifstream stream(path);
+	const std::string trace((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+	stream.close();
+	std::filesystem::remove(path);
+
+	passed &= trace.find("\"traceEvents\"") != std::string::npos;
+	passed &= trace.find("\"Outer\"") != std::string::npos && trace.find("\"Worker\"") != std::string::npos;
+	passed &= trace.find("Profiler test worker") != std::string::npos && trace.find("\"ProxyUpdates\"") != std::string::npos;
+	passed &= trace.find("\"Frame 1\"") != std::string::npos && trace.find("\"Frame 2\"") == std::string::npos;
+	passed &= profiler.GetNumDroppedEvents() == 0;
+
+	return passed;
+}
+
+inline void RunTests(const aZero::Engine& engine)
+{
+	printf("StagingCopyBatcher: %s\n", TestStagingCopyBatcher() ? "passed" : "FAILED");
+	printf("JobSystem: %s\n", TestJobSystem() ? "passed" : "FAILED");
+	printf("ShaderCache: %s\n", TestShaderCache() ? "passed" : "FAILED");
+	printf("TextureCooking: %s\n", TestTextureCooking() ? "passed" : "FAILED");
+	printf("MeshletLods: %s\n", TestMeshletLods() ? "passed" : "FAILED");
+	printf("VertexQuantization: %s\n", TestVertexQuantization() ? "passed" : "FAILED");
+	printf("Profiler: %s\n", TestProfiler() ? "passed" : "FAILED");
+	printf("Hash: %s\n", TestHash() ? "passed" : "FAILED");
 }
 #endif
\ No newline at end of file
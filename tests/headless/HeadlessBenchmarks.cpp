@@ -0,0 +1,45 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "tests/HeadlessBenchmarks.hpp"
+
+// Usage: aZeroHeadlessBenchmarks [--trace <path>]
+// --trace writes the profiler markers and frame counters of the whole run as Chrome trace JSON
+int main(int argc, char* argv[])
+{
+	using namespace aZero;
+	std::string tracePath;
+	for (int argument = 1; argument < argc; argument++)
+	{
+		if (std::strcmp(argv[argument], "--trace") == 0 && argument + 1 < argc)
+		{
+			tracePath = argv[++argument];
+		}
+		else
+		{
+			printf("Unknown argument: %s\nUsage: %s [--trace <path>]\n", argv[argument], argv[0]);
+			return 1;
+		}
+	}
+
+	Profiling::Profiler& profiler = Profiling::GetProfiler();
+	if (!tracePath.empty())
+	{
+		profiler.BeginCapture();
+	}
+
+	RunHeadlessBenchmarks();
+
+	if (!tracePath.empty())
+	{
+		profiler.EndCapture();
+		if (!profiler.ExportChromeTrace(tracePath))
+		{
+			printf("Failed to write the trace to %s\n", tracePath.c_str());
+			return 1;
+		}
+		printf("Wrote the trace to %s (%llu markers dropped)\n", tracePath.c_str(), static_cast<unsigned long long>(profiler.GetNumDroppedEvents()));
+	}
+
+	return 0;
+}
@@ -0,0 +1,243 @@
+#pragma once
+// Minimal stand-in for the SAL annotation header that DirectXMath and SimpleMath include outside of MSVC.
+// The annotations only matter to the MSVC code analysis, so every one of them expands to nothing.
+#ifndef _In_
+#define _In_
+#endif
+#ifndef _In_opt_
+#define _In_opt_
+#endif
+#ifndef _In_z_
+#define _In_z_
+#endif
+#ifndef _In_opt_z_
+#define _In_opt_z_
+#endif
+#ifndef _Out_
+#define _Out_
+#endif
+#ifndef _Out_opt_
+#define _Out_opt_
+#endif
+#ifndef _Inout_
+#define _Inout_
+#endif
+#ifndef _Inout_opt_
+#define _Inout_opt_
+#endif
+#ifndef _Inout_z_
+#define _Inout_z_
+#endif
+#ifndef _Outptr_
+#define _Outptr_
+#endif
+#ifndef _Outptr_opt_
+#define _Outptr_opt_
+#endif
+#ifndef _Outptr_result_maybenull_
+#define _Outptr_result_maybenull_
+#endif
+#ifndef _COM_Outptr_
+#define _COM_Outptr_
+#endif
+#ifndef _COM_Outptr_opt_
+#define _COM_Outptr_opt_
+#endif
+#ifndef _Ret_
+#define _Ret_
+#endif
+#ifndef _Ret_z_
+#define _Ret_z_
+#endif
+#ifndef _Ret_maybenull_
+#define _Ret_maybenull_
+#endif
+#ifndef _Ret_notnull_
+#define _Ret_notnull_
+#endif
+#ifndef _Check_return_
+#define _Check_return_
+#endif
+#ifndef _Must_inspect_result_
+#define _Must_inspect_result_
+#endif
+#ifndef _Use_decl_annotations_
+#define _Use_decl_annotations_
+#endif
+#ifndef _Printf_format_string_
+#define _Printf_format_string_
+#endif
+#ifndef _Null_terminated_
+#define _Null_terminated_
+#endif
+#ifndef _Notnull_
+#define _Notnull_
+#endif
+#ifndef _Maybenull_
+#define _Maybenull_
+#endif
+#ifndef _Pre_
+#define _Pre_
+#endif
+#ifndef _Post_
+#define _Post_
+#endif
+#ifndef _Pre_notnull_
+#define _Pre_notnull_
+#endif
+#ifndef _Pre_maybenull_
+#define _Pre_maybenull_
+#endif
+#ifndef _Post_invalid_
+#define _Post_invalid_
+#endif
+#ifndef _Post_z_
+#define _Post_z_
+#endif
+#ifndef _Frees_ptr_
+#define _Frees_ptr_
+#endif
+#ifndef _Frees_ptr_opt_
+#define _Frees_ptr_opt_
+#endif
+#ifndef _Reserved_
+#define _Reserved_
+#endif
+#ifndef _In_reads_
+#define _In_reads_(...)
+#endif
+#ifndef _In_reads_opt_
+#define _In_reads_opt_(...)
+#endif
+#ifndef _In_reads_bytes_
+#define _In_reads_bytes_(...)
+#endif
+#ifndef _In_reads_bytes_opt_
+#define _In_reads_bytes_opt_(...)
+#endif
+#ifndef _In_reads_z_
+#define _In_reads_z_(...)
+#endif
+#ifndef _Out_writes_
+#define _Out_writes_(...)
+#endif
+#ifndef _Out_writes_opt_
+#define _Out_writes_opt_(...)
+#endif
+#ifndef _Out_writes_bytes_
+#define _Out_writes_bytes_(...)
+#endif
+#ifndef _Out_writes_bytes_opt_
+#define _Out_writes_bytes_opt_(...)
+#endif
+#ifndef _Out_writes_all_
+#define _Out_writes_all_(...)
+#endif
+#ifndef _Out_writes_bytes_all_
+#define _Out_writes_bytes_all_(...)
+#endif
+#ifndef _Out_writes_z_
+#define _Out_writes_z_(...)
+#endif
+#ifndef _Inout_updates_
+#define _Inout_updates_(...)
+#endif
+#ifndef _Inout_updates_opt_
+#define _Inout_updates_opt_(...)
+#endif
+#ifndef _Inout_updates_bytes_
+#define _Inout_updates_bytes_(...)
+#endif
+#ifndef _Inout_updates_bytes_opt_
+#define _Inout_updates_bytes_opt_(...)
+#endif
+#ifndef _Inout_updates_all_
+#define _Inout_updates_all_(...)
+#endif
+#ifndef _Inout_updates_z_
+#define _Inout_updates_z_(...)
+#endif
+#ifndef _Ret_writes_
+#define _Ret_writes_(...)
+#endif
+#ifndef _Ret_writes_bytes_
+#define _Ret_writes_bytes_(...)
+#endif
+#ifndef _Ret_writes_maybenull_
+#define _Ret_writes_maybenull_(...)
+#endif
+#ifndef _Field_size_
+#define _Field_size_(...)
+#endif
+#ifndef _Field_size_opt_
+#define _Field_size_opt_(...)
+#endif
+#ifndef _Field_size_bytes_
+#define _Field_size_bytes_(...)
+#endif
+#ifndef _Field_size_bytes_opt_
+#define _Field_size_bytes_opt_(...)
+#endif
+#ifndef _Field_size_full_
+#define _Field_size_full_(...)
+#endif
+#ifndef _Success_
+#define _Success_(...)
+#endif
+#ifndef _Return_type_success_
+#define _Return_type_success_(...)
+#endif
+#ifndef _When_
+#define _When_(...)
+#endif
+#ifndef _Analysis_assume_
+#define _Analysis_assume_(...)
+#endif
+#ifndef _In_range_
+#define _In_range_(...)
+#endif
+#ifndef _Out_range_
+#define _Out_range_(...)
+#endif
+#ifndef _Ret_range_
+#define _Ret_range_(...)
+#endif
+#ifndef _Deref_out_range_
+#define _Deref_out_range_(...)
+#endif
+#ifndef _Pre_satisfies_
+#define _Pre_satisfies_(...)
+#endif
+#ifndef _Post_satisfies_
+#define _Post_satisfies_(...)
+#endif
+#ifndef _Outptr_result_buffer_
+#define _Outptr_result_buffer_(...)
+#endif
+#ifndef _Outptr_result_bytebuffer_
+#define _Outptr_result_bytebuffer_(...)
+#endif
+#ifndef _Out_writes_to_
+#define _Out_writes_to_(...)
+#endif
+#ifndef _Out_writes_bytes_to_
+#define _Out_writes_bytes_to_(...)
+#endif
+#ifndef _Out_writes_to_opt_
+#define _Out_writes_to_opt_(...)
+#endif
+#ifndef _Out_writes_bytes_to_opt_
+#define _Out_writes_bytes_to_opt_(...)
+#endif
+#ifndef _Inout_updates_to_
+#define _Inout_updates_to_(...)
+#endif
+#ifndef _Inout_updates_bytes_to_
+#define _Inout_updates_bytes_to_(...)
+#endif
+#ifndef _Field_size_part_
+#define _Field_size_part_(...)
+#endif
+#ifndef _Field_size_bytes_part_
+#define _Field_size_bytes_part_(...)
+#endif